@@ -137,4 +137,24 @@ Item
             canvas.setValue(path, slot, value);
         }
     }
+
+    // Apply a list of operations (e.g., { op: 'setValue', path: 'root', slot: 'angle', value: 1.0 })
+    // under a single lock, returns the result of each operation
+    function batch(operations)
+    {
+        var results = canvas ? canvas.batch(operations) : null;
+
+        if (results) return results;
+        else         return [];
+    }
+
+    function saveSnapshot(filename)
+    {
+        return canvas ? canvas.saveSnapshot(filename) : false;
+    }
+
+    function loadSnapshot(filename)
+    {
+        return canvas ? canvas.loadSnapshot(filename) : false;
+    }
 }
@@ -35,7 +35,7 @@ void GlyphSequenceDemoStage::onProcess()
 
     if (numChars.value() == 0)
     {
-        m_sequences.front().setString(cppassist::string::encode(string.value(), cppassist::Encoding::UTF8));
+        m_sequences.front().setString(cppassist::string::encode(string.valueRef(), cppassist::Encoding::UTF8));
     }
     else
     {
@@ -2,6 +2,8 @@
 #pragma once
 
 
+#include <chrono>
+
 #include <gloperate-glfw/gloperate-glfw_api.h>
 
 
@@ -22,9 +24,41 @@ namespace gloperate_glfw
 *    The Application class is a singleton that has to be instanciated exactly
 *    once in an application. It controls the main message loop for all windows
 *    (instances of gloperate_glfw::Window).
+*
+*    The main loop sleeps until events arrive, a window requests a repaint,
+*    or the next scripting timer elapses. While windows are rendered
+*    continuously with vertical sync, frame pacing delays the start of each
+*    frame until shortly before the next vertical sync, using a prediction
+*    of the render time, to reduce the latency of input events.
 */
 class GLOPERATE_GLFW_API Application
 {
+public:
+    /**
+    *  @brief
+    *    Main loop statistics
+    */
+    struct Statistics
+    {
+        unsigned int iterations;     ///< Number of main loop iterations
+        unsigned int idleWakeups;    ///< Number of iterations without any events to process
+        unsigned int frames;         ///< Number of iterations in which at least one frame has been presented
+        unsigned int missedFrames;   ///< Number of paced frames that have missed the vertical sync
+        float        averageLatency; ///< Average time from waking up the main loop until a frame has been presented (in seconds)
+        float        maxLatency;     ///< Maximum time from waking up the main loop until a frame has been presented (in seconds)
+
+        Statistics()
+        : iterations(0)
+        , idleWakeups(0)
+        , frames(0)
+        , missedFrames(0)
+        , averageLatency(0.0f)
+        , maxLatency(0.0f)
+        {
+        }
+    };
+
+
 public:
     /**
     *  @brief
@@ -116,23 +150,115 @@ public:
     */
     int exitCode();
 
+    /**
+    *  @brief
+    *    Check if frame pacing is enabled
+    *
+    *  @return
+    *    'true' if frame pacing is enabled, else 'false'
+    */
+    bool framePacing() const;
+
+    /**
+    *  @brief
+    *    Enable or disable frame pacing
+    *
+    *  @param[in] framePacing
+    *    'true' to start frames shortly before the vertical sync, 'false' to start them right after the previous one
+    *
+    *  @remarks
+    *    Frame pacing is enabled by default. It only takes effect while
+    *    frames are rendered continuously and synchronized to the display.
+    */
+    void setFramePacing(bool framePacing);
+
+    /**
+    *  @brief
+    *    Get predicted time to render a frame
+    *
+    *  @return
+    *    Predicted render time (in seconds)
+    */
+    float predictedFrameTime() const;
+
+    /**
+    *  @brief
+    *    Get main loop statistics
+    *
+    *  @return
+    *    Statistics since the start of the application or the last call to resetStatistics()
+    */
+    const Statistics & statistics() const;
+
+    /**
+    *  @brief
+    *    Reset main loop statistics
+    */
+    void resetStatistics();
+
+
+protected:
+    using clock = std::chrono::steady_clock;
+
 
 protected:
+    /**
+    *  @brief
+    *    Wait until events have to be processed
+    *
+    *  @remarks
+    *    Returns immediately if repaints or events are pending. While frames are
+    *    presented continuously, waits until the predicted start of the next
+    *    frame. Otherwise, blocks until events arrive or the next scripting timer
+    *    elapses.
+    */
+    void waitEvents();
+
     /**
     *  @brief
     *    Process events that have been received
     */
     void processEvents();
 
+    /**
+    *  @brief
+    *    Get time at which the next frame should be started
+    *
+    *  @return
+    *    Start time of the next frame, not later than now if frames are not paced
+    */
+    clock::time_point nextFrameStart() const;
+
+    /**
+    *  @brief
+    *    Update frame time prediction and statistics after a frame has been presented
+    *
+    *  @param[in] renderTime
+    *    Time spent rendering the frame (in seconds)
+    *  @param[in] presentTime
+    *    Time at which the frame has been presented
+    */
+    void updateFrameTiming(float renderTime, clock::time_point presentTime);
+
 
 protected:
     static Application * s_app; ///< Pointer to the current application instance, can be nullptr
 
 
 protected:
-    gloperate::Environment * m_environment; ///< Gloperate environment
-    bool                     m_running;     ///< 'true' if application is currently running, else 'false'
-    int                      m_exitCode;    ///< Exit code (0 for no error, > 0 for error)
+    gloperate::Environment * m_environment;     ///< Gloperate environment
+    bool                     m_running;         ///< 'true' if application is currently running, else 'false'
+    int                      m_exitCode;        ///< Exit code (0 for no error, > 0 for error)
+    bool                     m_framePacing;     ///< 'true' if frame pacing is enabled, else 'false'
+    Statistics               m_statistics;      ///< Main loop statistics
+    float                    m_refreshInterval; ///< Refresh interval of the display (in seconds)
+    float                    m_frameTime;       ///< Predicted render time (in seconds)
+    float                    m_frameMargin;     ///< Safety margin between the predicted end of a frame and the vertical sync (in seconds)
+    bool                     m_presented;       ///< 'true' if a frame has been presented in the last iteration, else 'false'
+    bool                     m_synchronized;    ///< 'true' if presenting frames has been synchronized to the display, else 'false'
+    bool                     m_paced;           ///< 'true' if the current frame has been delayed by frame pacing, else 'false'
+    clock::time_point        m_wakeTime;        ///< Time at which the main loop has woken up in the current iteration
+    clock::time_point        m_lastPresent;     ///< Time at which the last frame has been presented
 };
 
 
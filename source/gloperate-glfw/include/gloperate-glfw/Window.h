@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <queue>
 #include <set>
@@ -430,6 +431,8 @@ protected:
     bool                                     m_quitOnDestroy;    ///< Quit application when window is closed?
     bool                                     m_needsRepaint;     ///< Has a repaint be scheduled?
     std::unique_ptr<GLContext>               m_context;          ///< OpenGL context (can be nullptr)
+    std::chrono::duration<float>             m_renderTime;       ///< Time spent in onPaint() for the last frame
+    std::chrono::steady_clock::time_point    m_presentTime;      ///< Time at which the last frame has been swapped to the screen
 };
 
 
@@ -1,9 +1,8 @@
 
 #include <gloperate-glfw/Application.h>
 
+#include <algorithm>
 #include <cassert>
-#include <chrono>
-#include <thread>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -14,6 +13,23 @@
 #include <gloperate-glfw/Window.h>
 
 
+namespace
+{
+
+
+const float s_defaultRefreshInterval = 1.0f / 60.0f; ///< Used if the refresh rate of the display is unknown
+const float s_minFrameMargin         = 0.002f;       ///< Minimum time between the predicted end of a frame and the vertical sync (in seconds)
+
+
+float seconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
+}
+
+
+} // namespace
+
+
 namespace gloperate_glfw
 {
 
@@ -44,6 +60,13 @@ Application::Application(gloperate::Environment * environment, int &, char **)
 : m_environment(environment)
 , m_running(false)
 , m_exitCode(0)
+, m_framePacing(true)
+, m_refreshInterval(s_defaultRefreshInterval)
+, m_frameTime(0.0f)
+, m_frameMargin(s_defaultRefreshInterval / 4.0f)
+, m_presented(false)
+, m_synchronized(false)
+, m_paced(false)
 {
     // Make sure that no application object has already been instanciated
     assert(!s_app);
@@ -74,12 +97,19 @@ int Application::run()
     m_running  = true;
     m_exitCode = 0;
 
+    // Get refresh interval of the display for frame pacing
+    GLFWmonitor * monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode * mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    m_refreshInterval = (mode && mode->refreshRate > 0) ? 1.0f / mode->refreshRate : s_defaultRefreshInterval;
+    m_frameMargin     = m_refreshInterval / 4.0f;
+
     // Execute main loop
     while (m_running)
     {
-        // Wait until events arrive.
+        // Wait until events arrive or timers elapse.
         // To unlock the main loop, call wakeup().
-        glfwWaitEvents();
+        waitEvents();
         processEvents();
     }
 
@@ -107,8 +137,97 @@ int Application::exitCode()
     return m_exitCode;
 }
 
+bool Application::framePacing() const
+{
+    return m_framePacing;
+}
+
+void Application::setFramePacing(bool framePacing)
+{
+    m_framePacing = framePacing;
+}
+
+float Application::predictedFrameTime() const
+{
+    return m_frameTime;
+}
+
+const Application::Statistics & Application::statistics() const
+{
+    return m_statistics;
+}
+
+void Application::resetStatistics()
+{
+    m_statistics = Statistics();
+}
+
+void Application::waitEvents()
+{
+    m_paced = false;
+
+    // Check if windows have pending work
+    bool pending = false;
+
+    for (Window * window : Window::instances())
+    {
+        pending = pending || window->m_needsRepaint || window->hasPendingEvents();
+    }
+
+    if (m_presented)
+    {
+        // Windows are rendered continuously, e.g., for animations.
+        // Collect events until shortly before the next vertical sync.
+        const auto start = nextFrameStart();
+
+        while (m_running)
+        {
+            // Take the time once, GLFW rejects timeouts that are not positive
+            const auto remaining = start - clock::now();
+            if (remaining <= clock::duration::zero())
+            {
+                break;
+            }
+
+            glfwWaitEventsTimeout(seconds(remaining));
+            m_paced = true;
+        }
+
+        glfwPollEvents();
+    }
+    else if (pending)
+    {
+        glfwPollEvents();
+    }
+    else
+    {
+        // Sleep until events arrive or the next timer elapses
+        const float timeout = m_environment->timerManager()->remainingTime();
+
+        if (timeout < 0.0f)
+        {
+            glfwWaitEvents();
+        }
+        else if (timeout > 0.0f)
+        {
+            glfwWaitEventsTimeout(timeout);
+        }
+        else
+        {
+            glfwPollEvents();
+        }
+    }
+
+    m_wakeTime = clock::now();
+}
+
 void Application::processEvents()
 {
+    bool  hadEvents   = false;
+    bool  presented   = false;
+    float renderTime  = 0.0f;
+    auto  presentTime = m_lastPresent;
+
     // Get messages for all windows
     for (Window * window : Window::instances())
     {
@@ -120,18 +239,89 @@ void Application::processEvents()
 
         // Process all events for the window
         if (window->hasPendingEvents()) {
+            const auto lastPresent = window->m_presentTime;
+
             window->processEvents();
+            hadEvents = true;
+
+            // Check if a frame has been presented
+            if (window->m_presentTime != lastPresent)
+            {
+                presented   = true;
+                renderTime += window->m_renderTime.count();
+                presentTime = std::max(presentTime, window->m_presentTime);
+            }
         }
     }
 
     // Update scripting timers
     m_environment->timerManager()->update();
 
-    // Make sure we don't saturate the CPU 
-    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // Update statistics
+    m_statistics.iterations++;
+
+    if (!hadEvents)
+    {
+        m_statistics.idleWakeups++;
+    }
+
+    if (presented)
+    {
+        updateFrameTiming(renderTime, presentTime);
+    }
+    else
+    {
+        m_synchronized = false;
+    }
+
+    m_presented = presented;
+}
+
+Application::clock::time_point Application::nextFrameStart() const
+{
+    // Only pace frames that are synchronized to the display
+    if (!m_framePacing || !m_synchronized)
+    {
+        return clock::now();
+    }
+
+    const float delay = m_refreshInterval - m_frameTime - m_frameMargin;
+
+    return m_lastPresent + std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(delay));
+}
+
+void Application::updateFrameTiming(float renderTime, clock::time_point presentTime)
+{
+    // Predict render time conservatively: follow increases immediately, decreases slowly
+    m_frameTime = std::max(renderTime, 0.9f * m_frameTime + 0.1f * renderTime);
+
+    // Swapping waits for the vertical sync if frames are presented about once per refresh interval
+    if (m_presented)
+    {
+        const float interval = seconds(presentTime - m_lastPresent);
+
+        m_synchronized = interval >= 0.75f * m_refreshInterval;
+
+        // Adapt safety margin, if a paced frame has been too late it has been shown one refresh interval later
+        if (m_paced && interval > 1.5f * m_refreshInterval)
+        {
+            m_statistics.missedFrames++;
+            m_frameMargin = std::min(2.0f * m_frameMargin, m_refreshInterval);
+        }
+        else if (m_paced)
+        {
+            m_frameMargin = std::max(0.99f * m_frameMargin, s_minFrameMargin);
+        }
+    }
+
+    // Measure latency
+    const float latency = seconds(presentTime - m_wakeTime);
+
+    m_statistics.frames++;
+    m_statistics.averageLatency += (latency - m_statistics.averageLatency) / m_statistics.frames;
+    m_statistics.maxLatency      = std::max(m_statistics.maxLatency, latency);
 
-    // Wake up mainloop to enable continuous update/simulation
-    wakeup();
+    m_lastPresent = presentTime;
 }
 
 
@@ -43,6 +43,7 @@ Window::Window()
 , m_quitOnDestroy(true)
 , m_needsRepaint(false)
 , m_context(nullptr)
+, m_renderTime(0.0f)
 {
     // Register window
     s_instances.insert(this);
@@ -444,9 +445,16 @@ void Window::handleEvent(WindowEvent & event)
             break;
 
         case WindowEvent::Type::Paint:
+        {
+            // Measure rendering separately, as swapping may wait for the vertical sync
+            const auto start = std::chrono::steady_clock::now();
             onPaint(static_cast<PaintEvent &>(event));
+            m_renderTime = std::chrono::steady_clock::now() - start;
+
             swap();
+            m_presentTime = std::chrono::steady_clock::now();
             break;
+        }
 
         case WindowEvent::Type::KeyPress:
             onKeyPress(static_cast<KeyEvent &>(event));
@@ -21,6 +21,9 @@ MultiFrameControlStage::MultiFrameControlStage(gloperate::Environment * environm
 , m_currentFrame(0)
 {
     setAlwaysProcessed(true);
+
+    // Stage does not use OpenGL
+    setContextFree(true);
 }
 
 MultiFrameControlStage::~MultiFrameControlStage()
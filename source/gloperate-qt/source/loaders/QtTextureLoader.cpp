@@ -73,7 +73,14 @@ std::string QtTextureLoader::allLoadingTypes() const
     return allTypes;
 }
 
-globjects::Texture * QtTextureLoader::load(const std::string & filename, const cppexpose::Variant & /*options*/, std::function<void(int, int)> /*progress*/) const
+globjects::Texture * QtTextureLoader::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    auto createTexture = prepare(filename, options, progress);
+
+    return createTexture ? createTexture() : nullptr;
+}
+
+std::function<globjects::Texture * ()> QtTextureLoader::prepare(const std::string & filename, const cppexpose::Variant & /*options*/, std::function<void(int, int)> /*progress*/) const
 {
     // Load image
     QImage image;
@@ -81,20 +88,23 @@ globjects::Texture * QtTextureLoader::load(const std::string & filename, const c
         // Convert image into RGBA format
         QImage converted = Converter::convert(image);
 
-        // Create texture
-        //TODO this "release" is ugly but to change it to use unique_ptr all Loaders and the resource manager must be changed
-        globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
-        texture->image2D(
-            0,
-            gl::GL_RGBA8,
-            converted.width(),
-            converted.height(),
-            0,
-            gl::GL_RGBA,
-            gl::GL_UNSIGNED_BYTE,
-            converted.constBits()
-        );
-        return texture;
+        // Create texture on the context thread
+        return [converted] ()
+        {
+            //TODO this "release" is ugly but to change it to use unique_ptr all Loaders and the resource manager must be changed
+            globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
+            texture->image2D(
+                0,
+                gl::GL_RGBA8,
+                converted.width(),
+                converted.height(),
+                0,
+                gl::GL_RGBA,
+                gl::GL_UNSIGNED_BYTE,
+                converted.constBits()
+            );
+            return texture;
+        };
     }
 
     // Could not load image
@@ -2,7 +2,9 @@
 #include <gloperate-qtquick/Application.h>
 
 #include <QUrl>
+#include <QDir>
 #include <QQmlContext>
+#include <QStandardPaths>
 #include <QSurfaceFormat>
 
 #include <cppassist/cmdline/ArgumentParser.h>
@@ -53,6 +55,17 @@ Application::Application(int & argc, char ** argv)
         gloperate::pluginPath(), cppexpose::PluginPathType::Internal
     );
 
+    // Store program binaries across application starts
+    if (!m_environment.safeMode())
+    {
+        const auto cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/programs";
+
+        if (QDir().mkpath(cachePath))
+        {
+            m_environment.programBinaryCache()->setDirectory(cachePath.toStdString());
+        }
+    }
+
     // Specify desired context format
     gloperate::GLContextFormat format;
     format.setVersion(3, 2);
@@ -4,6 +4,9 @@
 
 #include <vector>
 #include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
@@ -39,6 +42,12 @@ namespace gloperate_text
 *    is the sum of descent and ascent. This is to provide as much
 *    convenience measures for type setting/font rendering as possible.
 *
+*    Glyphs of the Latin range (see denseGlyphRange()) are stored in a
+*    contiguous table indexed by glyph index, all other glyphs in a map.
+*    Kerning pairs are collected unsorted while a font is loaded. On the
+*    first lookup they are sorted by glyph indices once, and an offset table
+*    for the pairs of each glyph of the Latin range is built.
+*
 *  @remarks
 *    This class does not provide dpi awareness. This has to be
 *    handled outside of this class, e.g., during layouting and rendering.
@@ -358,9 +367,10 @@ public:
     *  @brief
     *    Kerning for a glyph and a subsequent glyph in pt.
     *
-    *    If the glyph or the subsequent glyph are unknown to this font
-    *    face (assertion), 0.f will be returned. For more detais on
-    *    kerning, refer to the Glyph class.
+    *    The kerning provides a (usually negative) offset along the
+    *    baseline that can be used to move the pen-position respectively,
+    *    i.e., the subsequent pen-position is computed as follows:
+    *        pen-position + advance + kerning
     *
     *  @param[in] index
     *    The current glyph index (e.g., of the curren pen-position).
@@ -379,8 +389,9 @@ public:
     *  @brief
     *    Set the kerning for a glyph w.r.t. to a subsequent glyph in pt.
     *
-    *    If the glyph is known to this font face, the values are
-    *    forwared to the glyphs kerning setter (see Glyph for more information).
+    *    If kerning for the glyph pair has already been set, it is
+    *    replaced. Pairs are appended to an unsorted list, which is
+    *    sorted once on the next lookup.
     *
     *  @param[in] index
     *    The target glyph index.
@@ -391,6 +402,38 @@ public:
     */
     void setKerning(GlyphIndex index, GlyphIndex subsequentIndex, float kerning);
 
+    /**
+    *  @brief
+    *    Get the number of glyph indices stored in the contiguous glyph table.
+    *
+    *  @return
+    *    Glyphs with smaller indices are accessed without hashing.
+    */
+    static GlyphIndex denseGlyphRange();
+
+
+protected:
+    /**
+    *  @brief
+    *    Sort kerning pairs and build the offset table, if pairs have been added
+    *
+    *  @remarks
+    *    Can be called from several threads concurrently.
+    */
+    void updateKernings() const;
+
+
+protected:
+    /**
+    *  @brief
+    *    Kerning of a glyph pair
+    */
+    struct KerningPair
+    {
+        std::uint64_t glyphs;  ///< Glyph index in the upper, subsequent glyph index in the lower 32 bits
+        float         kerning; ///< Kerning in pt
+    };
+
 
 protected:
     float m_ascent;  ///< The distance from the baseline to the tops of the tallest glyphs (ascenders) in pt.
@@ -400,8 +443,14 @@ protected:
     glm::uvec2 m_glyphTextureExtent;  ///< The size/extent of the glyph texture in px.
     glm::vec4  m_glyphTexturePadding; ///< The padding applied to every glyph in px.
 
-    std::unique_ptr<globjects::Texture>   m_glyphTexture; ///< The font face's associated glyph atlas.
-    std::unordered_map<GlyphIndex, Glyph> m_glyphs;       ///< Quick-access container for all added glyphs.
+    std::unique_ptr<globjects::Texture>   m_glyphTexture;     ///< The font face's associated glyph atlas.
+    std::vector<Glyph>                    m_denseGlyphs;      ///< Glyphs of the Latin range, indexed by glyph index.
+    std::vector<std::uint8_t>             m_hasDenseGlyph;    ///< Flags for the glyphs of the Latin range that have been added.
+    std::unordered_map<GlyphIndex, Glyph> m_glyphs;           ///< Container for all added glyphs outside the Latin range.
+    mutable std::vector<KerningPair>      m_kernings;         ///< Kerning pairs, sorted by glyph indices unless m_kerningsSorted is 'false'.
+    mutable std::vector<std::uint32_t>    m_kerningOffsets;   ///< First kerning pair of each glyph in the Latin range (plus end).
+    mutable std::atomic<bool>             m_kerningsSorted;   ///< 'true' if m_kernings is sorted and m_kerningOffsets is up to date.
+    mutable std::mutex                    m_kerningsMutex;    ///< Serializes sorting of the kerning pairs.
 };
 
 
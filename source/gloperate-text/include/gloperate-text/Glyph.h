@@ -256,6 +256,11 @@ public:
     *    The kerning w.r.t. to the subsequent glyph in pt. If no
     *    kerning data is available for the subsequent glyph, the return
     *    value is zero/no kerning.
+    *
+    *  @remarks
+    *    Deprecated, use FontFace::kerning() instead. Only returns kerning
+    *    set via Glyph::setKerning(), FontFace does not fill in the
+    *    kerning of its glyphs anymore.
     */
     float kerning(GlyphIndex subsequentIndex) const;
 
@@ -276,6 +281,10 @@ public:
     *        enforced to be in terms of assertion or clamping.
     *    If kerning data for the subsequent glyph is already
     *    available it will be updated to the provided value.
+    *
+    *  @remarks
+    *    Deprecated, use FontFace::setKerning() instead. The kerning is
+    *    only stored in the glyph and not used for typesetting.
     */
     void setKerning(GlyphIndex subsequentIndex, float kerning);
 
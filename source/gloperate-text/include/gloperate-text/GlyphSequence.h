@@ -82,6 +82,10 @@ public:
     ,   float pixelPerInch
     ,   const glm::vec4 & margins = glm::vec4(0.f, 0.f, 0.f, 0.f));
 
+    // sequences are equal if they result in the same typeset vertices
+    bool operator==(const GlyphSequence & other) const;
+    bool operator!=(const GlyphSequence & other) const;
+
 
 protected:
     std::u32string m_string;
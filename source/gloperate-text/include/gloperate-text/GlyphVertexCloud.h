@@ -65,6 +65,8 @@ public:
     void update();
     // allows for volatile optimizations
     void update(const Vertices & vertices);
+    // uploads only the given range of vertices (number of vertices must not have changed since the last full update)
+    void update(size_t first, size_t count);
 
     void optimize(
         const std::vector<GlyphSequence> & sequences
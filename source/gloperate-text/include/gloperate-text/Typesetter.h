@@ -46,6 +46,7 @@ private:
     ,   const FontFace & fontFace
     ,   const glm::vec2 & pen
     ,   const Glyph & glyph
+    ,   float kerning
     ,   const std::u32string::const_iterator & index
     ,   std::u32string::const_iterator & safe_forward);
 
@@ -6,6 +6,7 @@
 
 #include <gloperate/pipeline/Stage.h>
 
+#include <gloperate-text/GlyphSequence.h>
 #include <gloperate-text/gloperate-text_api.h>
 
 
@@ -14,10 +15,19 @@ namespace gloperate_text
 
 
 class FontFace;
-class GlyphSequence;
 class GlyphVertexCloud;
 
 
+/**
+*  @brief
+*    Stage that typesets glyph sequences into a vertex cloud
+*
+*    Sequences that did not change since the last processing keep their
+*    vertex range. Changed sequences are typeset in parallel and only their
+*    vertex ranges are uploaded, as long as the number of vertices of every
+*    sequence stays the same. Otherwise, the vertex ranges are rearranged
+*    and the whole vertex cloud is uploaded.
+*/
 class GLOPERATE_TEXT_API GlyphPreparationStage : public gloperate::Stage
 {
 public:
@@ -33,14 +43,30 @@ public:
     virtual ~GlyphPreparationStage();
 
 
+protected:
+    /**
+    *  @brief
+    *    Typeset sequence and its vertex range
+    */
+    struct SequenceRange
+    {
+        GlyphSequence sequence; ///< Copy of the sequence as it has been typeset
+        size_t        first;    ///< Index of the first vertex
+        size_t        count;    ///< Number of vertices
+    };
+
+
 protected:
     virtual void onContextInit(gloperate::AbstractGLContext * context) override;
     virtual void onContextDeinit(gloperate::AbstractGLContext * context) override;
     virtual void onProcess() override;
+    virtual void onInputValueChanged(gloperate::AbstractSlot * slot) override;
 
 
 protected:
     std::unique_ptr<GlyphVertexCloud> m_vertexCloud;
+    std::vector<SequenceRange>        m_ranges;  ///< Vertex ranges of the sequences in the vertex cloud
+    bool                              m_rebuild; ///< Shall all sequences be typeset again?
 };
 
 
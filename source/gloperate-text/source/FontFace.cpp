@@ -1,6 +1,26 @@
 
 #include <gloperate-text/FontFace.h>
 
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+
+
+// Basic Latin up to Latin Extended-B
+const gloperate_text::GlyphIndex denseRange = 0x0250;
+
+
+std::uint64_t kerningKey(const gloperate_text::GlyphIndex index, const gloperate_text::GlyphIndex subsequentIndex)
+{
+    return (static_cast<std::uint64_t>(index) << 32) | subsequentIndex;
+}
+
+
+} // namespace
+
 
 namespace gloperate_text
 {
@@ -10,6 +30,10 @@ FontFace::FontFace()
 : m_ascent (0.f)
 , m_descent(0.f)
 , m_linegap(0.f)
+, m_denseGlyphs(denseRange)
+, m_hasDenseGlyph(denseRange, 0)
+, m_kerningOffsets(denseRange + 1, 0)
+, m_kerningsSorted(true)
 {
 }
 
@@ -121,11 +145,25 @@ void FontFace::setGlyphTexture(std::unique_ptr<globjects::Texture> && texture)
 
 bool FontFace::hasGlyph(const GlyphIndex index) const
 {
+    if (index < denseRange)
+        return m_hasDenseGlyph[index] != 0;
+
     return m_glyphs.find(index) != m_glyphs.cend();
 }
 
 Glyph & FontFace::glyph(const GlyphIndex index)
 {
+    if (index < denseRange)
+    {
+        if (!m_hasDenseGlyph[index])
+        {
+            m_denseGlyphs[index].setIndex(index);
+            m_hasDenseGlyph[index] = 1;
+        }
+
+        return m_denseGlyphs[index];
+    }
+
     const auto existing = m_glyphs.find(index);
     if (existing != m_glyphs.cend())
         return existing->second;
@@ -139,17 +177,31 @@ Glyph & FontFace::glyph(const GlyphIndex index)
 
 const Glyph & FontFace::glyph(const GlyphIndex index) const
 {
+    static const auto empty = Glyph();
+
+    if (index < denseRange)
+        return m_hasDenseGlyph[index] ? m_denseGlyphs[index] : empty;
+
     const auto existing = m_glyphs.find(index);
     if (existing != m_glyphs.cend())
         return existing->second;
 
-    static const auto empty = Glyph();
     return empty;
 }
 
 void FontFace::addGlyph(const Glyph & glyph)
 {
-    assert(m_glyphs.find(glyph.index()) == m_glyphs.cend());
+    assert(!hasGlyph(glyph.index()));
+
+    if (glyph.index() < denseRange)
+    {
+        if (m_hasDenseGlyph[glyph.index()])
+            return;
+
+        m_denseGlyphs[glyph.index()] = glyph;
+        m_hasDenseGlyph[glyph.index()] = 1;
+        return;
+    }
 
     m_glyphs.emplace(glyph.index(), glyph);
 }
@@ -157,6 +209,12 @@ void FontFace::addGlyph(const Glyph & glyph)
 std::vector<GlyphIndex> FontFace::glyphs() const
 {
     auto glyphs = std::vector<GlyphIndex>();
+    for (auto i = GlyphIndex(0); i < denseRange; ++i)
+    {
+        if (m_hasDenseGlyph[i])
+            glyphs.push_back(i);
+    }
+
     for (const auto & i : m_glyphs)
         glyphs.push_back(i.first);
 
@@ -170,23 +228,85 @@ bool FontFace::depictable(const GlyphIndex index) const
 
 float FontFace::kerning(const GlyphIndex index, const GlyphIndex subsequentIndex) const
 {
-    const auto it = m_glyphs.find(index);
-    if (it == m_glyphs.cend())
+    updateKernings();
+
+    // Restrict search to the kerning pairs of the glyph, if it is in the Latin range
+    const auto begin = m_kernings.cbegin() + m_kerningOffsets[std::min(index, denseRange)];
+    const auto end = index < denseRange ? m_kernings.cbegin() + m_kerningOffsets[index + 1] : m_kernings.cend();
+
+    if (begin == end)
+        return 0.f;
+
+    const auto key = kerningKey(index, subsequentIndex);
+    const auto it = std::lower_bound(begin, end, key, [] (const KerningPair & pair, std::uint64_t key)
+    {
+        return pair.glyphs < key;
+    });
+
+    if (it == end || it->glyphs != key)
         return 0.f;
 
-    return it->second.kerning(subsequentIndex);
+    return it->kerning;
 }
 
 void FontFace::setKerning(const GlyphIndex index, const GlyphIndex subsequentIndex, const float kerning)
 {
-    const auto it = m_glyphs.find(index);
-    if (it == m_glyphs.cend() || !hasGlyph(subsequentIndex))
+    if (!hasGlyph(index) || !hasGlyph(subsequentIndex))
     {
         assert(false);
         return;
     }
 
-    it->second.setKerning(subsequentIndex, kerning);
+    // Pairs are sorted once on the next lookup
+    std::lock_guard<std::mutex> lock(m_kerningsMutex);
+
+    m_kernings.push_back(KerningPair{ kerningKey(index, subsequentIndex), kerning });
+    m_kerningsSorted.store(false, std::memory_order_release);
+}
+
+GlyphIndex FontFace::denseGlyphRange()
+{
+    return denseRange;
+}
+
+void FontFace::updateKernings() const
+{
+    if (m_kerningsSorted.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_kerningsMutex);
+
+    if (m_kerningsSorted.load(std::memory_order_relaxed))
+        return;
+
+    // Sort pairs; the stable sort keeps pairs that have been set repeatedly in order of setting
+    std::stable_sort(m_kernings.begin(), m_kernings.end(), [] (const KerningPair & a, const KerningPair & b)
+    {
+        return a.glyphs < b.glyphs;
+    });
+
+    // Keep the last kerning set for each pair
+    auto last = m_kernings.begin();
+    for (auto it = m_kernings.begin(); it != m_kernings.end(); ++it)
+    {
+        if (last != m_kernings.begin() && (last - 1)->glyphs == it->glyphs)
+            *(last - 1) = *it;
+        else
+            *last++ = *it;
+    }
+    m_kernings.erase(last, m_kernings.end());
+
+    // Find first pair of each glyph of the Latin range
+    auto pair = std::uint32_t(0);
+    for (auto index = GlyphIndex(0); index <= denseRange; ++index)
+    {
+        while (pair < m_kernings.size() && (m_kernings[pair].glyphs >> 32) < index)
+            ++pair;
+
+        m_kerningOffsets[index] = pair;
+    }
+
+    m_kerningsSorted.store(true, std::memory_order_release);
 }
 
 
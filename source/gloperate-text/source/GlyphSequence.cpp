@@ -212,5 +212,21 @@ void GlyphSequence::setTransform(
     m_transform = glm::scale(m_transform, glm::vec3(fontSize / fontFace.size()));
 }
 
+bool GlyphSequence::operator==(const GlyphSequence & other) const
+{
+    return m_wordWrap == other.m_wordWrap
+        && m_lineWidth == other.m_lineWidth
+        && m_alignment == other.m_alignment
+        && m_anchor == other.m_anchor
+        && m_fontColor == other.m_fontColor
+        && m_transform == other.m_transform
+        && m_string == other.m_string;
+}
+
+bool GlyphSequence::operator!=(const GlyphSequence & other) const
+{
+    return !(*this == other);
+}
+
 
 } // namespace gloperate_text
@@ -3,12 +3,15 @@
 
 #include <numeric>
 #include <algorithm>
+#include <cassert>
 
 #include <cppassist/memory/offsetof.h>
 
+#include <glbinding/gl/types.h>
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/boolean.h>
 
+#include <globjects/Buffer.h>
 #include <globjects/Texture.h>
 
 #include <gloperate/rendering/Drawable.h>
@@ -128,6 +131,19 @@ void GlyphVertexCloud::update(const Vertices & vertices)
     m_drawable->setSize(vertices.size());
 }
 
+void GlyphVertexCloud::update(const size_t first, const size_t count)
+{
+    assert(first + count <= m_vertices.size());
+
+    if (count == 0)
+        return;
+
+    m_drawable->buffer(0)->setSubData(
+        static_cast<gl::GLintptr>(first * sizeof(Vertex))
+    ,   static_cast<gl::GLsizeiptr>(count * sizeof(Vertex))
+    ,   m_vertices.data() + first);
+}
+
 void GlyphVertexCloud::optimize(
     const std::vector<GlyphSequence> & sequences
 ,   const FontFace & fontFace)
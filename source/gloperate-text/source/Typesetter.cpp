@@ -55,11 +55,12 @@ glm::vec2 Typesetter::typeset(
     for (auto i = iBegin; i != iEnd; ++i)
     {
         const auto & glyph = fontFace.glyph(*i);
+        const auto kerning = i != iBegin ? fontFace.kerning(*(i - 1), *i) : 0.f;
 
         // handle line feeds as well as word wrap for next word (or 
         // next glyph if word width exceeds the max line width)
         feedLine = *i == lineFeed() || (sequence.wordWrap() &&
-            typeset_wordwrap(sequence, fontFace, pen, glyph, i, safe_forward));
+            typeset_wordwrap(sequence, fontFace, pen, glyph, kerning, i, safe_forward));
 
         if (feedLine)
         {
@@ -76,8 +77,8 @@ glm::vec2 Typesetter::typeset(
             feedLine = false;
             feedVertex = vertex;
         }
-        else if (i != iBegin) // apply kerning
-            pen.x += fontFace.kerning(*(i - 1), *i);
+        else // apply kerning
+            pen.x += kerning;
 
         // typeset glyphs in vertex cloud (only if renderable)
         if (!dryrun && glyph.depictable())
@@ -108,6 +109,7 @@ inline bool Typesetter::typeset_wordwrap(
 ,   const FontFace & fontFace
 ,   const glm::vec2 & pen
 ,   const Glyph & glyph
+,   const float kerning
 ,   const std::u32string::const_iterator & index
 ,   std::u32string::const_iterator & safe_forward)
 {
@@ -116,8 +118,7 @@ inline bool Typesetter::typeset_wordwrap(
     const auto lineWidth = sequence.lineWidth();
     auto width_forward = 0.f;
 
-    const auto pen_glyph = pen.x + glyph.advance()
-        + (index != sequence.string().cbegin() ? fontFace.kerning(*(index - 1), *index) : 0.f);
+    const auto pen_glyph = pen.x + glyph.advance() + kerning;
 
     const auto wrap_glyph = glyph.depictable() && pen_glyph > lineWidth
         && (glyph.advance() <= lineWidth || pen.x > 0.f);
@@ -193,7 +194,7 @@ inline void Typesetter::typeset_extent(
     // on line feed, revert advance of preceding, not depictable glyphs
     while (index > begin)
     {
-        auto precedingGlyph = fontFace.glyph(*index);
+        const auto & precedingGlyph = fontFace.glyph(*index);
         if (precedingGlyph.depictable())
             break;
 
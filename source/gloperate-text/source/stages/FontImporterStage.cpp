@@ -24,7 +24,7 @@ FontImporterStage::~FontImporterStage()
 
 void FontImporterStage::onProcess()
 {
-    auto newFont = std::unique_ptr<FontFace>{ m_environment->resourceManager()->load<FontFace>(fontFilePath.value().path())};
+    auto newFont = std::unique_ptr<FontFace>{ m_environment->resourceManager()->load<FontFace>(fontFilePath.valueRef().path())};
 
     if (newFont)
     {
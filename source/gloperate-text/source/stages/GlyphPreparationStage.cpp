@@ -1,6 +1,11 @@
 
 #include <gloperate-text/stages/GlyphPreparationStage.h>
 
+#include <algorithm>
+
+#include <gloperate/base/Environment.h>
+#include <gloperate/base/ThreadPool.h>
+
 #include <gloperate-text/FontFace.h>
 #include <gloperate-text/GlyphSequence.h>
 #include <gloperate-text/Typesetter.h>
@@ -16,6 +21,7 @@ GlyphPreparationStage::GlyphPreparationStage(gloperate::Environment * environmen
 , sequences("sequences", this)
 , optimized("optimized", this)
 , vertexCloud("vertexCloud", this)
+, m_rebuild(true)
 {
 }
 
@@ -26,49 +32,164 @@ GlyphPreparationStage::~GlyphPreparationStage()
 void GlyphPreparationStage::onContextInit(gloperate::AbstractGLContext *)
 {
     m_vertexCloud = cppassist::make_unique<GlyphVertexCloud>();
+
+    m_ranges.clear();
+    m_rebuild = true;
 }
 
 void GlyphPreparationStage::onContextDeinit(gloperate::AbstractGLContext *)
 {
     m_vertexCloud = nullptr;
+
+    m_ranges.clear();
+    m_rebuild = true;
 }
 
 void GlyphPreparationStage::onProcess()
 {
-    // get total number of glyphs
-    auto numGlyphs = std::size_t{ 0 };
-    for (const auto & sequence : *sequences.value())
+    assert(font.value() != nullptr);
+
+    const auto & fontFace = *font.value();
+    const auto & glyphSequences = *sequences.value();
+    auto & vertices = m_vertexCloud->vertices();
+    auto & threadPool = *environment()->threadPool();
+
+    // optimized vertex clouds are sorted by glyph, so sequences cannot keep their vertex ranges
+    if (optimized.value())
+        m_rebuild = true;
+
+    // find sequences that have to be typeset again
+    auto dirty = std::vector<size_t>();
+    for (auto i = size_t(0); i < glyphSequences.size(); ++i)
     {
-        numGlyphs += sequence.size(*font.value());
+        if (m_rebuild || i >= m_ranges.size() || m_ranges[i].sequence != glyphSequences[i])
+            dirty.push_back(i);
     }
 
-    // prepare vertex cloud storage
-    m_vertexCloud->vertices().clear();
-    m_vertexCloud->vertices().resize(numGlyphs);
+    // get number of glyphs of changed sequences
+    m_ranges.resize(glyphSequences.size());
 
-    // typeset and transform all sequences
-    assert(font.value() != nullptr);
+    threadPool.parallelFor(dirty.size(), [this, &dirty, &glyphSequences, &fontFace] (size_t begin, size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            m_ranges[dirty[i]].count = glyphSequences[dirty[i]].size(fontFace);
+        }
+    });
+
+    // compute vertex ranges, keep vertices of unchanged sequences if their range has moved
+    auto rearrange = false;
+    auto numGlyphs = std::size_t{ 0 };
+    auto nextDirty = dirty.cbegin();
+    auto rearranged = GlyphVertexCloud::Vertices();
 
-    auto vertexItr =m_vertexCloud->vertices().begin();
-    for (const auto & sequence : *sequences.value())
+    for (auto i = size_t(0); i < m_ranges.size(); ++i)
     {
-        /*auto extent = */Typesetter::typeset(sequence, *font.value(), vertexItr);
-        vertexItr += sequence.size(*font.value());
+        auto & range = m_ranges[i];
+        const auto unchanged = nextDirty == dirty.cend() || *nextDirty != i;
+
+        if (!unchanged)
+            ++nextDirty;
+
+        if (range.first != numGlyphs && !rearrange && !m_rebuild)
+        {
+            // start over with a new vertex cloud and copy all preceding ranges
+            rearrange = true;
+            rearranged.assign(vertices.cbegin(), vertices.cbegin() + std::min(numGlyphs, vertices.size()));
+        }
+
+        if (rearrange)
+        {
+            rearranged.resize(numGlyphs + range.count);
+
+            if (unchanged)
+            {
+                std::copy(vertices.cbegin() + range.first, vertices.cbegin() + range.first + range.count
+                    , rearranged.begin() + numGlyphs);
+            }
+        }
+
+        range.first = numGlyphs;
+        numGlyphs += range.count;
     }
 
-    if (optimized.value())
+    // the whole vertex cloud has to be uploaded if any vertex range has changed
+    const auto fullUpdate = m_rebuild || rearrange || numGlyphs != vertices.size();
+
+    if (m_rebuild)
     {
-        m_vertexCloud->optimize(*sequences.value(), *font.value()); // optimize and update drawable
+        vertices.clear();
+        vertices.resize(numGlyphs);
+    }
+    else if (rearrange)
+    {
+        vertices.swap(rearranged);
     }
     else
+    {
+        vertices.resize(numGlyphs);
+    }
+
+    // typeset and transform changed sequences in parallel
+    threadPool.parallelFor(dirty.size(), [this, &dirty, &glyphSequences, &fontFace, &vertices] (size_t begin, size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            const auto index = dirty[i];
+
+            /*auto extent = */Typesetter::typeset(glyphSequences[index], fontFace, vertices.begin() + m_ranges[index].first);
+            m_ranges[index].sequence = glyphSequences[index];
+        }
+    });
+
+    if (optimized.value())
+    {
+        m_vertexCloud->optimize(glyphSequences, fontFace); // optimize and update drawable
+    }
+    else if (fullUpdate)
     {
         m_vertexCloud->update(); // update drawable
     }
+    else
+    {
+        // upload vertex ranges of changed sequences, merging adjacent ranges
+        auto first = std::size_t{ 0 };
+        auto count = std::size_t{ 0 };
+
+        for (const auto index : dirty)
+        {
+            const auto & range = m_ranges[index];
+
+            if (first + count != range.first)
+            {
+                m_vertexCloud->update(first, count);
+                first = range.first;
+                count = 0;
+            }
+
+            count += range.count;
+        }
+
+        m_vertexCloud->update(first, count);
+    }
+
+    m_rebuild = false;
 
     m_vertexCloud->setTexture(font.value()->glyphTexture());
 
     vertexCloud.setValue(m_vertexCloud.get());
 }
 
+void GlyphPreparationStage::onInputValueChanged(gloperate::AbstractSlot * slot)
+{
+    // glyphs of a new font face have different vertices
+    if (slot == &font || slot == &optimized)
+    {
+        m_rebuild = true;
+    }
+
+    Stage::onInputValueChanged(slot);
+}
+
 
 } // namespace gloperate_text
@@ -3,6 +3,7 @@
 
 
 #include <memory>
+#include <typeinfo>
 
 #include <cppexpose/plugin/AbstractComponent.h>
 
@@ -50,6 +51,9 @@ public:
 
     virtual std::unique_ptr<gloperate::Stage> createInstance(gloperate::Environment * environment) = 0;
     virtual std::unique_ptr<gloperate::Stage> createInstance(gloperate::Environment * environment, const std::string & name) = 0;
+
+    // Type of the created stages, used to find the component of an existing stage
+    virtual const std::type_info & instanceType() const = 0;
 };
 
 
@@ -0,0 +1,111 @@
+
+#pragma once
+
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Bounded multi-producer single-consumer queue for small values
+*
+*    Values can be pushed from any number of threads without locking,
+*    while only one thread at a time is allowed to pop values. If the
+*    queue is full, new values are rejected instead of growing the queue.
+*
+*    InputEventQueue is based on this queue. T must be
+*    default-constructible and copy-assignable.
+*/
+template <typename T>
+class BoundedQueue
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Maximum number of queued values (rounded up to the next power of two)
+    */
+    explicit BoundedQueue(size_t capacity);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~BoundedQueue();
+
+    // No copying
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+    /**
+    *  @brief
+    *    Get capacity
+    *
+    *  @return
+    *    Maximum number of queued values
+    */
+    size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Push value into the queue
+    *
+    *  @param[in] value
+    *    Value
+    *
+    *  @return
+    *    'true' if the value has been queued, 'false' if the queue is full and the value has been discarded
+    *
+    *  @remarks
+    *    This function can be called from any thread.
+    */
+    bool push(const T & value);
+
+    /**
+    *  @brief
+    *    Take the oldest value from the queue
+    *
+    *  @param[out] value
+    *    Value (unchanged if the queue is empty)
+    *
+    *  @return
+    *    'true' if a value has been taken, 'false' if the queue is empty
+    *
+    *  @remarks
+    *    This function must only be called from one thread at a time.
+    */
+    bool pop(T & value);
+
+
+protected:
+    /**
+    *  @brief
+    *    Slot of the ring buffer
+    */
+    struct Cell
+    {
+        std::atomic<size_t> sequence; ///< Position for which the cell can be written (position) or read (position + 1)
+        T                   value;    ///< Queued value
+    };
+
+
+protected:
+    std::unique_ptr<Cell[]> m_cells;   ///< Ring buffer
+    size_t                  m_mask;    ///< Capacity - 1
+    std::atomic<size_t>     m_pushPos; ///< Next position to write
+    std::atomic<size_t>     m_popPos;  ///< Next position to read
+};
+
+
+} // namespace gloperate
+
+
+#include <gloperate/base/BoundedQueue.inl>
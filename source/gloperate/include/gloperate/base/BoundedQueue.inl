@@ -0,0 +1,108 @@
+
+#pragma once
+
+
+#include <cstddef>
+
+
+namespace gloperate
+{
+
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+: m_mask(0)
+, m_pushPos(0)
+, m_popPos(0)
+{
+    // Round capacity up to a power of two
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    m_mask  = size - 1;
+    m_cells.reset(new Cell[size]);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+BoundedQueue<T>::~BoundedQueue()
+{
+}
+
+template <typename T>
+size_t BoundedQueue<T>::capacity() const
+{
+    return m_mask + 1;
+}
+
+template <typename T>
+bool BoundedQueue<T>::push(const T & value)
+{
+    auto pos = m_pushPos.load(std::memory_order_relaxed);
+    Cell * cell = nullptr;
+
+    // Reserve a cell
+    while (true)
+    {
+        cell = &m_cells[pos & m_mask];
+
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff     = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+        if (diff == 0)
+        {
+            // Cell is free, try to claim it
+            if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Queue is full
+            return false;
+        }
+        else
+        {
+            // Another producer has claimed the cell
+            pos = m_pushPos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Publish value to the consumer
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+bool BoundedQueue<T>::pop(T & value)
+{
+    const auto pos = m_popPos.load(std::memory_order_relaxed);
+    auto & cell = m_cells[pos & m_mask];
+
+    // Check if the cell has been written
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+    {
+        return false;
+    }
+
+    value = cell.value;
+
+    // Release cell for the next round
+    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_popPos.store(pos + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+
+} // namespace gloperate
@@ -4,6 +4,9 @@
 
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 #include <glm/vec4.hpp>
 #include <glm/fwd.hpp>
@@ -14,6 +17,7 @@
 #include <cppexpose/signal/ScopedConnection.h>
 
 #include <gloperate/base/ChronoTimer.h>
+#include <gloperate/base/BoundedQueue.h>
 
 
 namespace globjects
@@ -38,6 +42,12 @@ class DepthStencilRenderTarget;
 class StencilRenderTarget;
 class BlitStage;
 
+template <typename T>
+class Input;
+
+template <typename T>
+class Output;
+
 
 /**
 *  @brief
@@ -167,6 +177,10 @@ public:
     *    or time delta inputs and in turn invalidates its render outputs,
     *    a redraw will be scheduled. Otherwise, only the virtual time is
     *    updated regularly, but no redraw occurs.
+    *
+    *    The time delta is queued and never waits for a frame that is
+    *    currently rendered. It is applied right away if the render thread
+    *    is idle, otherwise at the start of the next frame.
     */
     void updateTime();
 
@@ -176,6 +190,10 @@ public:
     *
     *  @param[in] viewport
     *    Viewport (in real device coordinates)
+    *
+    *  @remarks
+    *    Like updateTime(), the viewport is queued and applied without
+    *    waiting for a frame that is currently rendered.
     */
     void setViewport(const glm::vec4 & viewport);
 
@@ -184,7 +202,7 @@ public:
     *    Get viewport (in real device coordinates)
     *
     *  @return
-    *    The viewport
+    *    The viewport that has been applied last
     */
     const glm::vec4 & viewport() const;
 
@@ -197,6 +215,20 @@ public:
     */
     void render(globjects::Framebuffer * targetFBO);
 
+    /**
+    *  @brief
+    *    Get input latency
+    *
+    *  @return
+    *    Time from the oldest input event of the last frame that processed
+    *    input until the frame has been submitted by render()
+    *
+    *  @remarks
+    *    The time the frame needs to be presented by the windowing backend
+    *    is not included.
+    */
+    std::chrono::nanoseconds inputLatency() const;
+
     /**
     *  @brief
     *    Promote keyboard press event (must be called from UI thread)
@@ -205,6 +237,11 @@ public:
     *    Key (gloperate key code)
     *  @param[in] modifier
     *    Modifiers (gloperate modifier codes)
+    *
+    *  @remarks
+    *    Input events are queued and never wait for a frame that is
+    *    currently rendered. They are dispatched right away if the render
+    *    thread is idle, otherwise at the start of the next frame.
     */
     void promoteKeyPress(int key, int modifier);
 
@@ -263,8 +300,76 @@ public:
     //@}
 
 
+protected:
+    /**
+    *  @brief
+    *    Update that is passed from the UI thread to the render thread
+    */
+    struct Command
+    {
+        /**
+        *  @brief
+        *    Type of update
+        */
+        enum class Type
+        {
+            TimeDelta, ///< Advance virtual time by timeDelta
+            Viewport,  ///< Set viewport to viewport
+            Input      ///< Input event has been queued at time
+        };
+
+        Type                                  type;      ///< Type of update
+        float                                 timeDelta; ///< Time delta (in seconds)
+        glm::vec4                             viewport;  ///< Viewport (in real device coordinates)
+        std::chrono::steady_clock::time_point time;      ///< Time at which the update has been queued
+    };
+
+
 protected:
     //@{
+    /**
+    *  @brief
+    *    Queue input event that has been passed to a device
+    *
+    *  @remarks
+    *    The event is dispatched by tryApplyCommands() or the next frame.
+    */
+    void queueInput();
+
+    /**
+    *  @brief
+    *    Queue update for the render thread
+    *
+    *  @param[in] command
+    *    Update
+    *
+    *  @remarks
+    *    Only blocks if the queue is full, in which case the queued
+    *    updates are applied first.
+    */
+    void pushCommand(const Command & command);
+
+    /**
+    *  @brief
+    *    Apply queued updates if no frame is rendered at the moment
+    *
+    *  @remarks
+    *    Dispatches queued updates and input events, checks if a redraw
+    *    is required and promotes changed inputs to scripting. Does
+    *    nothing if the canvas is locked, as render() applies the
+    *    updates at the start of the next frame.
+    */
+    void tryApplyCommands();
+
+    /**
+    *  @brief
+    *    Apply queued updates and dispatch queued input events
+    *
+    *  @remarks
+    *    m_mutex must be held by the caller.
+    */
+    void applyCommands();
+
     /**
     *  @brief
     *    Check if a redraw is required
@@ -305,12 +410,16 @@ protected:
     cppexpose::Variant scr_getSlot(const std::string & path, const std::string & slot);
     cppexpose::Variant scr_getValue(const std::string & path, const std::string & slot);
     void scr_setValue(const std::string & path, const std::string & slot, const cppexpose::Variant & value);
+    cppexpose::Variant scr_batch(const cppexpose::Variant & operations);
+    bool scr_saveSnapshot(const std::string & filename);
+    bool scr_loadSnapshot(const std::string & filename);
     //@}
 
     //@{
     // Helper functions
     Stage * getStageObject(const std::string & path) const;
     cppexpose::Variant getSlotStatus(const std::string & path, const std::string & slot);
+    void updateSlots();
     //@}
 
 
@@ -327,7 +436,11 @@ protected:
     std::unique_ptr<MouseDevice>              m_mouseDevice;            ///< Device for Mouse Events
     std::unique_ptr<KeyboardDevice>           m_keyboardDevice;         ///< Device for Keyboard Events
     bool                                      m_replaceStage;           ///< 'true' if the stage has just been replaced, else 'false'
-    std::mutex                                m_mutex;                  ///< Mutex for separating main and render thread
+    std::mutex                                m_mutex;                  ///< Mutex for structural changes (stage replacement, scripting) and rendering
+    BoundedQueue<Command>                     m_commands;               ///< Updates from the UI thread that have not been applied yet
+    bool                                      m_inputPending;           ///< 'true' if input has been dispatched that has not been rendered yet, else 'false'
+    std::chrono::steady_clock::time_point     m_inputTime;              ///< Time of the oldest input event that has not been rendered yet
+    std::atomic<std::int64_t>                 m_inputLatency;           ///< Input latency of the last frame that processed input (in nanoseconds)
     cppexpose::ScopedConnection               m_inputChangedConnection; ///< Connection for the inputChanged-signal of the current stage
     cppexpose::Function                       m_inputChangedCallback;   ///< Script function that is called on inputChanged (slot, status)
     std::vector<AbstractSlot *>               m_changedInputs;          ///< List of changed input slots
@@ -337,6 +450,17 @@ protected:
     std::unique_ptr<DepthRenderTarget>        m_depthTarget;            ///< Input render target for depth attachment
     std::unique_ptr<DepthStencilRenderTarget> m_depthStencilTarget;     ///< Input render target for combined depth stencil attachment
     std::unique_ptr<StencilRenderTarget>      m_stencilTarget;          ///< Input render target for stencil attachment
+
+    const Stage                                    * m_slotStage;                ///< Render stage whose slots have been looked up (null if the slots have to be looked up again)
+    size_t                                           m_slotRevision;             ///< Slot revision of the render stage when the slots have been looked up
+    Input<float>                                   * m_timeDeltaInput;           ///< Input 'timeDelta' of the render stage (can be null)
+    Input<glm::vec4>                               * m_viewportInput;            ///< Input 'viewport' of the render stage (can be null)
+    std::vector<Input<ColorRenderTarget *> *>        m_colorTargetInputs;        ///< Color render target inputs of the render stage
+    std::vector<Input<DepthRenderTarget *> *>        m_depthTargetInputs;        ///< Depth render target inputs of the render stage
+    std::vector<Input<DepthStencilRenderTarget *> *> m_depthStencilTargetInputs; ///< Depth stencil render target inputs of the render stage
+    std::vector<Input<StencilRenderTarget *> *>      m_stencilTargetInputs;      ///< Stencil render target inputs of the render stage
+    std::vector<Output<ColorRenderTarget *> *>       m_colorTargetOutputs;       ///< Color render target outputs of the render stage
+    Output<glm::vec4>                              * m_viewportOutput;           ///< First viewport output of the render stage (can be null)
 };
 
 
@@ -43,6 +43,7 @@ public:
 
     virtual std::unique_ptr<gloperate::Stage> createInstance(gloperate::Environment * environment) override;
     virtual std::unique_ptr<gloperate::Stage> createInstance(gloperate::Environment * environment, const std::string & name) override;
+    virtual const std::type_info & instanceType() const override;
 };
 
 
@@ -45,5 +45,11 @@ std::unique_ptr<gloperate::Stage> StageComponent<Type>::createInstance(gloperate
     return cppassist::make_unique<Type>(environment, name);
 }
 
+template <class Type>
+const std::type_info & StageComponent<Type>::instanceType() const
+{
+    return typeid(Type);
+}
+
 
 } // namespace gloperate
@@ -9,10 +9,13 @@
 #include <cppexpose/signal/Signal.h>
 
 #include <gloperate/base/ComponentManager.h>
+#include <gloperate/base/Profiler.h>
 #include <gloperate/base/ResourceManager.h>
 #include <gloperate/base/System.h>
 #include <gloperate/base/TimerManager.h>
+#include <gloperate/base/ThreadPool.h>
 #include <gloperate/input/InputManager.h>
+#include <gloperate/rendering/ProgramBinaryCache.h>
 
 
 namespace cppexpose
@@ -115,6 +118,42 @@ public:
     TimerManager * timerManager();
     //@}
 
+    //@{
+    /**
+    *  @brief
+    *    Get thread pool
+    *
+    *  @return
+    *    Thread pool for parallel tasks (never null)
+    */
+    const ThreadPool * threadPool() const;
+    ThreadPool * threadPool();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get program binary cache
+    *
+    *  @return
+    *    Cache for linked programs shared by all stages (never null)
+    */
+    const ProgramBinaryCache * programBinaryCache() const;
+    ProgramBinaryCache * programBinaryCache();
+    //@}
+
+    //@{
+    /**
+    *  @brief
+    *    Get profiler
+    *
+    *  @return
+    *    Profiler that collects the time spans of all stages (never null)
+    */
+    const Profiler * profiler() const;
+    Profiler * profiler();
+    //@}
+
     //@{
     /**
     *  @brief
@@ -253,18 +292,21 @@ protected:
 
 
 protected:
-    ComponentManager                          m_componentManager; ///< Manager for plugin libraries and components
-    ResourceManager                           m_resourceManager;  ///< Resource manager for loaders/storers
-    System                                    m_system;           ///< System functions for scripting
-    InputManager                              m_inputManager;     ///< Manager for Devices, -Providers and InputEvents
-    TimerManager                              m_timerManager;     ///< Manager for scripting timers
+    ComponentManager                          m_componentManager;   ///< Manager for plugin libraries and components
+    ResourceManager                           m_resourceManager;    ///< Resource manager for loaders/storers
+    System                                    m_system;             ///< System functions for scripting
+    InputManager                              m_inputManager;       ///< Manager for Devices, -Providers and InputEvents
+    TimerManager                              m_timerManager;       ///< Manager for scripting timers
+    ProgramBinaryCache                        m_programBinaryCache; ///< Cache for linked programs
+    Profiler                                  m_profiler;           ///< Profiler for stages and pipelines
 
-    std::vector<Canvas *>                     m_canvases;         ///< List of active canvases
+    std::vector<Canvas *>                     m_canvases;           ///< List of active canvases
 
-    std::unique_ptr<cppexpose::ScriptContext> m_scriptContext;    ///< Scripting context
+    std::unique_ptr<cppexpose::ScriptContext> m_scriptContext;      ///< Scripting context
 
-    std::string                               m_helpText;         ///< Text that is displayed on 'help'
-    bool                                      m_safeMode;         ///< If 'true', settings are not loaded from file but reset to default values
+    std::string                               m_helpText;           ///< Text that is displayed on 'help'
+    bool                                      m_safeMode;           ///< If 'true', settings are not loaded from file but reset to default values
+    ThreadPool                                m_threadPool;         ///< Worker threads for parallel tasks (destroyed first)
 };
 
 
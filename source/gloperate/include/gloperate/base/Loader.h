@@ -56,6 +56,30 @@ public:
     *    Loaded resource (can be null)
     */
     virtual T * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const = 0;
+
+    /**
+    *  @brief
+    *    Prepare loading resource from file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading resource, see documentation of specific loader for supported options
+    *  @param[in] progress
+    *    Callback function that is invoked on progress (can be empty)
+    *
+    *  @return
+    *    Function that creates the resource (can be empty if loading has failed)
+    *
+    *  @remarks
+    *    This function is called on a worker thread without an OpenGL context
+    *    and should read and decode the file. The returned function is called
+    *    later on a thread with an active OpenGL context and should only create
+    *    the OpenGL objects. The returned resource is owned by the caller.
+    *
+    *    The default implementation defers the entire loading to the returned function.
+    */
+    virtual std::function<T * ()> prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const;
 };
 
 
@@ -2,6 +2,9 @@
 #pragma once
 
 
+#include <cppexpose/variant/Variant.h>
+
+
 namespace gloperate
 {
 
@@ -17,5 +20,15 @@ Loader<T>::~Loader()
 {
 }
 
+template <typename T>
+std::function<T * ()> Loader<T>::prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    // Loaders may create OpenGL objects at any time, so the whole loading has to be deferred
+    return [this, filename, options, progress] ()
+    {
+        return load(filename, options, progress);
+    };
+}
+
 
 } // namespace gloperate
@@ -0,0 +1,108 @@
+
+#pragma once
+
+
+#include <string>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Read-only memory mapping of a file
+*
+*    The content of the file is paged in by the operating system when it is
+*    accessed, so only the parts of a file that are actually used are read.
+*/
+class GLOPERATE_API MappedFile
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    MappedFile();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~MappedFile();
+
+    // No copying
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /**
+    *  @brief
+    *    Map file into memory
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    'true' if the file has been mapped, else 'false' (e.g., if it does not exist or is empty)
+    */
+    bool open(const std::string & filename);
+
+    /**
+    *  @brief
+    *    Unmap file
+    */
+    void close();
+
+    /**
+    *  @brief
+    *    Check if a file is mapped
+    *
+    *  @return
+    *    'true' if a file is mapped, else 'false'
+    */
+    bool isOpen() const;
+
+    /**
+    *  @brief
+    *    Get mapped data
+    *
+    *  @return
+    *    Pointer to the content of the file (null if no file is mapped)
+    */
+    const char * data() const;
+
+    /**
+    *  @brief
+    *    Get size of the mapped file
+    *
+    *  @return
+    *    Size of the file (in bytes)
+    */
+    size_t size() const;
+
+    /**
+    *  @brief
+    *    Advise the operating system to read a range of the file ahead
+    *
+    *  @param[in] offset
+    *    Offset of the range (in bytes)
+    *  @param[in] size
+    *    Size of the range (in bytes)
+    *
+    *  @remarks
+    *    This is only a hint and returns immediately.
+    */
+    void prefetch(size_t offset, size_t size) const;
+
+
+protected:
+    const char * m_data;    ///< Mapped data (null if no file is mapped)
+    size_t       m_size;    ///< Size of the mapped file
+    void       * m_file;    ///< File handle (Windows only)
+    void       * m_mapping; ///< File mapping handle (Windows only)
+};
+
+
+} // namespace gloperate
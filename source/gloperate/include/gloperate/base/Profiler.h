@@ -0,0 +1,197 @@
+
+#pragma once
+
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <thread>
+#include <iosfwd>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Collector of CPU and GPU time spans of all pipelines and stages
+*
+*    While the profiler is enabled, each stage that is processed adds a CPU
+*    span for its onProcess() call and, if it uses OpenGL, a GPU span for the
+*    commands it has issued (see Stage::process()). As pipelines are stages
+*    themselves, their spans enclose the spans of their stages. GPU spans
+*    arrive a few frames late, as GPU timer queries are only read once their
+*    results are available.
+*
+*    The spans can be exported in the Chrome trace event format, which can
+*    be viewed with chrome://tracing or other trace viewers. Only the most
+*    recent spans are kept, so the profiler can stay enabled indefinitely.
+*/
+class GLOPERATE_API Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+    *  @brief
+    *    Time span
+    */
+    struct Span
+    {
+        std::string   name;   ///< Name of the span (e.g., qualified name of the stage)
+        std::uint64_t begin;  ///< Begin (in nanoseconds since the creation of the profiler)
+        std::uint64_t end;    ///< End (in nanoseconds since the creation of the profiler)
+        unsigned int  thread; ///< Index of the CPU thread, 0 for GPU spans
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] maxSpans
+    *    Maximum number of spans that are kept
+    */
+    Profiler(size_t maxSpans = 100000);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~Profiler();
+
+    // No copying
+    Profiler(const Profiler &) = delete;
+    Profiler & operator=(const Profiler &) = delete;
+
+    /**
+    *  @brief
+    *    Check if profiling is enabled
+    *
+    *  @return
+    *    'true' if spans are recorded, else 'false'
+    */
+    bool isEnabled() const;
+
+    /**
+    *  @brief
+    *    Enable or disable profiling
+    *
+    *  @param[in] enabled
+    *    'true' if spans are recorded, else 'false'
+    */
+    void setEnabled(bool enabled);
+
+    /**
+    *  @brief
+    *    Convert point in time to profiler time
+    *
+    *  @param[in] time
+    *    Point in time
+    *
+    *  @return
+    *    Nanoseconds since the creation of the profiler
+    */
+    std::uint64_t time(Clock::time_point time) const;
+
+    /**
+    *  @brief
+    *    Add span that has been executed by the calling thread
+    *
+    *  @param[in] name
+    *    Name of the span
+    *  @param[in] begin
+    *    Begin (profiler time, see time())
+    *  @param[in] end
+    *    End (profiler time, see time())
+    */
+    void addCPUSpan(const std::string & name, std::uint64_t begin, std::uint64_t end);
+
+    /**
+    *  @brief
+    *    Add span that has been executed by the GPU
+    *
+    *  @param[in] name
+    *    Name of the span
+    *  @param[in] begin
+    *    GPU timestamp of the begin (in nanoseconds, e.g., from a GL_TIMESTAMP query)
+    *  @param[in] end
+    *    GPU timestamp of the end (in nanoseconds, e.g., from a GL_TIMESTAMP query)
+    *
+    *  @remarks
+    *    Must be called with a current OpenGL context, which is used to
+    *    relate GPU timestamps to profiler time from time to time.
+    */
+    void addGPUSpan(const std::string & name, std::uint64_t begin, std::uint64_t end);
+
+    /**
+    *  @brief
+    *    Get recorded spans
+    *
+    *  @return
+    *    Spans, in the order in which they have been added
+    */
+    std::vector<Span> spans() const;
+
+    /**
+    *  @brief
+    *    Remove all recorded spans
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Write recorded spans in Chrome trace event format
+    *
+    *  @param[in] stream
+    *    Output stream
+    */
+    void writeTrace(std::ostream & stream) const;
+
+    /**
+    *  @brief
+    *    Write recorded spans in Chrome trace event format to a file
+    *
+    *  @param[in] filename
+    *    Name of the JSON file
+    *
+    *  @return
+    *    'true' if the file has been written, else 'false'
+    */
+    bool exportTrace(const std::string & filename) const;
+
+
+protected:
+    /**
+    *  @brief
+    *    Add span (lock must be held)
+    *
+    *  @param[in] span
+    *    Span
+    */
+    void addSpan(Span && span);
+
+
+protected:
+    const size_t                                          m_maxSpans;        ///< Maximum number of spans that are kept
+    const Clock::time_point                               m_epoch;           ///< Creation time of the profiler
+    std::atomic<bool>                                     m_enabled;         ///< Are spans recorded?
+    mutable std::mutex                                    m_mutex;           ///< Mutex for spans and threads, as stages may be processed in parallel
+    std::deque<Span>                                      m_spans;           ///< Recorded spans, oldest first
+    std::unordered_map<std::thread::id, unsigned int>     m_threads;         ///< Index of each CPU thread that has added spans
+    bool                                                  m_calibrated;      ///< Has the GPU clock been related to the profiler time?
+    std::int64_t                                          m_gpuOffset;       ///< Profiler time minus GPU time (in nanoseconds)
+    std::uint64_t                                         m_calibrationTime; ///< Profiler time of the last calibration
+};
+
+
+} // namespace gloperate
@@ -5,11 +5,15 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
 
 #include <cppexpose/reflection/Object.h>
 #include <cppexpose/variant/Variant.h>
 
 #include <gloperate/gloperate_api.h>
+#include <gloperate/base/ResourceRequest.h>
 
 
 namespace gloperate
@@ -17,13 +21,19 @@ namespace gloperate
 
 
 class Environment;
+class ThreadPool;
 class AbstractLoader;
 class AbstractStorer;
+template <typename T>
+class Loader;
 
 
 /**
 *  @brief
 *    Class to help loading/accessing resources (textures, ...)
+*
+*    The loader for a resource type and file extension is looked up once
+*    and then remembered, until the available components are updated.
 */
 class GLOPERATE_API ResourceManager : public cppexpose::Object
 {
@@ -80,6 +90,28 @@ public:
     template <typename T>
     T * load(const std::string & filename, const cppexpose::Variant & options = cppexpose::Variant(), std::function<void(int, int)> progress = std::function<void(int, int)>()) const;
 
+    /**
+    *  @brief
+    *    Load resource from file asynchronously
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] options
+    *    Options for loading resource, see documentation of specific loader for supported options
+    *  @param[in] progress
+    *    Callback function that is invoked on progress from a worker thread, or from the thread calling ResourceRequest::get() (can be empty)
+    *
+    *  @return
+    *    Request for the resource (invalid if no suitable loader has been found)
+    *
+    *  @remarks
+    *    The file is read and decoded on the thread pool of the environment.
+    *    The resource is created when ResourceRequest::get() is called, which
+    *    must happen on a thread with an active OpenGL context for OpenGL resources.
+    */
+    template <typename T>
+    ResourceRequest<T> loadAsync(const std::string & filename, const cppexpose::Variant & options = cppexpose::Variant(), std::function<void(int, int)> progress = std::function<void(int, int)>()) const;
+
     /**
     *  @brief
     *    Store resource to file
@@ -103,7 +135,44 @@ public:
 protected:
     /**
     *  @brief
-    *    Update list of available loaders and storers
+    *    Find loader for a file
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    Loader for resources of type T that can load the file, null if there is none
+    */
+    template <typename T>
+    Loader<T> * findLoader(const std::string & filename) const;
+
+    /**
+    *  @brief
+    *    Get file extension
+    *
+    *  @param[in] filename
+    *    File name
+    *
+    *  @return
+    *    File extension without leading dot
+    */
+    static std::string extension(const std::string & filename);
+
+    /**
+    *  @brief
+    *    Get thread pool for loading resources
+    *
+    *  @return
+    *    Thread pool of the environment (never null)
+    */
+    ThreadPool * threadPool() const;
+
+    /**
+    *  @brief
+    *    Create loaders and storers if there are none yet
+    *
+    *  @remarks
+    *    Existing loaders are kept, as asynchronous requests may still use them.
     */
     void updateComponents() const;
 
@@ -118,6 +187,8 @@ protected:
     Environment                                        * m_environment; ///< Gloperate environment (must NOT be null!)
     mutable std::vector<std::unique_ptr<AbstractLoader>> m_loaders;     ///< Available loaders
     mutable std::vector<std::unique_ptr<AbstractStorer>> m_storers;     ///< Available storers
+    mutable std::unordered_map<std::type_index, std::unordered_map<std::string, AbstractLoader *>> m_loaderIndex; ///< Loader by resource type and file extension (null if there is none)
+    mutable std::mutex                                   m_mutex;       ///< Protects the components, as resources may be loaded from any thread
 };
 
 
@@ -2,6 +2,9 @@
 #pragma once
 
 
+#include <memory>
+#include <future>
+
 #include <cppassist/fs/FilePath.h>
 
 #include <gloperate/base/Loader.h>
@@ -18,62 +21,110 @@ namespace gloperate
 template <typename T>
 T * ResourceManager::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
 {
-    // Lazy initialization of loaders
-    if (m_loaders.size() == 0) {
-        updateComponents();
+    // Find suitable loader
+    auto loader = findLoader<T>(filename);
+    if (!loader) {
+        return nullptr;
     }
 
+    // Use loader
+    return loader->load(filename, options, progress);
+}
+
+template <typename T>
+ResourceRequest<T> ResourceManager::loadAsync(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    // Find suitable loader
+    auto loader = findLoader<T>(filename);
+    if (!loader) {
+        return ResourceRequest<T>();
+    }
+
+    // Read and decode file on a worker thread
+    auto task = std::make_shared<std::packaged_task<std::function<T * ()> ()>>([loader, filename, options, progress] ()
+    {
+        return loader->prepare(filename, options, progress);
+    });
+
+    ResourceRequest<T> request(task->get_future(), threadPool());
+
+    threadPool()->schedule([task] ()
+    {
+        (*task)();
+    });
+
+    return request;
+}
+
+template <typename T>
+bool ResourceManager::store(const std::string & filename, T * resource, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
     // Get file extension
     std::string ext = FilePath(filename).extension();
-    auto pos = ext.find_last_of('.');
-    if (pos != std::string::npos)
+
+    // Find suitable storer
+    Storer<T> * suitableStorer = nullptr;
+
     {
-        ext = ext.substr(pos + 1);
-    }
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Find suitable loader
-    for (const auto & loader : m_loaders) {
-        // Check loader type
-        Loader<T> * concreteLoader = dynamic_cast<Loader<T> *>(loader.get());
-        if (concreteLoader) {
-            // Check if filetype is supported
-            if (concreteLoader->canLoad(ext)) {
-                // Use loader
-                return concreteLoader->load(filename, options, progress);
+        // Lazy initialization of storers
+        if (m_storers.size() == 0) {
+            updateComponents();
+        }
+
+        for (const auto & storer : m_storers) {
+            // Check storer type and if filetype is supported
+            Storer<T> * concreteStorer = dynamic_cast<Storer<T> *>(storer.get());
+            if (concreteStorer && concreteStorer->canStore(ext)) {
+                suitableStorer = concreteStorer;
+                break;
             }
         }
     }
 
-    // No suitable loader found
-    return nullptr;
+    // No suitable storer found
+    if (!suitableStorer) {
+        return false;
+    }
+
+    // Use storer
+    return suitableStorer->store(filename, resource, options, progress);
 }
 
 template <typename T>
-bool ResourceManager::store(const std::string & filename, T * resource, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+Loader<T> * ResourceManager::findLoader(const std::string & filename) const
 {
-    // Lazy initialization of storers
-    if (m_storers.size() == 0) {
+    const auto ext = extension(filename);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Lazy initialization of loaders
+    if (m_loaders.size() == 0) {
         updateComponents();
     }
 
-    // Get file extension
-    std::string ext = FilePath(filename).extension();
+    // Look up loader in the index
+    auto & loaders = m_loaderIndex[std::type_index(typeid(T))];
 
-    // Find suitable storer
-    for (const auto & storer : m_storers) {
-        // Check storer type
-        Storer<T> * concreteStorer = dynamic_cast<Storer<T> *>(storer.get());
-        if (concreteStorer) {
-            // Check if filetype is supported
-            if (concreteStorer->canStore(ext)) {
-                // Use store
-                return concreteStorer->store(filename, resource, options, progress);
+    auto it = loaders.find(ext);
+    if (it == loaders.end()) {
+        // Find suitable loader
+        Loader<T> * suitableLoader = nullptr;
+
+        for (const auto & loader : m_loaders) {
+            // Check loader type and if filetype is supported
+            Loader<T> * concreteLoader = dynamic_cast<Loader<T> *>(loader.get());
+            if (concreteLoader && concreteLoader->canLoad(ext)) {
+                suitableLoader = concreteLoader;
+                break;
             }
         }
+
+        it = loaders.emplace(ext, suitableLoader).first;
     }
 
-    // No suitable loader found
-    return false;
+    return static_cast<Loader<T> *>(it->second);
 }
 
 
@@ -0,0 +1,131 @@
+
+#pragma once
+
+
+#include <memory>
+#include <future>
+#include <functional>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+class ThreadPool;
+
+
+/**
+*  @brief
+*    Handle to a resource that is loaded asynchronously
+*
+*    The file is read and decoded by a worker thread of the environment's
+*    thread pool. The final step that creates the resource, e.g., uploading
+*    a texture, is executed by get() on the calling thread, which must
+*    therefore have an active OpenGL context for OpenGL resources.
+*
+*  @see
+*    ResourceManager::loadAsync()
+*/
+template <typename T>
+class GLOPERATE_TEMPLATE_API ResourceRequest
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *    Creates an invalid request.
+    */
+    ResourceRequest();
+
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] prepared
+    *    Future of the function that creates the resource
+    *  @param[in] threadPool
+    *    Thread pool that prepares the resource (must NOT be null!)
+    */
+    ResourceRequest(std::future<std::function<T * ()>> && prepared, ThreadPool * threadPool);
+
+    /**
+    *  @brief
+    *    Move constructor
+    *
+    *  @param[in] other
+    *    Request that is moved from
+    */
+    ResourceRequest(ResourceRequest && other);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    If the resource has not been taken, the prepared data is
+    *    discarded as soon as the worker thread has finished.
+    */
+    ~ResourceRequest();
+
+    /**
+    *  @brief
+    *    Move assignment operator
+    *
+    *  @param[in] other
+    *    Request that is moved from
+    *
+    *  @return
+    *    Reference to this request
+    */
+    ResourceRequest & operator=(ResourceRequest && other);
+
+    // No copying
+    ResourceRequest(const ResourceRequest &) = delete;
+    ResourceRequest & operator=(const ResourceRequest &) = delete;
+
+    /**
+    *  @brief
+    *    Check if the request refers to a resource
+    *
+    *  @return
+    *    'true' if a loader has been found and the resource has not been taken yet, else 'false'
+    */
+    bool valid() const;
+
+    /**
+    *  @brief
+    *    Check if the resource has been prepared
+    *
+    *  @return
+    *    'true' if get() will not block, else 'false'
+    */
+    bool isReady() const;
+
+    /**
+    *  @brief
+    *    Take resource
+    *
+    *  @return
+    *    Loaded resource (can be null)
+    *
+    *  @remarks
+    *    Waits until the resource has been prepared, while executing pending
+    *    tasks of the thread pool, and then creates the resource on the calling
+    *    thread. Afterwards, the request is invalid.
+    */
+    std::unique_ptr<T> get();
+
+
+protected:
+    std::future<std::function<T * ()>>   m_prepared;   ///< Function that creates the resource, set by the worker thread
+    ThreadPool                         * m_threadPool; ///< Thread pool that prepares the resource (can be null for invalid requests)
+};
+
+
+} // namespace gloperate
+
+
+#include <gloperate/base/ResourceRequest.inl>
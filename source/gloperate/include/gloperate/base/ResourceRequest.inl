@@ -0,0 +1,84 @@
+
+#pragma once
+
+
+#include <chrono>
+
+#include <gloperate/base/ThreadPool.h>
+
+
+namespace gloperate
+{
+
+
+template <typename T>
+ResourceRequest<T>::ResourceRequest()
+: m_threadPool(nullptr)
+{
+}
+
+template <typename T>
+ResourceRequest<T>::ResourceRequest(std::future<std::function<T * ()>> && prepared, ThreadPool * threadPool)
+: m_prepared(std::move(prepared))
+, m_threadPool(threadPool)
+{
+}
+
+template <typename T>
+ResourceRequest<T>::ResourceRequest(ResourceRequest && other)
+: m_prepared(std::move(other.m_prepared))
+, m_threadPool(other.m_threadPool)
+{
+}
+
+template <typename T>
+ResourceRequest<T>::~ResourceRequest()
+{
+}
+
+template <typename T>
+ResourceRequest<T> & ResourceRequest<T>::operator=(ResourceRequest && other)
+{
+    m_prepared   = std::move(other.m_prepared);
+    m_threadPool = other.m_threadPool;
+
+    return *this;
+}
+
+template <typename T>
+bool ResourceRequest<T>::valid() const
+{
+    return m_prepared.valid();
+}
+
+template <typename T>
+bool ResourceRequest<T>::isReady() const
+{
+    return !m_prepared.valid() || m_prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+template <typename T>
+std::unique_ptr<T> ResourceRequest<T>::get()
+{
+    if (!m_prepared.valid())
+    {
+        return nullptr;
+    }
+
+    // Help the thread pool instead of blocking
+    while (!isReady())
+    {
+        if (!m_threadPool->executePending())
+        {
+            m_prepared.wait_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Create resource on the calling thread
+    const auto create = m_prepared.get();
+
+    return std::unique_ptr<T>(create ? create() : nullptr);
+}
+
+
+} // namespace gloperate
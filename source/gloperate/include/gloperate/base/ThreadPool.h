@@ -0,0 +1,168 @@
+
+#pragma once
+
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Pool of worker threads with work stealing
+*
+*    Each worker thread has its own task queue. Tasks that are scheduled from
+*    within a worker thread are put into the queue of that worker and are
+*    executed in LIFO order, while idle workers steal the oldest tasks from
+*    the queues of other workers. Tasks that are scheduled from outside the
+*    pool are distributed over the queues round-robin.
+*
+*    The worker threads are started lazily when the first task is scheduled.
+*/
+class GLOPERATE_API ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] numThreads
+    *    Number of worker threads (if 0, the number of hardware threads minus one is used)
+    */
+    ThreadPool(unsigned int numThreads = 0);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Executes all pending tasks before the worker threads are joined.
+    */
+    ~ThreadPool();
+
+    // No copying
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    /**
+    *  @brief
+    *    Get number of worker threads
+    *
+    *  @return
+    *    Number of worker threads
+    */
+    unsigned int numThreads() const;
+
+    /**
+    *  @brief
+    *    Schedule task for execution on a worker thread
+    *
+    *  @param[in] task
+    *    Task (must NOT be empty!)
+    */
+    void schedule(Task task);
+
+    /**
+    *  @brief
+    *    Execute one pending task on the calling thread
+    *
+    *  @return
+    *    'true' if a task has been executed, 'false' if there was no pending task
+    *
+    *  @remarks
+    *    This can be used to help the pool while waiting for the completion of tasks.
+    *    The executed task is the next one in the queue, which is not necessarily
+    *    one of the tasks being waited for.
+    */
+    bool executePending();
+
+    /**
+    *  @brief
+    *    Execute a function on ranges of indices in parallel
+    *
+    *  @param[in] count
+    *    Number of indices
+    *  @param[in] func
+    *    Function that is called for each range [begin, end)
+    *  @param[in] grainSize
+    *    Minimum number of indices per range
+    *
+    *  @remarks
+    *    The calling thread takes part in the execution and
+    *    the function returns when all ranges have been processed.
+    */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)> & func, size_t grainSize = 1);
+
+
+protected:
+    /**
+    *  @brief
+    *    Task queue of a worker
+    */
+    struct Queue
+    {
+        std::deque<Task> tasks; ///< Pending tasks
+        std::mutex       mutex; ///< Mutex for accessing the tasks
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Start worker threads
+    */
+    void start();
+
+    /**
+    *  @brief
+    *    Main loop of a worker thread
+    *
+    *  @param[in] index
+    *    Index of the worker
+    */
+    void run(unsigned int index);
+
+    /**
+    *  @brief
+    *    Take a task from the own queue or steal one from another queue
+    *
+    *  @param[in] index
+    *    Index of the own queue (can be m_numThreads for no own queue)
+    *  @param[out] task
+    *    Task
+    *
+    *  @return
+    *    'true' if a task has been found, else 'false'
+    */
+    bool takeTask(unsigned int index, Task & task);
+
+
+protected:
+    unsigned int                        m_numThreads; ///< Number of worker threads
+    std::vector<std::unique_ptr<Queue>> m_queues;     ///< One task queue per worker
+    std::vector<std::thread>            m_threads;    ///< Worker threads
+    std::once_flag                      m_started;    ///< Flag for starting the worker threads once
+    std::mutex                          m_mutex;      ///< Mutex for the wakeup condition
+    std::condition_variable             m_condition;  ///< Condition for waking up idle workers
+    std::atomic<size_t>                 m_pending;    ///< Number of tasks in all queues
+    std::atomic<unsigned int>           m_nextQueue;  ///< Queue for the next task scheduled from outside the pool
+    bool                                m_stop;       ///< Shall the workers stop?
+};
+
+
+} // namespace gloperate
@@ -3,6 +3,9 @@
 
 
 #include <map>
+#include <queue>
+#include <vector>
+#include <functional>
 
 #include <cppexpose/reflection/Object.h>
 
@@ -19,6 +22,10 @@ class Environment;
 /**
 *  @brief
 *    Manager for scripting timers
+*
+*    Timers are ordered by their deadlines in a min-heap, so an update
+*    only touches the timers that elapse. Timers that have been stopped
+*    are deleted after all callbacks of the current update have returned.
 */
 class GLOPERATE_API TimerManager : public cppexpose::Object
 {
@@ -28,14 +35,14 @@ public:
         bool                active;     ///< 'true' if timer is active, else 'false'
         bool                singleShot; ///< 'true' if timer fires only once, else 'false'
         float               interval;   ///< Interval (in seconds)
-        float               remaining;  ///< Remaining time (in seconds)
+        double              deadline;   ///< Time at which the timer elapses (in seconds, see TimerManager::m_time)
         cppexpose::Function func;       ///< Script function which is called
 
         Timer()
         : active(false)
         , singleShot(false)
         , interval(0.0f)
-        , remaining(0.0f)
+        , deadline(0.0)
         {
         }
 
@@ -89,6 +96,18 @@ public:
     */
     void update(float delta);
 
+    /**
+    *  @brief
+    *    Get time until the next timer elapses
+    *
+    *  @return
+    *    Time until the next active timer elapses (in seconds), negative if no timer is active
+    *
+    *  @remarks
+    *    This can be used by the main loop to sleep until the next call to update() is required.
+    */
+    float remainingTime() const;
+
 
 protected:
     // Scripting functions
@@ -100,15 +119,39 @@ protected:
 
     // Helper functions
     int  startTimer(const cppexpose::Variant & func, int msec, bool singleShot);
-    void stopTimer(Timer * timer);
-    void updateTimer(Timer * timer, float delta);
+    void stopTimer(int id, Timer * timer);
+    void schedule(int id, Timer * timer);
+    void removeStaleDeadlines();
+    void deleteStoppedTimers();
+
+
+protected:
+    /**
+    *  @brief
+    *    Entry of the deadline heap
+    */
+    struct Deadline
+    {
+        double time; ///< Time at which the timer elapses (in seconds)
+        int    id;   ///< Timer ID
+
+        bool operator>(const Deadline & other) const
+        {
+            // Timers with equal deadlines fire in the order they have been started
+            return time > other.time || (time == other.time && id > other.id);
+        }
+    };
 
 
 protected:
-    Environment                         * m_environment; ///< Gloperate environment to which the manager belongs
-    std::map<int, std::unique_ptr<Timer>> m_timers;      ///< List of activated timers
-    int                                   m_nextId;      ///< Next timer ID
-    gloperate::ChronoTimer                m_clock;       ///< Time measurement
+    Environment                                                                 * m_environment; ///< Gloperate environment to which the manager belongs
+    std::map<int, std::unique_ptr<Timer>>                                         m_timers;      ///< List of timers that have not been deleted yet
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>  m_deadlines;   ///< Deadlines of active timers, the top is always an active timer
+    std::vector<int>                                                              m_stopped;     ///< Timers that are deleted after the current update
+    int                                                                           m_nextId;      ///< Next timer ID
+    double                                                                        m_time;        ///< Time since the creation of the manager, advanced by update() (in seconds)
+    bool                                                                          m_updating;    ///< 'true' while timer callbacks are being called, else 'false'
+    gloperate::ChronoTimer                                                        m_clock;       ///< Time measurement
 };
 
 
@@ -63,6 +63,15 @@ public:
     */
     Type type() const;
 
+    /**
+    *  @brief
+    *    Get device that generated the event
+    *
+    *  @return
+    *    Dispatching device (never null)
+    */
+    AbstractDevice * dispatchingDevice() const;
+
     /**
     *  @brief
     *    Get event description as string
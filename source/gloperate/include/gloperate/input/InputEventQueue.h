@@ -0,0 +1,92 @@
+
+#pragma once
+
+
+#include <memory>
+
+#include <gloperate/gloperate_api.h>
+#include <gloperate/base/BoundedQueue.h>
+
+
+namespace gloperate
+{
+
+
+class InputEvent;
+
+
+/**
+*  @brief
+*    Bounded multi-producer single-consumer queue for input events
+*
+*    Events can be pushed from any number of threads without locking,
+*    while only one thread at a time is allowed to pop events. If the
+*    queue is full, new events are rejected instead of growing the queue.
+*
+*    This is a BoundedQueue of event pointers that owns the queued events.
+*/
+class GLOPERATE_API InputEventQueue
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Maximum number of queued events (rounded up to the next power of two)
+    */
+    InputEventQueue(size_t capacity);
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~InputEventQueue();
+
+    // No copying
+    InputEventQueue(const InputEventQueue &) = delete;
+    InputEventQueue & operator=(const InputEventQueue &) = delete;
+
+    /**
+    *  @brief
+    *    Get capacity
+    *
+    *  @return
+    *    Maximum number of queued events
+    */
+    size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Push event into the queue
+    *
+    *  @param[in] event
+    *    Input event (must NOT be null!)
+    *
+    *  @return
+    *    'true' if the event has been queued, 'false' if the queue is full and the event has been discarded
+    *
+    *  @remarks
+    *    This function can be called from any thread.
+    */
+    bool push(std::unique_ptr<InputEvent> && event);
+
+    /**
+    *  @brief
+    *    Take the oldest event from the queue
+    *
+    *  @return
+    *    Input event, null if the queue is empty
+    *
+    *  @remarks
+    *    This function must only be called from one thread at a time.
+    */
+    std::unique_ptr<InputEvent> pop();
+
+
+protected:
+    BoundedQueue<InputEvent *> m_events; ///< Queued events (owned by the queue)
+};
+
+
+} // namespace gloperate
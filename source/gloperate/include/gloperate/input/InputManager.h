@@ -3,11 +3,15 @@
 
 
 #include <list>
+#include <deque>
 #include <memory>
+#include <atomic>
+#include <mutex>
 
 #include <cppexpose/reflection/Object.h>
 
 #include <gloperate/gloperate_api.h>
+#include <gloperate/input/InputEventQueue.h>
 
 
 namespace gloperate
@@ -24,6 +28,13 @@ class InputEvent;
 /**
 *  @brief
 *    Manager for input device and consumers
+*
+*    Devices can generate events on any thread. The events are put into
+*    a bounded queue and dispatched to the consumers when processEvents()
+*    is called, which is usually done once per frame on the render thread.
+*    Consecutive mouse move events of the same device are merged, and
+*    events are dropped if the queue is full. The most recent dispatched
+*    events are kept in a history of configurable size.
 */
 class GLOPERATE_API InputManager : public cppexpose::Object
 {
@@ -34,8 +45,10 @@ public:
     *
     *  @param[in] environment
     *    Environment to which the manager belongs (must NOT be null!)
+    *  @param[in] queueCapacity
+    *    Maximum number of events that are queued between two calls of processEvents()
     */
-    InputManager(Environment * environment);
+    InputManager(Environment * environment, size_t queueCapacity = 1024);
 
     /**
     *  @brief
@@ -72,20 +85,83 @@ public:
 
     /**
     *  @brief
-    *    Forwards an Event to all registered Consumers
+    *    Queue an event for all registered consumers
     *
     *  @param event
-    *    The Event to forward
+    *    The event to forward
+    *
+    *  @remarks
+    *    This function can be called from any thread. The event
+    *    is dispatched on the next call of processEvents().
     */
     void onEvent(std::unique_ptr<InputEvent> && event);
 
+    /**
+    *  @brief
+    *    Dispatch queued events to all registered consumers
+    *
+    *  @remarks
+    *    If another thread is already processing events, this function returns immediately.
+    */
+    void processEvents();
+
+    /**
+    *  @brief
+    *    Get history of dispatched events
+    *
+    *  @return
+    *    The most recent dispatched events, oldest first
+    */
+    const std::deque<std::unique_ptr<InputEvent>> & history() const;
+
+    /**
+    *  @brief
+    *    Get maximum number of events in the history
+    *
+    *  @return
+    *    Size of the history window
+    */
+    size_t historySize() const;
+
+    /**
+    *  @brief
+    *    Set maximum number of events in the history
+    *
+    *  @param[in] size
+    *    Size of the history window (0 to disable the history)
+    */
+    void setHistorySize(size_t size);
+
+    /**
+    *  @brief
+    *    Get number of events dropped, because the queue was full
+    *
+    *  @return
+    *    Number of dropped events
+    */
+    size_t droppedEvents() const;
+
+    /**
+    *  @brief
+    *    Get number of events merged into subsequent events
+    *
+    *  @return
+    *    Number of coalesced events
+    */
+    size_t coalescedEvents() const;
+
 
 protected:
-    Environment                                      * m_environment; ///< Gloperate environment to which the manager belongs
+    Environment                                      * m_environment;     ///< Gloperate environment to which the manager belongs
     std::list<AbstractEventConsumer *>                 m_consumers;
     std::list<std::unique_ptr<AbstractDeviceProvider>> m_deviceProviders;
     std::list<AbstractDevice *>                        m_devices;
-    std::list<std::unique_ptr<InputEvent>>             m_events;
+    InputEventQueue                                    m_queue;           ///< Events waiting to be dispatched
+    std::mutex                                         m_processMutex;    ///< Makes sure that only one thread takes events from the queue
+    std::deque<std::unique_ptr<InputEvent>>            m_history;         ///< Most recent dispatched events
+    size_t                                             m_historySize;     ///< Maximum number of events in the history
+    std::atomic<size_t>                                m_droppedEvents;   ///< Number of events dropped because the queue was full
+    size_t                                             m_coalescedEvents; ///< Number of events merged into subsequent events
 };
 
 
@@ -62,6 +62,7 @@ public:
 
     // Virtual gloperate::Loader<globjects::Texture> functions
     virtual ColorGradientList * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<ColorGradientList * ()> prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
 
 
 protected:
@@ -7,6 +7,8 @@
 
 #include <cppexpose/plugin/plugin_api.h>
 
+#include <glbinding/gl/types.h>
+
 #include <gloperate/gloperate-version.h>
 #include <gloperate/base/Loader.h>
 
@@ -24,6 +26,16 @@ namespace gloperate
 /**
 *  @brief
 *    File loader for '.raw' files
+*
+*    Files are mapped into memory by default, so only the part of the file
+*    that is uploaded is read, and it is uploaded in tiles of rows, which
+*    are reported to the progress callback.
+*
+*  Supported options:
+*    "mapped" (bool):   Map the file into memory, else only the required part is read (default: true)
+*    "x", "y" (int):    Offset of the region to load (default: 0, uncompressed images only)
+*    "width" (int):     Width of the region to load (default: rest of the image, uncompressed images only)
+*    "height" (int):    Height of the region to load (default: rest of the image, uncompressed images only)
 */
 class GLOPERATE_API GlrawTextureLoader : public gloperate::Loader<globjects::Texture>
 {
@@ -62,32 +74,122 @@ public:
 
     // Virtual gloperate::Loader<globjects::Texture> functions
     virtual globjects::Texture * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<globjects::Texture * ()> prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
 
 
 protected:
     /**
     *  @brief
-    *    Create Texture from .glraw file
+    *    Layout of the image data in a file
+    */
+    struct ImageLayout
+    {
+        int        width;          ///< Width of the image
+        int        height;         ///< Height of the image
+        bool       compressed;     ///< Is the image compressed?
+        gl::GLenum format;         ///< Pixel format, or internal format if the image is compressed
+        gl::GLenum type;           ///< Pixel type (uncompressed images only)
+        gl::GLenum internalFormat; ///< Internal format of the texture, GL_NONE if the pixel format is not supported
+        bool       complete;       ///< Is the size of a pixel unknown, so the image can only be uploaded at once?
+        size_t     offset;         ///< Offset of the image data in the file (in bytes)
+        size_t     size;           ///< Size of the image data (in bytes, 0 for the rest of the file if complete is set)
+    };
+
+    /**
+    *  @brief
+    *    Region of an image
+    */
+    struct Region
+    {
+        int x;      ///< Horizontal offset
+        int y;      ///< Vertical offset
+        int width;  ///< Width of the region
+        int height; ///< Height of the region
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Read layout from the header of a .glraw file
     *
-    *  @param[in] filename
-    *    path of the .glraw file
+    *  @param[in] header
+    *    Beginning of the file
+    *  @param[in] size
+    *    Number of available bytes
+    *  @param[out] layout
+    *    Image layout
     *
     *  @return
-    *    Loaded texture, null on error
+    *    'true' if the header is valid and complete, else 'false'
     */
-    globjects::Texture * loadGLRawImage(const std::string & filename) const;
+    static bool readGLRawHeader(const char * header, size_t size, ImageLayout & layout);
 
     /**
     *  @brief
-    *    Create Texture from .raw file
+    *    Read layout from the name of a .raw file
     *
     *  @param[in] filename
     *    path of the .raw file
+    *  @param[in] fileSize
+    *    Size of the file (in bytes)
+    *  @param[out] layout
+    *    Image layout
+    *
+    *  @return
+    *    'true' if the file name is valid, else 'false'
+    */
+    static bool readRawFileName(const std::string & filename, size_t fileSize, ImageLayout & layout);
+
+    /**
+    *  @brief
+    *    Check if a texture can be created for the pixel format of an image
+    *
+    *  @param[in] layout
+    *    Image layout
+    *
+    *  @return
+    *    'true' if the format is supported, else 'false'
+    */
+    static bool isSupported(const ImageLayout & layout);
+
+    /**
+    *  @brief
+    *    Determine region to load and the part of the file it covers
+    *
+    *  @param[in] options
+    *    Loading options
+    *  @param[in] layout
+    *    Image layout
+    *  @param[out] region
+    *    Region of the image
+    *  @param[out] first
+    *    Offset of the first byte of the region in the file
+    *  @param[out] count
+    *    Number of bytes from the first to the last byte of the region
+    *
+    *  @return
+    *    'true' if the region is not empty, else 'false'
+    */
+    static bool selectRegion(const cppexpose::Variant & options, const ImageLayout & layout, Region & region, size_t & first, size_t & count);
+
+    /**
+    *  @brief
+    *    Create texture from image data
+    *
+    *  @param[in] data
+    *    Image data, starting with the first row of the region (must NOT be null!)
+    *  @param[in] layout
+    *    Image layout
+    *  @param[in] region
+    *    Region of the image
+    *  @param[in] progress
+    *    Callback function that is invoked after each tile (can be empty)
     *
     *  @return
-    *    Loaded texture, null on error
+    *    Texture
     */
-    globjects::Texture * loadRawImage(const std::string & filename) const;
+    static globjects::Texture * upload(const char * data, const ImageLayout & layout, const Region & region, const std::function<void(int, int)> & progress);
 
 
 protected:
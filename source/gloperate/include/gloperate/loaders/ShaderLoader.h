@@ -4,6 +4,8 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include <cppexpose/plugin/plugin_api.h>
@@ -17,6 +19,7 @@
 namespace globjects
 {
     class Shader;
+    class StaticStringSource;
 }
 
 
@@ -28,6 +31,12 @@ namespace gloperate
 *  @brief
 *    Shader loader
 *
+*    Shader sources are cached by their content, so that shaders loaded from
+*    files with equal content share the same source object. Stages can compare
+*    the sources of two loaded shaders to find out if a file has changed.
+*    A cached source lives as long as a shader that has been loaded with it,
+*    and is removed from the cache when the last of these shaders is destroyed.
+*
 *  Supported options:
 *    none
 */
@@ -65,6 +74,7 @@ public:
 
     // Virtual gloperate::Loader<globjects::Texture> functions
     virtual globjects::Shader * load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
+    virtual std::function<globjects::Shader * ()> prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const override;
 
 
 protected:
@@ -72,6 +82,9 @@ protected:
     std::vector<std::string> m_types;      ///< List of supported file types (e.g., "bmp image (*.bmp)")
 
     const std::unordered_map<std::string, gl::GLenum> m_extensionToType; ///< Mapping of file extension to GLenum type
+
+    mutable std::mutex                                                                    m_sourcesMutex; ///< Protects m_sources, as resources may be loaded from any thread
+    mutable std::unordered_multimap<size_t, std::weak_ptr<globjects::StaticStringSource>> m_sources;      ///< Cached shader sources by hash of their content (owned by the loaded shaders)
 };
 
 
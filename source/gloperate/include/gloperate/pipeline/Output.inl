@@ -43,6 +43,12 @@ void Output<T>::onRequiredChanged()
             stage->outputRequiredChanged(this);
         }
     }
+
+    // Stage has to be visited on next execution
+    if (Stage * stage = this->parentStage())
+    {
+        stage->markDirty();
+    }
 }
 
 template <typename T>
@@ -52,6 +58,12 @@ void Output<T>::onValueInvalidated()
 
     // Emit signal
     this->valueInvalidated();
+
+    // Stage has to be visited on next execution
+    if (Stage * stage = this->parentStage())
+    {
+        stage->markDirty();
+    }
 }
 
 
@@ -3,8 +3,11 @@
 
 
 #include <vector>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <mutex>
 
 #include <gloperate/pipeline/Stage.h>
 
@@ -13,6 +16,9 @@ namespace gloperate
 {
 
 
+class RenderTargetPool;
+
+
 /**
 *  @brief
 *    Pipeline
@@ -33,6 +39,23 @@ namespace gloperate
 *      invalidated, so any change of input data will propagate through the
 *      pipeline immediately and invalidate all outputs that, directly or
 *      indirectly, depend on that input.
+*
+*    The order of execution is kept in a flat, topologically sorted list of
+*    stages (the execution plan), which is derived from an explicit adjacency
+*    list of the connections between the stages. Adding or removing a single
+*    stage or connection only updates the affected part of the plan, a full
+*    resort is only done after invalidateStageOrder() has been called.
+*
+*    Instead of checking all stages on each execution, the pipeline keeps a
+*    set of dirty stages, which is filled whenever an output of a stage is
+*    invalidated or becomes required. Only these stages are visited, in the
+*    order of the execution plan.
+*
+*    If parallel execution is enabled, context-free stages are executed on
+*    the thread pool of the environment as soon as all stages they depend on
+*    have been processed. All other stages are executed on the calling thread
+*    (i.e., the one with the active OpenGL context) in the order of the plan
+*    and only wait for the stages they actually depend on.
 */
 class GLOPERATE_API Pipeline : public Stage
 {
@@ -127,6 +150,102 @@ public:
     */
     void invalidateStageOrder();
 
+    /**
+    *  @brief
+    *    Update the dependencies of a stage
+    *
+    *  @param[in] stage
+    *    Stage whose input connections have changed (must NOT be null!)
+    *
+    *  @remarks
+    *    The dependencies are collected upon next usage, and only
+    *    the affected part of the stage order is updated.
+    */
+    void invalidateStageDependencies(Stage * stage);
+
+    /**
+    *  @brief
+    *    Adopt a precomputed stage order
+    *
+    *  @param[in] stages
+    *    All stages of the pipeline in the order of execution (e.g., as stored in a snapshot)
+    *
+    *  @return
+    *    'true' if the order has been adopted, 'false' if it does not contain exactly the stages of the pipeline
+    *
+    *  @remarks
+    *    Instead of a full sort, the order is only checked against the
+    *    dependencies of the stages upon next usage and corrected where
+    *    necessary.
+    */
+    bool setStageOrder(const std::vector<Stage *> & stages);
+
+    /**
+    *  @brief
+    *    Check if parallel execution is enabled
+    *
+    *  @return
+    *    'true' if context-free stages are executed in parallel, else 'false'
+    */
+    bool parallelExecution() const;
+
+    /**
+    *  @brief
+    *    Enable or disable parallel execution
+    *
+    *  @param[in] enabled
+    *    'true' if context-free stages are executed in parallel, else 'false'
+    *
+    *  @see
+    *    Stage::isContextFree()
+    */
+    void setParallelExecution(bool enabled);
+
+    /**
+    *  @brief
+    *    Mark stage as dirty
+    *
+    *  @param[in] stage
+    *    Stage that has to be visited on next execution (must NOT be null!)
+    *
+    *  @remarks
+    *    If the pipeline is currently executed and the stage comes after
+    *    the current stage in the execution plan, it is visited in the
+    *    current execution, otherwise on the next one.
+    */
+    void markStageDirty(Stage * stage);
+
+    /**
+    *  @brief
+    *    Get number of stages visited during the last execution
+    *
+    *  @return
+    *    Number of stages that have been checked for processing
+    */
+    size_t visitedStages() const;
+
+    /**
+    *  @brief
+    *    Get number of stages skipped during the last execution
+    *
+    *  @return
+    *    Number of stages that have not been visited, because they were not dirty
+    */
+    size_t skippedStages() const;
+
+    /**
+    *  @brief
+    *    Get pool of transient render targets
+    *
+    *  @return
+    *    Render target pool of the pipeline (never null)
+    *
+    *  @remarks
+    *    The pool is used by render target stages of this pipeline
+    *    which have been declared as transient.
+    */
+    RenderTargetPool * renderTargetPool() const;
+
     // Virtual Stage interface
     virtual bool isPipeline() const override;
 
@@ -138,6 +257,81 @@ protected:
     */
     void sortStages();
 
+    /**
+    *  @brief
+    *    Bring the stage order up to date
+    *
+    *  @remarks
+    *    Performs a full sort if the stage order has been invalidated,
+    *    otherwise only the dependencies of changed stages are updated.
+    */
+    void updateStageOrder();
+
+    /**
+    *  @brief
+    *    Collect the direct dependencies of a stage from its input connections
+    *
+    *  @param[in] stage
+    *    Stage (must NOT be null!)
+    *
+    *  @return
+    *    List of stages of this pipeline the stage depends on
+    */
+    std::vector<Stage *> collectDependencies(const Stage * stage) const;
+
+    /**
+    *  @brief
+    *    Replace the dependencies of a stage in the adjacency list
+    *
+    *  @param[in] stage
+    *    Stage (must NOT be null!)
+    *  @param[in] dependencies
+    *    New list of direct dependencies
+    *
+    *  @return
+    *    'true' if the stage order is still valid, 'false' if a cycle has been detected
+    *
+    *  @remarks
+    *    If the current stage order is valid, it is updated for each added
+    *    dependency by reordering only the stages between both ends of it.
+    */
+    bool setDependencies(Stage * stage, const std::vector<Stage *> & dependencies);
+
+    /**
+    *  @brief
+    *    Update the stage order after a dependency has been added
+    *
+    *  @param[in] source
+    *    Stage that has to be executed first (must NOT be null!)
+    *  @param[in] target
+    *    Stage that depends on source (must NOT be null!)
+    *
+    *  @return
+    *    'true' if the stage order could be updated, 'false' if a cycle has been detected
+    */
+    bool insertDependency(Stage * source, Stage * target);
+
+    /**
+    *  @brief
+    *    Process stage if it needs processing
+    *
+    *  @param[in] stage
+    *    Stage (must NOT be null!)
+    */
+    void processStage(Stage * stage);
+
+    /**
+    *  @brief
+    *    Process dirty stages in the order of the execution plan
+    */
+    void processDirty();
+
+    /**
+    *  @brief
+    *    Process stages, executing context-free stages on the thread pool
+    */
+    void processParallel();
+
     /**
     *  @brief
     *    Common implementation of addStage(Stage *) and addStage(std::unique_ptr<Stage> &&)
@@ -153,9 +347,22 @@ protected:
 
 
 protected:
-    std::vector<Stage *>                     m_stages;    ///< List of topologically sorted stages in the pipeline
-    std::unordered_map<std::string, Stage *> m_stagesMap; ///< Map of names -> stages
-    bool                                     m_sorted;    ///< Have the stages of the pipeline already been sorted?
+    std::vector<Stage *>                                    m_stages;            ///< List of topologically sorted stages in the pipeline (execution plan)
+    std::unordered_map<std::string, Stage *>                m_stagesMap;         ///< Map of names -> stages
+    std::unordered_map<const Stage *, size_t>               m_stageIndices;      ///< Position of each stage in the execution plan
+    std::unordered_map<const Stage *, std::vector<Stage *>> m_dependencies;      ///< Adjacency list: stage -> stages it depends on
+    std::unordered_map<const Stage *, std::vector<Stage *>> m_dependents;        ///< Reverse adjacency list: stage -> stages that depend on it
+    std::unordered_set<Stage *>                             m_reconnectedStages; ///< Stages whose input connections have changed
+    bool                                                    m_sorted;            ///< Have the stages of the pipeline already been sorted?
+    bool                                                    m_parallel;          ///< Are context-free stages executed in parallel?
+    std::unordered_set<Stage *>                             m_dirtyStages;       ///< Stages that have to be visited on next execution
+    std::vector<size_t>                                     m_dirtyQueue;        ///< Min-heap of plan positions to be visited in the current execution
+    size_t                                                  m_currentStage;      ///< Plan position of the currently processed stage
+    bool                                                    m_processing;        ///< Is the pipeline currently being executed?
+    std::mutex                                              m_dirtyMutex;        ///< Mutex for the dirty stages (marked from worker threads in parallel execution)
+    size_t                                                  m_visitedStages;     ///< Number of stages visited during the last execution
+    size_t                                                  m_skippedStages;     ///< Number of stages skipped during the last execution
+    std::unique_ptr<RenderTargetPool>                       m_renderTargetPool;  ///< Transient render targets of the stages
 };
 
 
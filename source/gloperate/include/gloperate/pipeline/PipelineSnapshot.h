@@ -0,0 +1,128 @@
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+class Environment;
+class Pipeline;
+
+
+/**
+*  @brief
+*    Binary snapshot of a complete pipeline
+*
+*    A snapshot contains the stages of a pipeline and all of its nested
+*    pipelines, identified by the names of their stage components, the
+*    dynamic slots, the connections and the values of unconnected
+*    inputs (see AbstractSlot::toVariant()), as well as the execution
+*    plan of each pipeline. Values that cannot be represented (e.g.,
+*    pointers to OpenGL objects) are not stored.
+*
+*    Restoring a snapshot creates the stages from their components, so
+*    stages created by the constructor of a pipeline are reused and
+*    stages that do not appear in the snapshot are removed. The saved
+*    execution plan is adopted and only checked against the restored
+*    connections, instead of sorting the stages again.
+*
+*    The format is a compact, versioned byte stream in little-endian
+*    byte order, which can be restored directly from a memory-mapped
+*    file.
+*/
+class GLOPERATE_API PipelineSnapshot
+{
+public:
+    static const std::uint32_t version; ///< Version of the snapshot format
+
+
+public:
+    /**
+    *  @brief
+    *    Create snapshot of a pipeline
+    *
+    *  @param[in] pipeline
+    *    Pipeline (must NOT be null!)
+    *
+    *  @return
+    *    Snapshot data
+    */
+    static std::vector<char> save(const Pipeline * pipeline);
+
+    /**
+    *  @brief
+    *    Save snapshot of a pipeline to a file
+    *
+    *  @param[in] pipeline
+    *    Pipeline (must NOT be null!)
+    *  @param[in] filename
+    *    Name of the snapshot file
+    *
+    *  @return
+    *    'true' if the file has been written, else 'false'
+    */
+    static bool save(const Pipeline * pipeline, const std::string & filename);
+
+    /**
+    *  @brief
+    *    Create pipeline from a snapshot
+    *
+    *  @param[in] environment
+    *    Environment to which the pipeline belongs (must NOT be null!)
+    *  @param[in] data
+    *    Snapshot data
+    *  @param[in] size
+    *    Size of the snapshot data (in bytes)
+    *
+    *  @return
+    *    Pipeline, null if the snapshot is invalid or its root component is not available
+    */
+    static std::unique_ptr<Pipeline> load(Environment * environment, const char * data, size_t size);
+
+    /**
+    *  @brief
+    *    Create pipeline from a snapshot file
+    *
+    *  @param[in] environment
+    *    Environment to which the pipeline belongs (must NOT be null!)
+    *  @param[in] filename
+    *    Name of the snapshot file
+    *
+    *  @return
+    *    Pipeline, null if the file cannot be read or is invalid
+    */
+    static std::unique_ptr<Pipeline> load(Environment * environment, const std::string & filename);
+
+    /**
+    *  @brief
+    *    Restore snapshot into an existing pipeline
+    *
+    *  @param[in] pipeline
+    *    Pipeline (must NOT be null!)
+    *  @param[in] data
+    *    Snapshot data
+    *  @param[in] size
+    *    Size of the snapshot data (in bytes)
+    *
+    *  @return
+    *    'true' if the snapshot has been restored, 'false' if it is invalid
+    *
+    *  @remarks
+    *    The component of the root pipeline stored in the snapshot is
+    *    ignored. If the snapshot is invalid, the pipeline may have been
+    *    restored partially.
+    */
+    static bool restore(Pipeline * pipeline, const char * data, size_t size);
+};
+
+
+} // namespace gloperate
@@ -18,6 +18,12 @@ namespace gloperate
 *  @brief
 *    Data slot on a stage
 *
+*    The slot that holds the value of a connection chain is resolved when
+*    a connection changes, so dereferencing a connected slot returns a
+*    reference to the value of the source without copying it. Prefer
+*    valueRef(), operator*() and operator->() over value() for large data
+*    types, as value() returns a copy.
+*
 *  @see AbstractSlot
 */
 template <typename T>
@@ -120,6 +126,27 @@ public:
     */
     Slot<T> & operator<<(Slot<T> & source);
 
+    /**
+    *  @brief
+    *    Set value without copying it
+    *
+    *  @param[in] value
+    *    New value, which is moved into the slot
+    *
+    *  @remarks
+    *    Has no effect if the slot is connected.
+    */
+    void setValue(T && value);
+
+    /**
+    *  @brief
+    *    Get value without copying it
+    *
+    *  @return
+    *    Reference to the stored data object of the slot holding the value
+    */
+    const T & valueRef() const;
+
     /**
     *  @brief
     *    Dereference pointer operator
@@ -169,14 +196,17 @@ public:
 protected:
     void promoteConnection();
     void promoteRequired();
+    void resolveSource();
 
 
 protected:
     bool                        m_valid;      ///< Does the slot have a valid value?
     bool                        m_changed;    ///< Was the slot changed since the last time it's pipeline was processed
     Slot<T>                   * m_source;     ///< Connected slot (can be null)
-    cppexpose::ScopedConnection m_valueConnection; ///< Connection to changed-signal of source slot; removes the connection when destroyed
-    cppexpose::ScopedConnection m_validConnection; ///< Connection to invalidated-signal of source slot; removes the connection when destroyed
+    Slot<T>                   * m_root;       ///< Slot at the beginning of the connection chain, which holds the value (this, if not connected)
+    cppexpose::ScopedConnection m_valueConnection;      ///< Connection to changed-signal of source slot; removes the connection when destroyed
+    cppexpose::ScopedConnection m_validConnection;      ///< Connection to invalidated-signal of source slot; removes the connection when destroyed
+    cppexpose::ScopedConnection m_connectionConnection; ///< Connection to connection-changed-signal of source slot; removes the connection when destroyed
 };
 
 
@@ -2,6 +2,8 @@
 #pragma once
 
 
+#include <utility>
+
 #include <cppassist/logging/logging.h>
 
 #include <cppexpose/typed/Typed.h>
@@ -41,6 +43,7 @@ Slot<T>::Slot(SlotType slotType, const std::string & name, Stage * parent, const
 : cppexpose::DirectValue<T, AbstractSlot>(value)
 , m_valid(true)
 , m_source(nullptr)
+, m_root(this)
 {
     // Do not add property to object, yet. Just initialize the property itself
     this->initProperty(name, nullptr);
@@ -54,6 +57,7 @@ Slot<T>::Slot(SlotType slotType, const std::string & name, const T & value)
 : cppexpose::DirectValue<T, AbstractSlot>(value)
 , m_valid(true)
 , m_source(nullptr)
+, m_root(this)
 {
     // Make as a dynamic slot
     this->m_dynamic = true;
@@ -93,10 +97,19 @@ bool Slot<T>::connect(Slot<T> * source)
         this->onValueInvalidated();
     } );
 
+    // Follow changes further up the connection chain
+    m_connectionConnection = m_source->connectionChanged.connect([this] ()
+    {
+        this->resolveSource();
+        this->connectionChanged();
+    } );
+
+    this->resolveSource();
+
     // Emit events
     this->promoteConnection();
     this->promoteRequired();
-    this->onValueChanged(m_source->value());
+    this->onValueChanged(*m_root->ptr());
 
     // Success
     return true;
@@ -109,10 +122,17 @@ Slot<T> & Slot<T>::operator<<(Slot<T> & source)
     return *this;
 }
 
+template <typename T>
+const T & Slot<T>::valueRef() const
+{
+    // Return data of the slot holding the value
+    return m_root->m_value;
+}
+
 template <typename T>
 const T & Slot<T>::operator*() const
 {
-    return *this->ptr();
+    return valueRef();
 }
 
 template <typename T>
@@ -161,6 +181,9 @@ void Slot<T>::disconnect()
     m_source     = nullptr;
     m_valueConnection = cppexpose::ScopedConnection();
     m_validConnection = cppexpose::ScopedConnection();
+    m_connectionConnection = cppexpose::ScopedConnection();
+
+    this->resolveSource();
 
     cppassist::debug(2, "gloperate") << this->qualifiedName() << ": disconnect slot";
 
@@ -178,14 +201,8 @@ const AbstractSlot * Slot<T>::source() const
 template <typename T>
 bool Slot<T>::isValid() const
 {
-    // If connected, return validity of source slot
-    if (m_source)
-    {
-        return m_source->isValid();
-    }
-
-    // Return validity of own data
-    return m_valid;
+    // Return validity of the slot holding the value
+    return m_root->m_valid;
 }
 
 template <typename T>
@@ -227,14 +244,8 @@ void Slot<T>::onRequiredChanged()
 template <typename T>
 T Slot<T>::value() const
 {
-    // If connected, return value of source slot
-    if (m_source)
-    {
-        return m_source->value();
-    }
-
-    // Return own data
-    return this->m_value;
+    // Return data of the slot holding the value
+    return m_root->m_value;
 }
 
 template <typename T>
@@ -255,29 +266,34 @@ void Slot<T>::setValue(const T & value)
 }
 
 template <typename T>
-const T * Slot<T>::ptr() const
+void Slot<T>::setValue(T && value)
 {
-    // If connected, return value of source slot
+    // If connected, abort function
     if (m_source)
     {
-        return m_source->ptr();
+        return;
     }
 
-    // Return own data
-    return &this->m_value;
+    // Set own data
+    this->m_value = std::move(value);
+    this->m_valid = true;
+
+    // Emit signal
+    this->onValueChanged(this->m_value);
 }
 
 template <typename T>
-T * Slot<T>::ptr()
+const T * Slot<T>::ptr() const
 {
-    // If connected, return value of source slot
-    if (m_source)
-    {
-        return m_source->ptr();
-    }
+    // Return data of the slot holding the value
+    return &m_root->m_value;
+}
 
-    // Return own data
-    return &this->m_value;
+template <typename T>
+T * Slot<T>::ptr()
+{
+    // Return data of the slot holding the value
+    return &m_root->m_value;
 }
 
 template <typename T>
@@ -313,5 +329,12 @@ void Slot<T>::promoteRequired()
     m_source->setRequired(this->m_required);
 }
 
+template <typename T>
+void Slot<T>::resolveSource()
+{
+    // Use the slot holding the value of the source, which is already up to date
+    m_root = m_source ? m_source->m_root : this;
+}
+
 
 } // namespace gloperate
@@ -3,7 +3,9 @@
 
 
 #include <vector>
+#include <memory>
 #include <unordered_map>
+#include <typeindex>
 #include <string>
 #include <functional>
 
@@ -20,6 +22,7 @@ class Environment;
 class AbstractGLContext;
 class AbstractSlot;
 class Pipeline;
+class TimerQueryRing;
 
 template <typename T>
 class Slot;
@@ -184,6 +187,9 @@ public:
     *  @brief
     *    Process stage
     *
+    *    If time measurement is enabled or the profiler of the environment
+    *    is enabled, the CPU and GPU time of onProcess() is measured.
+    *
     *  @see onProcess
     */
     void process();
@@ -203,6 +209,18 @@ public:
     */
     bool needsProcessing() const;
 
+    /**
+    *  @brief
+    *    Mark stage as possibly needing processing
+    *
+    *  @remarks
+    *    Informs the parent pipeline that the stage has to be visited
+    *    on its next execution. This is called automatically when an
+    *    output has been invalidated or has changed its required-state,
+    *    and when the stage is marked as 'alwaysProcess'.
+    */
+    void markDirty();
+
     /**
     *  @brief
     *    Update the required-state of the stage's input slots
@@ -288,6 +306,33 @@ public:
     */
     void setAlwaysProcessed(bool alwaysProcess);
 
+    /**
+    *  @brief
+    *    Check if stage is context-free
+    *
+    *  @return
+    *    'true' if stage does not need an OpenGL context, else 'false'
+    *
+    *  @remarks
+    *    A context-free stage does not make any OpenGL calls in
+    *    onProcess(). In pipelines with parallel execution enabled,
+    *    such stages are executed on worker threads, so they must
+    *    only read their inputs and write their own outputs.
+    */
+    bool isContextFree() const;
+
+    /**
+    *  @brief
+    *    Set if stage is context-free
+    *
+    *  @param[in] contextFree
+    *    'true' if stage does not need an OpenGL context, else 'false'
+    *
+    *  @see
+    *    isContextFree()
+    */
+    void setContextFree(bool contextFree);
+
     /**
     *  @brief
     *    Invalidate all outputs
@@ -349,6 +394,24 @@ public:
     */
     AbstractSlot * input(const std::string & name);
 
+    /**
+    *  @brief
+    *    Get input of type T by name
+    *
+    *  @tparam T
+    *    Type of the input
+    *  @param[in] name
+    *    Name of input
+    *
+    *  @return
+    *    Input (null if there is no input of type T with that name)
+    *
+    *  @remarks
+    *    The lookup takes constant time, regardless of the number of inputs.
+    */
+    template <typename T>
+    Input<T> * input(const std::string & name) const;
+
     /**
     *  @brief
     *    Create dynamic input
@@ -477,6 +540,24 @@ public:
     */
     AbstractSlot * output(const std::string & name);
 
+    /**
+    *  @brief
+    *    Get output of type T by name
+    *
+    *  @tparam T
+    *    Type of the output
+    *  @param[in] name
+    *    Name of output
+    *
+    *  @return
+    *    Output (null if there is no output of type T with that name)
+    *
+    *  @remarks
+    *    The lookup takes constant time, regardless of the number of outputs.
+    */
+    template <typename T>
+    Output<T> * output(const std::string & name) const;
+
     /**
     *  @brief
     *    Create dynamic output
@@ -601,6 +682,18 @@ public:
     */
     std::string qualifiedName() const;
 
+    /**
+    *  @brief
+    *    Get revision of the slot interface
+    *
+    *  @return
+    *    Number that changes whenever an input or output is added or removed
+    *
+    *  @remarks
+    *    Can be used to check if slots looked up before are still valid.
+    */
+    size_t slotRevision() const;
+
     /**
     *  @brief
     *    Return the first input of type T where the callback returns 'true'
@@ -661,7 +754,8 @@ public:
     *    duration in nanoseconds
     *
     *  @remarks
-    *    To be consistent with 'lastGPUTime', this value is one iteration (i.e. frame) late.
+    *    This value belongs to the same iteration as 'lastGPUTime' and is
+    *    therefore reported with the same delay.
     */
     std::uint64_t lastCPUTime() const;
 
@@ -673,7 +767,10 @@ public:
     *    duration in nanoseconds
     *
     *  @remarks
-    *    Due to the async nature of GPU processing, this value is one iteration (i.e. frame) late.
+    *    Due to the async nature of GPU processing, this value is reported as
+    *    soon as the GPU has finished the commands, which is usually one or
+    *    two iterations (i.e. frames) later. The CPU never waits for the
+    *    result. If the GPU falls too far behind, iterations are not measured.
     */
     std::uint64_t lastGPUTime() const;
 
@@ -826,23 +923,50 @@ protected:
     */
     void registerOutput(AbstractSlot * output);
 
+    /**
+    *  @brief
+    *    Get inputs of a type
+    *
+    *  @param[in] type
+    *    Value type of the inputs
+    *
+    *  @return
+    *    List of inputs of that type, in the order in which they have been added
+    */
+    const std::vector<AbstractSlot *> & inputsOfType(const std::type_info & type) const;
+
+    /**
+    *  @brief
+    *    Get outputs of a type
+    *
+    *  @param[in] type
+    *    Value type of the outputs
+    *
+    *  @return
+    *    List of outputs of that type, in the order in which they have been added
+    */
+    const std::vector<AbstractSlot *> & outputsOfType(const std::type_info & type) const;
+
 
 protected:
     Environment * m_environment;    ///< Gloperate environment to which the stage belongs
     bool          m_alwaysProcess;  ///< Is the stage always processed?
-
-    bool                        m_timeMeasurement;      ///< Status of time measurements for CPU and GPU
-    bool                        m_useQueryPairOne;      ///< Flag indicating which queries are currently used
-    bool                        m_resultAvailable;      ///< Flag indicating whether a measurement from previous frames is available for report
-    std::array<unsigned int, 4> m_queries;              ///< OpenGL query objects (front/back; start/end)
-    uint64_t                    m_lastCPUDuration;      ///< Time spent in onProcess last frame (in nanoseconds)
-    uint64_t                    m_currentCPUDuration;   ///< Time spent in onProcess current frame (in nanoseconds)
-    uint64_t                    m_lastGPUDuration;      ///< Time for GPU commands issued during onProcess (in nanoseconds)
-
-    std::vector<AbstractSlot *>                     m_inputs;     ///< List of inputs
-    std::unordered_map<std::string, AbstractSlot *> m_inputsMap;  ///< Map of names and inputs
-    std::vector<AbstractSlot *>                     m_outputs;    ///< List of outputs
-    std::unordered_map<std::string, AbstractSlot *> m_outputsMap; ///< Map of names and outputs
+    bool          m_contextFree;    ///< Can the stage be processed without an OpenGL context?
+
+    bool                            m_timeMeasurement;      ///< Status of time measurements for CPU and GPU
+    bool                            m_resultAvailable;      ///< Flag indicating whether a measurement from previous frames is available for report (context-free stages only)
+    std::unique_ptr<TimerQueryRing> m_timerQueries;         ///< GPU timer queries of the iterations whose results are pending (created on demand)
+    uint64_t                        m_lastCPUDuration;      ///< Time spent in onProcess in the last measured iteration (in nanoseconds)
+    uint64_t                        m_currentCPUDuration;   ///< Time spent in onProcess current frame (in nanoseconds, context-free stages only)
+    uint64_t                        m_lastGPUDuration;      ///< Time for GPU commands issued during onProcess in the last measured iteration (in nanoseconds)
+
+    std::vector<AbstractSlot *>                                       m_inputs;        ///< List of inputs
+    std::unordered_map<std::string, AbstractSlot *>                   m_inputsMap;     ///< Map of names and inputs
+    std::unordered_map<std::type_index, std::vector<AbstractSlot *>>  m_inputsByType;  ///< Inputs grouped by value type
+    std::vector<AbstractSlot *>                                       m_outputs;       ///< List of outputs
+    std::unordered_map<std::string, AbstractSlot *>                   m_outputsMap;    ///< Map of names and outputs
+    std::unordered_map<std::type_index, std::vector<AbstractSlot *>>  m_outputsByType; ///< Outputs grouped by value type
+    size_t                                                            m_slotRevision;  ///< Incremented whenever an input or output is added or removed
 };
 
 
@@ -30,23 +30,32 @@ Input<T> * Stage::CreateConnectedInputProxy::operator=(const T & value)
 template <typename T>
 std::vector<Input<T> *> Stage::inputs() const
 {
+    const auto & slots = inputsOfType(typeid(T));
+
     auto result = std::vector<Input<T> *>{};
-    
-    // We do not reserve a heuristically derived number of elements as we assume
-    // the vector growing strategy would handle most cases efficiently
-    // result.reserve(inputs().size() / 2);
-    
-    for (auto input : inputs())
+    result.reserve(slots.size());
+
+    for (auto slot : slots)
     {
-        if (input->type() == typeid(T))
-        {
-            result.push_back(static_cast<Input<T> *>(input));
-        }
+        result.push_back(static_cast<Input<T> *>(slot));
     }
 
     return result;
 }
 
+template <typename T>
+Input<T> * Stage::input(const std::string & name) const
+{
+    const auto it = m_inputsMap.find(name);
+
+    if (it == m_inputsMap.end() || it->second->type() != typeid(T))
+    {
+        return nullptr;
+    }
+
+    return static_cast<Input<T> *>(it->second);
+}
+
 template <typename T>
 Input<T> * Stage::createInput(const std::string & name, const T & defaultValue)
 {
@@ -70,23 +79,32 @@ Input<T> * Stage::createConnectedInput(const std::string & name, Slot<T> & sourc
 template <typename T>
 std::vector<Output<T> *> Stage::outputs() const
 {
+    const auto & slots = outputsOfType(typeid(T));
+
     auto result = std::vector<Output<T> *>{};
-    
-    // We do not reserve a heuristically derived number of elements as we assume
-    // the vector growing strategy would handle most cases efficiently
-    // result.reserve(outputs().size() / 2);
-    
-    for (auto output : outputs())
+    result.reserve(slots.size());
+
+    for (auto slot : slots)
     {
-        if (output->type() == typeid(T))
-        {
-            result.push_back(static_cast<Output<T> *>(output));
-        }
+        result.push_back(static_cast<Output<T> *>(slot));
     }
 
     return result;
 }
 
+template <typename T>
+Output<T> * Stage::output(const std::string & name) const
+{
+    const auto it = m_outputsMap.find(name);
+
+    if (it == m_outputsMap.end() || it->second->type() != typeid(T))
+    {
+        return nullptr;
+    }
+
+    return static_cast<Output<T> *>(it->second);
+}
+
 template <typename T>
 Output<T> * Stage::createOutput(const std::string & name, const T & defaultValue)
 {
@@ -110,75 +128,53 @@ Slot<T> * Stage::createSlot(const std::string & slotType, const std::string & na
 template <typename T>
 gloperate::Input<T> * Stage::findInput(std::function<bool(gloperate::Input<T> *)> callback)
 {
-    const auto it = std::find_if(m_inputs.begin(), m_inputs.end(), [callback](gloperate::AbstractSlot * slot) {
-        const auto input = dynamic_cast<gloperate::Input<T> *>(slot);
+    // Only slots of type T are visited
+    for (auto slot : inputsOfType(typeid(T)))
+    {
+        const auto input = static_cast<gloperate::Input<T> *>(slot);
 
-        if (!input)
+        if (callback(input))
         {
-            return false;
+            return input;
         }
-
-        return callback(input);
-    });
-
-    if (it == m_inputs.end())
-    {
-        return nullptr;
     }
 
-    return static_cast<gloperate::Input<T> *>(*it);
+    return nullptr;
 }
 
 template <typename T>
 void Stage::forAllInputs(std::function<void(gloperate::Input<T> *)> callback)
 {
-    forAllInputs([& callback](gloperate::AbstractSlot * input) {
-        const auto inputT = dynamic_cast<gloperate::Input<T> *>(input);
-
-        if (!inputT)
-        {
-            return;
-        }
-
-        callback(inputT);
-    });
+    for (auto slot : inputsOfType(typeid(T)))
+    {
+        callback(static_cast<gloperate::Input<T> *>(slot));
+    }
 }
 
 template <typename T>
 gloperate::Output<T> * Stage::findOutput(std::function<bool(gloperate::Output<T> *)> callback)
 {
-    const auto it = std::find_if(m_outputs.begin(), m_outputs.end(), [callback](gloperate::AbstractSlot * slot) {
-        const auto output = dynamic_cast<gloperate::Output<T> *>(slot);
+    // Only slots of type T are visited
+    for (auto slot : outputsOfType(typeid(T)))
+    {
+        const auto output = static_cast<gloperate::Output<T> *>(slot);
 
-        if (!output)
+        if (callback(output))
         {
-            return false;
+            return output;
         }
-
-        return callback(output);
-    });
-
-    if (it == m_outputs.end())
-    {
-        return nullptr;
     }
 
-    return static_cast<gloperate::Output<T> *>(*it);
+    return nullptr;
 }
 
 template <typename T>
 void Stage::forAllOutputs(std::function<void(gloperate::Output<T> *)> callback)
 {
-    forAllOutputs([& callback](gloperate::AbstractSlot * output) {
-        const auto outputT = dynamic_cast<gloperate::Output<T> *>(output);
-
-        if (!outputT)
-        {
-            return;
-        }
-
-        callback(outputT);
-    });
+    for (auto slot : outputsOfType(typeid(T)))
+    {
+        callback(static_cast<gloperate::Output<T> *>(slot));
+    }
 }
 
 
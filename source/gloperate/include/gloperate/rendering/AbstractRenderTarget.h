@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <gloperate/rendering/RenderTargetType.h>
 #include <gloperate/rendering/AttachmentType.h>
 
@@ -162,6 +164,21 @@ public:
     */
     bool attachmentRequiresUserDefinedFramebuffer() const;
 
+    /**
+    *  @brief
+    *    Get generation of the current target
+    *
+    *  @return
+    *    Number that is unique among all render targets and changes whenever a target is set or released
+    *
+    *  @remarks
+    *    In contrast to the addresses of textures and renderbuffers, which can be
+    *    reused after an object has been destroyed, the generation identifies the
+    *    current target, so it can be used as a key to cache framebuffer configurations.
+    *    Setting the same attachment of the default framebuffer again keeps the generation.
+    */
+    size_t generation() const;
+
     /**
     *  @brief
     *    Get the symbolic constant of the attachment type used for glClearBuffer
@@ -225,6 +242,7 @@ protected:
     globjects::Texture               * m_texture;                  ///< Texture target
     globjects::Renderbuffer          * m_renderbuffer;             ///< Renderbuffer target
     globjects::FramebufferAttachment * m_userDefinedFBOAttachment; ///< User-defined framebuffer attachment target
+    size_t                             m_generation;               ///< Generation of the current target
 };
 
 
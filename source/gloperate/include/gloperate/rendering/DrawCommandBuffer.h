@@ -0,0 +1,199 @@
+
+#pragma once
+
+
+#include <vector>
+#include <memory>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Buffer of indirect draw commands
+*
+*    The commands are filled on the CPU and uploaded to a GPU buffer
+*    before they are dispatched with a single glMultiDrawArraysIndirect or
+*    glMultiDrawElementsIndirect call by a Drawable (see DrawMode::ArraysIndirect
+*    and DrawMode::ElementsIndirect). Both kinds of commands are stored in the
+*    same GPU buffer, the elements commands follow the arrays commands.
+*/
+class GLOPERATE_API DrawCommandBuffer
+{
+public:
+    /**
+    *  @brief
+    *    Command for glMultiDrawArraysIndirect (layout as defined by OpenGL)
+    */
+    struct ArraysCommand
+    {
+        gl::GLuint count;         ///< Number of vertices
+        gl::GLuint instanceCount; ///< Number of instances
+        gl::GLuint first;         ///< Index of the first vertex
+        gl::GLuint baseInstance;  ///< Instance offset for instanced vertex attributes
+    };
+
+    /**
+    *  @brief
+    *    Command for glMultiDrawElementsIndirect (layout as defined by OpenGL)
+    */
+    struct ElementsCommand
+    {
+        gl::GLuint count;         ///< Number of indices
+        gl::GLuint instanceCount; ///< Number of instances
+        gl::GLuint firstIndex;    ///< Position of the first index in the index buffer
+        gl::GLint  baseVertex;    ///< Value added to each index
+        gl::GLuint baseInstance;  ///< Instance offset for instanced vertex attributes
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @remarks
+    *    Creates OpenGL objects, thus, a current context is required.
+    */
+    DrawCommandBuffer();
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Destroys OpenGL objects, thus, a current context is required.
+    */
+    ~DrawCommandBuffer();
+
+    // No copying
+    DrawCommandBuffer(const DrawCommandBuffer &) = delete;
+    DrawCommandBuffer & operator=(const DrawCommandBuffer &) = delete;
+
+    /**
+    *  @brief
+    *    Remove all commands
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Add command for glMultiDrawArraysIndirect
+    *
+    *  @param[in] count
+    *    Number of vertices
+    *  @param[in] instanceCount
+    *    Number of instances
+    *  @param[in] first
+    *    Index of the first vertex
+    *  @param[in] baseInstance
+    *    Instance offset for instanced vertex attributes
+    */
+    void addArrays(gl::GLuint count, gl::GLuint instanceCount = 1, gl::GLuint first = 0, gl::GLuint baseInstance = 0);
+
+    /**
+    *  @brief
+    *    Add command for glMultiDrawElementsIndirect
+    *
+    *  @param[in] count
+    *    Number of indices
+    *  @param[in] instanceCount
+    *    Number of instances
+    *  @param[in] firstIndex
+    *    Position of the first index in the index buffer
+    *  @param[in] baseVertex
+    *    Value added to each index
+    *  @param[in] baseInstance
+    *    Instance offset for instanced vertex attributes
+    */
+    void addElements(gl::GLuint count, gl::GLuint instanceCount = 1, gl::GLuint firstIndex = 0, gl::GLint baseVertex = 0, gl::GLuint baseInstance = 0);
+
+    /**
+    *  @brief
+    *    Get commands for glMultiDrawArraysIndirect
+    *
+    *  @return
+    *    Arrays commands
+    */
+    const std::vector<ArraysCommand> & arraysCommands() const;
+
+    /**
+    *  @brief
+    *    Get commands for glMultiDrawArraysIndirect for modification
+    *
+    *  @return
+    *    Arrays commands
+    *
+    *  @remarks
+    *    The commands are uploaded again before the next draw call.
+    */
+    std::vector<ArraysCommand> & arraysCommands();
+
+    /**
+    *  @brief
+    *    Get commands for glMultiDrawElementsIndirect
+    *
+    *  @return
+    *    Elements commands
+    */
+    const std::vector<ElementsCommand> & elementsCommands() const;
+
+    /**
+    *  @brief
+    *    Get commands for glMultiDrawElementsIndirect for modification
+    *
+    *  @return
+    *    Elements commands
+    *
+    *  @remarks
+    *    The commands are uploaded again before the next draw call.
+    */
+    std::vector<ElementsCommand> & elementsCommands();
+
+    /**
+    *  @brief
+    *    Upload commands to the GPU buffer, if they have been modified
+    */
+    void upload();
+
+    /**
+    *  @brief
+    *    Get GPU buffer
+    *
+    *  @return
+    *    Buffer containing the uploaded commands (always valid)
+    */
+    globjects::Buffer * buffer() const;
+
+    /**
+    *  @brief
+    *    Get offset of the elements commands in the GPU buffer
+    *
+    *  @return
+    *    Offset (in bytes)
+    */
+    size_t elementsOffset() const;
+
+
+protected:
+    std::unique_ptr<globjects::Buffer> m_buffer;           ///< GPU buffer
+    size_t                             m_capacity;         ///< Size of the GPU buffer (in bytes)
+    bool                               m_modified;         ///< 'true' if the commands have been modified since the last upload, else 'false'
+    std::vector<ArraysCommand>         m_arraysCommands;   ///< Commands for glMultiDrawArraysIndirect
+    std::vector<ElementsCommand>       m_elementsCommands; ///< Commands for glMultiDrawElementsIndirect
+};
+
+
+} // namespace gloperate
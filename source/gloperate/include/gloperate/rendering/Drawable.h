@@ -19,6 +19,9 @@ namespace gloperate
 {
 
 
+class DrawCommandBuffer;
+
+
 /**
 *  @brief
 *    Draw mode
@@ -29,7 +32,9 @@ enum class DrawMode : unsigned int
 {
     Arrays,             ///< Dispatch to glDrawArrays
     ElementsIndices,    ///< Dispatch to glDrawElements using a CPU index buffer
-    ElementsIndexBuffer ///< Dispatch to glDrawElements using a GPU index buffer
+    ElementsIndexBuffer, ///< Dispatch to glDrawElements using a GPU index buffer
+    ArraysIndirect,      ///< Dispatch to glMultiDrawArraysIndirect using a command buffer
+    ElementsIndirect     ///< Dispatch to glMultiDrawElementsIndirect using a command buffer and a GPU index buffer
 };
 
 
@@ -45,6 +50,11 @@ enum class DrawMode : unsigned int
 *    - glDrawArrays
 *    - glDrawElements using CPU index buffer
 *    - glDrawElements using GPU index buffer
+*    - glMultiDrawArraysIndirect and glMultiDrawElementsIndirect using a DrawCommandBuffer
+*
+*    If the instance count is not 1, the instanced variants of glDrawArrays
+*    and glDrawElements are used. Per-instance vertex attributes are
+*    configured by setting a divisor for their attribute binding.
 *
 *    Supported buffer arrangements:
 *    - Separate buffer per vertex attribute
@@ -223,6 +233,32 @@ public:
     */
     void drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, globjects::Buffer * indices) const;
 
+    /**
+    *  @brief
+    *    Draw geometry with the arrays commands of the command buffer
+    *
+    *  @param[in] mode
+    *    Primitive mode to be used for this specific draw call
+    *
+    *  @remarks
+    *    Triggers a single glMultiDrawArraysIndirect draw call.
+    *    Does nothing if no command buffer has been set.
+    */
+    void drawArraysIndirect(gl::GLenum mode) const;
+
+    /**
+    *  @brief
+    *    Draw geometry with the elements commands of the command buffer
+    *
+    *  @param[in] mode
+    *    Primitive mode to be used for this specific draw call
+    *
+    *  @remarks
+    *    Triggers a single glMultiDrawElementsIndirect draw call using the
+    *    GPU index buffer. Does nothing if no command buffer has been set.
+    */
+    void drawElementsIndirect(gl::GLenum mode) const;
+
     /**
     *  @brief
     *    Get vertex count
@@ -245,6 +281,49 @@ public:
     */
     void setSize(gl::GLsizei size);
 
+    /**
+    *  @brief
+    *    Get instance count
+    *
+    *  @return
+    *    Number of instances drawn by glDrawArrays and glDrawElements draw calls
+    */
+    gl::GLsizei instanceCount() const;
+
+    /**
+    *  @brief
+    *    Set instance count
+    *
+    *  @param[in] instanceCount
+    *    Number of instances drawn by glDrawArrays and glDrawElements draw calls (default: 1)
+    *
+    *  @remarks
+    *    If the count is not 1, the instanced draw calls are used.
+    */
+    void setInstanceCount(gl::GLsizei instanceCount);
+
+    /**
+    *  @brief
+    *    Get command buffer
+    *
+    *  @return
+    *    Command buffer for indirect draw calls (can be null)
+    */
+    DrawCommandBuffer * commandBuffer() const;
+
+    /**
+    *  @brief
+    *    Set command buffer
+    *
+    *  @param[in] commandBuffer
+    *    Command buffer for indirect draw calls (can be null)
+    *
+    *  @remarks
+    *    The command buffer is not owned by the drawable. Modified commands
+    *    are uploaded automatically before each indirect draw call.
+    */
+    void setCommandBuffer(DrawCommandBuffer * commandBuffer);
+
     /**
     *  @brief
     *    Get primitive mode
@@ -489,6 +568,17 @@ public:
     */
     void setAttributeBindingFormatL(size_t bindingIndex, gl::GLint size, gl::GLenum type, gl::GLuint relativeOffset);
 
+    /**
+    *  @brief
+    *    Set the rate at which a vertex attribute binding advances during instanced rendering
+    *
+    *  @param[in] bindingIndex
+    *    Index of the vertex attribute binding
+    *  @param[in] divisor
+    *    Number of instances that share an attribute value (0 for per-vertex attributes, 1 for per-instance attributes)
+    */
+    void setAttributeBindingDivisor(size_t bindingIndex, gl::GLint divisor);
+
     /**
     *  @brief
     *    Associate vertex attribute binding with a vertex shader attribute input index
@@ -531,6 +621,8 @@ protected:
 
     DrawMode                   m_drawMode;        ///< The configured draw mode that is used if no specific draw mode is passed in the draw method.
     gl::GLsizei                m_size;            ///< The configured vertex count that is used if no specific vertex range is passed in the draw method.
+    gl::GLsizei                m_instanceCount;   ///< The configured number of instances (instanced draw calls are used if it is not 1).
+    DrawCommandBuffer*         m_commandBuffer;   ///< The configured command buffer for indirect draw calls (can be null).
     gl::GLenum                 m_primitiveMode;   ///< The configured primitive mode that is used if no specific primitive mode is passed in the draw method.
     gl::GLenum                 m_indexBufferType; ///< The configured GPU index buffer type of the currently set index buffer.
     globjects::Buffer*         m_indexBuffer;     ///< The configured GPU index buffer that is used if no specific index buffer in passed in the draw method.
@@ -0,0 +1,118 @@
+
+#pragma once
+
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+#include <gloperate/rendering/ShapeType.h>
+
+
+namespace globjects
+{
+    class Buffer;
+}
+
+
+namespace gloperate
+{
+
+
+class AbstractGLContext;
+
+
+/**
+*  @brief
+*    Process-wide cache of shape geometry that is shared between shapes
+*
+*    Geometry is identified by the OpenGL context it has been created in,
+*    the shape type and its parameters. It is kept alive as long as a shape
+*    uses it, so that the buffers are deleted while an OpenGL context is
+*    still active. Contexts do not need to share their objects, as geometry
+*    is only shared within one context. When a context is destroyed, its
+*    entries are removed (see releaseContext()).
+*
+*  @remarks
+*    Geometry that is obtained without a context is shared between all shapes
+*    created without a context, which requires their contexts to share objects.
+*/
+class GLOPERATE_API GeometryCache
+{
+public:
+    /**
+    *  @brief
+    *    Key of shared geometry
+    */
+    struct Key
+    {
+        const AbstractGLContext * context;   ///< OpenGL context in which the geometry is used (can be null)
+        ShapeType                 type;      ///< Type of the shape
+        int                       level;     ///< Level of detail, e.g., number of refinement levels
+        float                     size;      ///< Size of the shape, e.g., radius of a sphere
+        bool                      texCoords; ///< 'true' if the geometry contains texture coordinates, else 'false'
+
+        bool operator<(const Key & other) const;
+    };
+
+    /**
+    *  @brief
+    *    Shared geometry
+    */
+    struct Geometry
+    {
+        std::unique_ptr<globjects::Buffer> vertices;  ///< Vertex buffer (vec3)
+        std::unique_ptr<globjects::Buffer> texCoords; ///< Texture coordinate buffer (vec2, can be null)
+        std::unique_ptr<globjects::Buffer> indices;   ///< Index buffer
+        gl::GLenum                         indexType; ///< Type of the indices
+        gl::GLsizei                        size;      ///< Number of indices
+
+        Geometry();
+        ~Geometry();
+    };
+
+
+public:
+    /**
+    *  @brief
+    *    Get shared geometry
+    *
+    *  @param[in] key
+    *    Key of the geometry
+    *  @param[in] create
+    *    Function that creates the geometry if it is not shared yet
+    *
+    *  @return
+    *    Shared geometry
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    static std::shared_ptr<const Geometry> obtain(const Key & key, const std::function<std::unique_ptr<Geometry> ()> & create);
+
+    /**
+    *  @brief
+    *    Remove all geometry of an OpenGL context from the cache
+    *
+    *  @param[in] context
+    *    OpenGL context
+    *
+    *  @remarks
+    *    Called when a context is destroyed, so that a new context at the
+    *    same address does not obtain geometry of the destroyed context.
+    *    Geometry that is still used by shapes is kept alive by them.
+    */
+    static void releaseContext(const AbstractGLContext * context);
+
+
+protected:
+    static std::mutex                                   s_mutex;      ///< Protects the cache
+    static std::map<Key, std::weak_ptr<const Geometry>> s_geometries; ///< Geometry that is currently in use
+};
+
+
+} // namespace gloperate
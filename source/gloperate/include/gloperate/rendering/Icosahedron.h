@@ -4,7 +4,6 @@
 
 #include <array>
 #include <vector>
-#include <unordered_map>
 
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
@@ -29,7 +28,7 @@ public:
     *  @brief
     *    Data type for faces
     */
-    using Face = std::array<gl::GLushort, 3>;
+    using Face = std::array<gl::GLuint, 3>;
 
 
 public:
@@ -66,6 +65,10 @@ public:
     *    Face array
     *  @param[in] levels
     *    Number of levels
+    *
+    *  @remarks
+    *    Each level multiplies the number of faces by 4. Eight levels result in
+    *    655362 vertices, which requires 32-bit indices.
     */
     static void refine(std::vector<glm::vec3> & vertices, std::vector<Face> & indices, unsigned char levels);
 
@@ -127,7 +130,19 @@ public:
     *  @return
     *    Index array (describes a list of triangles)
     */
-    const std::vector<std::array<gl::GLushort, 3>> & indices() const;
+    const std::vector<Face> & indices() const;
+
+
+private:
+    /**
+    *  @brief
+    *    Entry of the edge table
+    */
+    struct Edge
+    {
+        gl::GLuint other;    ///< Index of the point with the greater index
+        gl::GLuint midpoint; ///< Index of the point that splits the edge
+    };
 
 
 private:
@@ -145,17 +160,17 @@ private:
     *    Index of the second point in points
     *  @param[in] points
     *    Vertex array
-    *  @param[in] cache
-    *    Point cache
+    *  @param[in] edges
+    *    Edge table, holds a fixed number of edges for each point with the smaller index
     *
     *  @return
     *    Index of the new point
     */
-    static gl::GLushort split(
-        gl::GLushort a
-    ,   gl::GLushort b
+    static gl::GLuint split(
+        gl::GLuint a
+    ,   gl::GLuint b
     ,   std::vector<glm::vec3> & points
-    ,   std::unordered_map<glm::uint, gl::GLushort> & cache);
+    ,   std::vector<Edge> & edges);
 
 
 private:
@@ -0,0 +1,246 @@
+
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Program;
+    class ProgramBinary;
+    class Shader;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Cache for linked program binaries
+*
+*    Program binaries are identified by the types and source codes of the
+*    shaders of a program together with the vendor, renderer and version
+*    strings of the OpenGL driver. Binaries are kept in memory and, if a
+*    cache directory has been set, in files inside that directory, so that
+*    programs can be restored without compiling and linking their shaders
+*    on the next start of the application.
+*
+*    The contents of named strings that are included by a shader are part
+*    of the key as well. Programs with includes that cannot be resolved to
+*    named strings (e.g., relative to include paths) are not cached.
+*/
+class GLOPERATE_API ProgramBinaryCache
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    ProgramBinaryCache();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    ~ProgramBinaryCache();
+
+    // No copying
+    ProgramBinaryCache(const ProgramBinaryCache &) = delete;
+    ProgramBinaryCache & operator=(const ProgramBinaryCache &) = delete;
+
+    /**
+    *  @brief
+    *    Get cache directory
+    *
+    *  @return
+    *    Directory in which binaries are stored (empty if binaries are only kept in memory)
+    */
+    std::string directory() const;
+
+    /**
+    *  @brief
+    *    Set cache directory
+    *
+    *  @param[in] directory
+    *    Existing directory in which binaries are stored (empty to keep binaries only in memory)
+    */
+    void setDirectory(const std::string & directory);
+
+    /**
+    *  @brief
+    *    Look up binary of a program
+    *
+    *  @param[in] shaders
+    *    Shaders of the program
+    *
+    *  @return
+    *    Program binary, null if no binary is cached or program binaries are not supported
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    std::unique_ptr<globjects::ProgramBinary> load(const std::vector<globjects::Shader *> & shaders);
+
+    /**
+    *  @brief
+    *    Store binary of a program
+    *
+    *  @param[in] shaders
+    *    Shaders of the program
+    *  @param[in] program
+    *    Program that has been linked from the shaders with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set (must NOT be null!)
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    void store(const std::vector<globjects::Shader *> & shaders, const globjects::Program * program);
+
+    /**
+    *  @brief
+    *    Remove all binaries from memory
+    *
+    *  @remarks
+    *    Files in the cache directory are not deleted.
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Get number of successful look-ups
+    *
+    *  @return
+    *    Number of calls to load() that returned a binary
+    */
+    size_t hits() const;
+
+    /**
+    *  @brief
+    *    Get number of failed look-ups
+    *
+    *  @return
+    *    Number of calls to load() that did not return a binary
+    */
+    size_t misses() const;
+
+    /**
+    *  @brief
+    *    Check if program binaries are supported by the current context
+    *
+    *  @return
+    *    'true' if binaries can be retrieved and restored, else 'false'
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    static bool isSupported();
+
+
+protected:
+    /**
+    *  @brief
+    *    Cached program binary
+    */
+    struct Binary
+    {
+        gl::GLenum        format; ///< Driver specific binary format
+        std::vector<char> data;   ///< Binary data
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Get driver string of the current context
+    *
+    *  @return
+    *    Vendor, renderer and version of the OpenGL driver
+    */
+    static std::string driverString();
+
+    /**
+    *  @brief
+    *    Compute key of a program
+    *
+    *  @param[in] shaders
+    *    Shaders of the program
+    *  @param[in] driver
+    *    Driver string
+    *  @param[out] programKey
+    *    64-bit FNV-1a hash of the driver string, the shader types and sources and the contents of included named strings
+    *
+    *  @return
+    *    'true' if the key has been computed, 'false' if an include cannot be resolved
+    */
+    static bool key(const std::vector<globjects::Shader *> & shaders, const std::string & driver, std::uint64_t & programKey);
+
+    /**
+    *  @brief
+    *    Get file name of a cached binary
+    *
+    *  @param[in] key
+    *    Program key
+    *
+    *  @return
+    *    Path inside the cache directory
+    */
+    std::string filename(std::uint64_t key) const;
+
+    /**
+    *  @brief
+    *    Read binary from file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] key
+    *    Expected program key
+    *  @param[in] driver
+    *    Expected driver string
+    *  @param[out] binary
+    *    Binary
+    *
+    *  @return
+    *    'true' if a matching binary has been read, else 'false'
+    */
+    static bool readBinary(const std::string & filename, std::uint64_t key, const std::string & driver, Binary & binary);
+
+    /**
+    *  @brief
+    *    Write binary to file
+    *
+    *  @param[in] filename
+    *    File name
+    *  @param[in] key
+    *    Program key
+    *  @param[in] driver
+    *    Driver string
+    *  @param[in] binary
+    *    Binary
+    *
+    *  @return
+    *    'true' if the binary has been written, else 'false'
+    */
+    static bool writeBinary(const std::string & filename, std::uint64_t key, const std::string & driver, const Binary & binary);
+
+
+protected:
+    mutable std::mutex                         m_mutex;     ///< Protects all members, binaries may be requested from any thread with a context
+    std::string                                m_directory; ///< Cache directory (can be empty)
+    std::unordered_map<std::uint64_t, Binary>  m_binaries;  ///< Binaries in memory by program key
+    size_t                                     m_hits;      ///< Number of successful look-ups
+    size_t                                     m_misses;    ///< Number of failed look-ups
+};
+
+
+} // namespace gloperate
@@ -58,6 +58,23 @@ public:
     */
     virtual void draw() const override;
 
+    /**
+    *  @brief
+    *    Draw geometry within a sequence of render passes
+    *
+    *  @param[in] previous
+    *    Render pass that has been drawn directly before (can be null)
+    *  @param[in] next
+    *    Render pass that will be drawn directly afterwards (can be null)
+    *
+    *  @remarks
+    *    Program, resources, and states that equal those of the previous
+    *    render pass are not set again, and the state after rendering is not
+    *    applied if the next render pass would replace it with the same states.
+    *    This assumes that the geometry does not change these bindings.
+    */
+    void draw(const RenderPass * previous, const RenderPass * next) const;
+
     /**
     *  @brief
     *    Get state that is applied before rendering
@@ -526,8 +543,11 @@ protected:
     /**
     *  @brief
     *    Bind all configured resources before rendering
+    *
+    *  @param[in] previous
+    *    Render pass whose resources are still bound (can be null)
     */
-    void bindResources() const;
+    void bindResources(const RenderPass * previous) const;
 
 
 protected:
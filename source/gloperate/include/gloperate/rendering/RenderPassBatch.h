@@ -0,0 +1,115 @@
+
+#pragma once
+
+
+#include <vector>
+
+#include <gloperate/rendering/AbstractDrawable.h>
+
+
+namespace gloperate
+{
+
+
+class RenderPass;
+
+
+/**
+*  @brief
+*    List of render passes that are drawn with as few state changes as possible
+*
+*    The render passes are sorted by program, state, and texture, and
+*    consecutive render passes only set what differs from the previous one
+*    (see RenderPass::draw(const RenderPass *, const RenderPass *)).
+*
+*  @remarks
+*    As the render passes are reordered, this should only be used for
+*    render passes whose order does not matter, e.g., opaque geometry
+*    with depth testing. Render passes with equal keys keep their order.
+*/
+class GLOPERATE_API RenderPassBatch : public AbstractDrawable
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    RenderPassBatch();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    virtual ~RenderPassBatch();
+
+    /**
+    *  @brief
+    *    Draw all render passes
+    */
+    virtual void draw() const override;
+
+    /**
+    *  @brief
+    *    Get render passes
+    *
+    *  @return
+    *    Render passes in the order in which they are drawn
+    *
+    *  @remarks
+    *    The order is updated when the render passes are drawn.
+    */
+    const std::vector<RenderPass *> & renderPasses() const;
+
+    /**
+    *  @brief
+    *    Add render pass
+    *
+    *  @param[in] renderPass
+    *    Render pass (must NOT be null!)
+    *
+    *  @remarks
+    *    The render pass is not owned by the batch.
+    */
+    void addRenderPass(RenderPass * renderPass);
+
+    /**
+    *  @brief
+    *    Remove render pass
+    *
+    *  @param[in] renderPass
+    *    Render pass
+    */
+    void removeRenderPass(RenderPass * renderPass);
+
+    /**
+    *  @brief
+    *    Remove all render passes
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Sort render passes again before the next draw call
+    *
+    *  @remarks
+    *    Must be called after the program, states, or textures of a
+    *    render pass in the batch have been changed.
+    */
+    void invalidateOrder();
+
+
+protected:
+    /**
+    *  @brief
+    *    Sort render passes to minimize state changes
+    */
+    void sort() const;
+
+
+protected:
+    mutable std::vector<RenderPass *> m_renderPasses; ///< Render passes (not owned)
+    mutable bool                      m_sorted;       ///< 'true' if the render passes are sorted, else 'false'
+};
+
+
+} // namespace gloperate
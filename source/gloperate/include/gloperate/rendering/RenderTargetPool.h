@@ -0,0 +1,370 @@
+
+#pragma once
+
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <glm/vec2.hpp>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Texture;
+    class Renderbuffer;
+}
+
+
+namespace gloperate
+{
+
+
+class Stage;
+class Pipeline;
+
+
+/**
+*  @brief
+*    Pool of transient render targets of a pipeline
+*
+*    Render target stages can obtain their texture or renderbuffer from the
+*    pool of their pipeline instead of owning it. The lifetime of a transient
+*    render target spans from the first stage that uses it in the execution
+*    plan, i.e., the stage that renders into it, to the last stage that reads
+*    it, which is determined from the values of the input slots of all stages
+*    in the pipeline. Stages whose lifetimes do not overlap and which request
+*    the same format and size share the same render target.
+*
+*    A shared render target is only handed out to a stage when the content
+*    of the stage that has written it before is no longer needed, i.e., its
+*    lifetime has ended in the current execution or the content stems from
+*    an earlier execution. Otherwise, the stage gets a separate render target.
+*    If a stage that has lost its content is needed again by stages that read
+*    it, the stage is invalidated before the next execution and does not share
+*    its render target anymore until the lifetimes change.
+*
+*    Sharing relies on shared content being rendered again in each execution
+*    in which it is read, which holds for pipelines that are rendered every
+*    frame. As pipelines only process dirty stages, a stage may also read
+*    shared content in an execution that skips the stage that renders it.
+*    The pool detects this before the reading stage is processed, but cannot
+*    render the content in time. The owner is invalidated and does not share
+*    its render target anymore, so the content is correct again from the next
+*    execution on.
+*/
+class GLOPERATE_API RenderTargetPool
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    */
+    RenderTargetPool();
+
+    /**
+    *  @brief
+    *    Destructor
+    */
+    virtual ~RenderTargetPool();
+
+    // No copying
+    RenderTargetPool(const RenderTargetPool &) = delete;
+    RenderTargetPool & operator=(const RenderTargetPool &) = delete;
+
+    /**
+    *  @brief
+    *    Obtain texture for a stage
+    *
+    *  @param[in] owner
+    *    Stage that writes the texture (must NOT be null!)
+    *  @param[in] internalFormat
+    *    OpenGL internal image format
+    *  @param[in] format
+    *    OpenGL image format
+    *  @param[in] type
+    *    OpenGL data type
+    *  @param[in] size
+    *    Size of the texture
+    *
+    *  @return
+    *    Texture, valid until the stage obtains another render target or is released
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    globjects::Texture * obtainTexture(Stage * owner, gl::GLenum internalFormat, gl::GLenum format, gl::GLenum type, const glm::ivec2 & size);
+
+    /**
+    *  @brief
+    *    Obtain renderbuffer for a stage
+    *
+    *  @param[in] owner
+    *    Stage that writes the renderbuffer (must NOT be null!)
+    *  @param[in] internalFormat
+    *    OpenGL internal image format
+    *  @param[in] size
+    *    Size of the renderbuffer
+    *
+    *  @return
+    *    Renderbuffer, valid until the stage obtains another render target or is released
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    globjects::Renderbuffer * obtainRenderbuffer(Stage * owner, gl::GLenum internalFormat, const glm::ivec2 & size);
+
+    /**
+    *  @brief
+    *    Release render target of a stage
+    *
+    *  @param[in] owner
+    *    Stage
+    *
+    *  @remarks
+    *    The render target is destroyed if no other stage uses it.
+    */
+    void release(const Stage * owner);
+
+    /**
+    *  @brief
+    *    Destroy all render targets
+    *
+    *  @remarks
+    *    Must be called with an active OpenGL context.
+    */
+    void clear();
+
+    /**
+    *  @brief
+    *    Update lifetimes of the render targets
+    *
+    *  @param[in] pipeline
+    *    Pipeline that owns the pool (must NOT be null!)
+    *
+    *  @remarks
+    *    Called by the pipeline before it is executed. The lifetimes are derived
+    *    from the inputs of the stages as they have been set in the last execution.
+    *    If they have changed, all stages with transient render targets are
+    *    invalidated, so their render targets are shared anew. Otherwise, stages
+    *    whose content has been overwritten are invalidated if it is read again.
+    */
+    void updateLifetimes(const Pipeline * pipeline);
+
+    /**
+    *  @brief
+    *    Forget lifetimes of the render targets
+    *
+    *  @remarks
+    *    Called by the pipeline when connections have changed. As the readers of a
+    *    shared render target cannot be told apart, all stages with transient render
+    *    targets are invalidated and obtain separate render targets until the
+    *    lifetimes have been updated again.
+    */
+    void resetLifetimes();
+
+    /**
+    *  @brief
+    *    Check the content of the render targets a stage uses
+    *
+    *  @param[in] stage
+    *    Stage that is about to be processed (must NOT be null!)
+    *
+    *  @remarks
+    *    Called by the pipeline on the rendering thread before a stage is processed.
+    *    If the stage renders the content of a render target, it becomes the current
+    *    content. If the stage reads content that has been overwritten, because the
+    *    stage that renders it has not been processed in this execution, the owner is
+    *    invalidated and does not share its render target anymore.
+    */
+    void prepareStage(const Stage * stage);
+
+    /**
+    *  @brief
+    *    Get number of render targets in the pool
+    *
+    *  @return
+    *    Number of render targets
+    */
+    size_t numRenderTargets() const;
+
+    /**
+    *  @brief
+    *    Get memory used by the pool
+    *
+    *  @return
+    *    Estimated video memory of all render targets in the pool (in bytes)
+    */
+    size_t pooledMemory() const;
+
+    /**
+    *  @brief
+    *    Get peak memory used by the pool
+    *
+    *  @return
+    *    Maximum of pooledMemory() since the pool has been created (in bytes)
+    */
+    size_t peakMemory() const;
+
+    /**
+    *  @brief
+    *    Get memory requested from the pool
+    *
+    *  @return
+    *    Estimated video memory the render targets would need without sharing (in bytes)
+    */
+    size_t requestedMemory() const;
+
+
+protected:
+    /**
+    *  @brief
+    *    Description of a render target
+    */
+    struct Description
+    {
+        bool        renderbuffer;   ///< Renderbuffer (true) or texture (false)
+        gl::GLenum  internalFormat; ///< OpenGL internal image format
+        gl::GLenum  format;         ///< OpenGL image format (textures only)
+        gl::GLenum  type;           ///< OpenGL data type (textures only)
+        glm::ivec2  size;           ///< Size of the render target
+
+        bool operator==(const Description & other) const;
+    };
+
+    /**
+    *  @brief
+    *    Pooled render target
+    */
+    struct RenderTarget
+    {
+        Description                              description;  ///< Format and size
+        std::unique_ptr<globjects::Texture>      texture;      ///< Texture (if description.renderbuffer is false)
+        std::unique_ptr<globjects::Renderbuffer> renderbuffer; ///< Renderbuffer (if description.renderbuffer is true)
+        size_t                                   memory;       ///< Estimated video memory (in bytes)
+        std::vector<Stage *>                     owners;       ///< Stages sharing the render target
+        Stage                                  * writer;       ///< Stage whose content the render target currently holds (can be null)
+        size_t                                   execution;    ///< Execution in which the current content has been obtained or rendered
+    };
+
+    /**
+    *  @brief
+    *    Lifetime of a render target in the execution plan
+    */
+    struct Lifetime
+    {
+        size_t first; ///< Position of the first stage that uses (writes) the render target
+        size_t last;  ///< Position of the last stage that reads the render target
+
+        bool operator==(const Lifetime & other) const;
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Obtain render target for a stage
+    *
+    *  @param[in] owner
+    *    Stage that writes the render target (must NOT be null!)
+    *  @param[in] description
+    *    Format and size
+    *
+    *  @return
+    *    Render target (never null)
+    */
+    RenderTarget * obtain(Stage * owner, const Description & description);
+
+    /**
+    *  @brief
+    *    Remove a stage from the owners of its render target
+    *
+    *  @param[in] owner
+    *    Stage
+    *
+    *  @remarks
+    *    In contrast to release(), the lifetime of the stage is kept.
+    */
+    void detach(const Stage * owner);
+
+    /**
+    *  @brief
+    *    Check if a stage can share a render target with its current owners
+    *
+    *  @param[in] owner
+    *    Stage
+    *  @param[in] renderTarget
+    *    Render target
+    *
+    *  @return
+    *    'true' if the lifetime of the stage does not overlap with the lifetimes of the other owners, else 'false'
+    */
+    bool canShare(const Stage * owner, const RenderTarget & renderTarget) const;
+
+    /**
+    *  @brief
+    *    Check if a stage can overwrite the current content of a render target
+    *
+    *  @param[in] owner
+    *    Stage
+    *  @param[in] renderTarget
+    *    Render target
+    *
+    *  @return
+    *    'true' if the content has been written by the stage itself or is no longer needed by its writer, else 'false'
+    */
+    bool canOverwrite(const Stage * owner, const RenderTarget & renderTarget) const;
+
+    /**
+    *  @brief
+    *    Compute video memory of a render target
+    *
+    *  @param[in] renderTarget
+    *    Allocated render target
+    *
+    *  @return
+    *    Video memory (in bytes), derived from the component sizes of the actual internal format
+    */
+    static size_t computeMemory(const RenderTarget & renderTarget);
+
+    /**
+    *  @brief
+    *    Allocate the texture or renderbuffer of a render target
+    *
+    *  @param[in] renderTarget
+    *    Render target with description, its object and memory are set
+    */
+    virtual void allocate(RenderTarget & renderTarget);
+
+    /**
+    *  @brief
+    *    Get texture or renderbuffer of a render target
+    *
+    *  @param[in] renderTarget
+    *    Render target
+    *
+    *  @return
+    *    Address of the texture or renderbuffer, as it is referenced by the slots of stages
+    */
+    virtual const void * object(const RenderTarget & renderTarget) const;
+
+
+protected:
+    std::vector<std::unique_ptr<RenderTarget>>                    m_renderTargets; ///< Pooled render targets
+    std::unordered_map<const Stage *, RenderTarget *>             m_ownerTargets;  ///< Render target of each stage
+    std::unordered_map<const Stage *, Lifetime>                   m_lifetimes;     ///< Lifetimes of the render targets of the stages (unknown lifetimes overlap with everything)
+    std::unordered_map<const Stage *, std::vector<const Stage *>> m_users;         ///< Stages that use the content of each stage (the first one renders it)
+    std::unordered_map<const Stage *, std::vector<Stage *>>       m_uses;          ///< Stages whose content each stage uses
+    std::unordered_set<const Stage *>                             m_exclusive;     ///< Stages that have lost content which was still needed and no longer share
+    size_t                                                        m_execution;     ///< Number of the current execution
+    size_t                                                        m_pooledMemory;  ///< Estimated video memory of all pooled render targets
+    size_t                                                        m_peakMemory;    ///< Maximum of m_pooledMemory
+};
+
+
+} // namespace gloperate
@@ -4,11 +4,9 @@
 
 #include <memory>
 
-#include <globjects/Buffer.h>
-
 #include <gloperate/rendering/Shape.h>
 #include <gloperate/rendering/Drawable.h>
-#include <gloperate/rendering/Icosahedron.h>
+#include <gloperate/rendering/GeometryCache.h>
 
 
 namespace gloperate
@@ -18,6 +16,9 @@ namespace gloperate
 /**
 *  @brief
 *    Sphere drawable
+*
+*    The buffers of a refined icosahedron are shared between all spheres
+*    with the same radius and options in the same OpenGL context (see GeometryCache).
 */
 class GLOPERATE_API Sphere : public Shape
 {
@@ -30,8 +31,10 @@ public:
     *    Sphere radius
     *  @param[in] options
     *    Shape options
+    *  @param[in] context
+    *    OpenGL context in which the sphere is drawn (can be null, see GeometryCache)
     */
-    Sphere(float radius = 1.0f, cppassist::Flags<ShapeOption> options = ShapeOption::None);
+    Sphere(float radius = 1.0f, cppassist::Flags<ShapeOption> options = ShapeOption::None, const AbstractGLContext * context = nullptr);
 
     /**
     *  @brief
@@ -44,11 +47,8 @@ public:
 
 
 protected:
-    std::unique_ptr<Icosahedron>       m_icosahedron; ///< Refinable icosahedron
-    std::unique_ptr<Drawable>          m_drawable;    ///< Underlying drawable object
-    std::unique_ptr<globjects::Buffer> m_vertices;    ///< Vertex buffer
-    std::unique_ptr<globjects::Buffer> m_texCoords;   ///< Texture coordinate buffer
-    std::unique_ptr<globjects::Buffer> m_indices;     ///< Index buffer
+    std::shared_ptr<const GeometryCache::Geometry> m_geometry; ///< Shared geometry
+    std::unique_ptr<Drawable>                      m_drawable; ///< Underlying drawable object
 };
 
 
@@ -0,0 +1,191 @@
+
+#pragma once
+
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace globjects
+{
+    class Buffer;
+    class Sync;
+}
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Ring buffer for data that is streamed to the GPU every frame
+*
+*    Ranges of the buffer are handed out in a circular fashion and can be
+*    written to directly by the CPU. If OpenGL 4.4 or GL_ARB_buffer_storage
+*    is available, the buffer is persistently mapped and no copies or
+*    buffer (re-)allocations take place at all. A range is reused only
+*    after the GPU has passed the fence that was inserted after the commands
+*    reading the range, so the CPU never overwrites data that is still in use.
+*
+*    Without persistent mapping, the ranges point into a CPU copy of the
+*    buffer, which is uploaded by flush().
+*
+*    Usage per update:
+*    @code
+*      streamingBuffer.fence();   // commands of the last update have been issued
+*      auto data = streamingBuffer.allocate(size, alignment, offset);
+*      // write data, then
+*      streamingBuffer.flush();
+*      // use range [offset, offset + size) of streamingBuffer.buffer()
+*    @endcode
+*/
+class GLOPERATE_API StreamingBuffer
+{
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] capacity
+    *    Size of the buffer (in bytes)
+    *
+    *  @remarks
+    *    Creates OpenGL objects, thus, a current context is required.
+    */
+    explicit StreamingBuffer(size_t capacity);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Destroys OpenGL objects, thus, a current context is required.
+    */
+    ~StreamingBuffer();
+
+    // No copying
+    StreamingBuffer(const StreamingBuffer &) = delete;
+    StreamingBuffer & operator=(const StreamingBuffer &) = delete;
+
+    /**
+    *  @brief
+    *    Get size of the buffer
+    *
+    *  @return
+    *    Size (in bytes)
+    */
+    size_t capacity() const;
+
+    /**
+    *  @brief
+    *    Recreate buffer with a new size
+    *
+    *  @param[in] capacity
+    *    Size of the buffer (in bytes)
+    *
+    *  @remarks
+    *    All previously allocated ranges become invalid.
+    */
+    void resize(size_t capacity);
+
+    /**
+    *  @brief
+    *    Check if the buffer is persistently mapped
+    *
+    *  @return
+    *    'true' if the allocated ranges are written directly to GPU memory, else 'false'
+    */
+    bool isPersistent() const;
+
+    /**
+    *  @brief
+    *    Get OpenGL buffer
+    *
+    *  @return
+    *    Buffer (always valid, but replaced by resize())
+    */
+    globjects::Buffer * buffer() const;
+
+    /**
+    *  @brief
+    *    Allocate range for writing
+    *
+    *  @param[in] size
+    *    Size of the range (in bytes)
+    *  @param[in] alignment
+    *    Alignment of the offset of the range (in bytes, must be greater than 0)
+    *  @param[out] offset
+    *    Offset of the range in the buffer (in bytes)
+    *
+    *  @return
+    *    Pointer to the range, null if the range does not fit into the buffer
+    *
+    *  @remarks
+    *    Waits until the GPU does not use the range anymore. The range must
+    *    not be used by OpenGL before flush() has been called. All ranges
+    *    allocated since the last call of fence() must fit into the buffer
+    *    at the same time, if they don't, null is returned and the buffer
+    *    should be resized.
+    */
+    void * allocate(size_t size, size_t alignment, size_t & offset);
+
+    /**
+    *  @brief
+    *    Make the data written to the allocated ranges available to OpenGL
+    */
+    void flush();
+
+    /**
+    *  @brief
+    *    Protect ranges allocated since the last fence until the GPU has executed all commands issued so far
+    *
+    *  @remarks
+    *    Call after all commands reading the ranges have been issued,
+    *    e.g., before allocating the ranges for the next frame.
+    */
+    void fence();
+
+
+protected:
+    /**
+    *  @brief
+    *    Ranges that are protected by the same fence
+    */
+    struct Segment
+    {
+        std::uint64_t                     begin; ///< Start position of the first range
+        std::unique_ptr<globjects::Sync>  sync;  ///< Fence after the commands using the ranges
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Wait until the GPU has passed the fence of a segment
+    *
+    *  @param[in] segment
+    *    Segment
+    */
+    static void wait(const Segment & segment);
+
+
+protected:
+    std::unique_ptr<globjects::Buffer> m_buffer;      ///< OpenGL buffer
+    size_t                             m_capacity;    ///< Size of the buffer (in bytes)
+    bool                               m_persistent;  ///< 'true' if the buffer is persistently mapped, else 'false'
+    char                             * m_data;        ///< Persistently mapped data (null if not persistent)
+    std::vector<char>                  m_staging;     ///< CPU copy of the buffer (empty if persistent)
+    std::uint64_t                      m_position;    ///< End of the last allocated range (monotonically increasing, offset is position modulo capacity)
+    std::uint64_t                      m_fenced;      ///< End of the ranges that are protected by a fence
+    size_t                             m_dirtyBegin;  ///< Start of the range of the staging copy that has to be uploaded
+    size_t                             m_dirtyEnd;    ///< End of the range of the staging copy that has to be uploaded
+    std::deque<Segment>                m_segments;    ///< Fenced segments, oldest first
+};
+
+
+} // namespace gloperate
@@ -0,0 +1,165 @@
+
+#pragma once
+
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <glbinding/gl/types.h>
+
+#include <gloperate/gloperate_api.h>
+
+
+namespace gloperate
+{
+
+
+/**
+*  @brief
+*    Ring of GPU timestamp query pairs that are read without stalling
+*
+*    Each measurement records a GL_TIMESTAMP query before and after the
+*    measured commands. Results are only read by poll() once OpenGL reports
+*    them as available, so the CPU never waits for the GPU. If the GPU falls
+*    behind by more measurements than there are slots, new measurements are
+*    dropped instead of waiting for a slot.
+*/
+class GLOPERATE_API TimerQueryRing
+{
+public:
+    /**
+    *  @brief
+    *    Callback for measured results
+    *
+    *  @param[in] value
+    *    Value passed to end()
+    *  @param[in] start
+    *    GPU timestamp before the measured commands (in nanoseconds)
+    *  @param[in] end
+    *    GPU timestamp after the measured commands (in nanoseconds)
+    */
+    using Callback = std::function<void(std::uint64_t value, gl::GLuint64 start, gl::GLuint64 end)>;
+
+
+public:
+    /**
+    *  @brief
+    *    Constructor
+    *
+    *  @param[in] size
+    *    Number of measurements that can be pending at the same time (must be greater than 0)
+    *
+    *  @remarks
+    *    Creates OpenGL objects, thus, a current context is required.
+    */
+    explicit TimerQueryRing(size_t size = 8);
+
+    /**
+    *  @brief
+    *    Destructor
+    *
+    *  @remarks
+    *    Destroys OpenGL objects, thus, a current context is required.
+    */
+    ~TimerQueryRing();
+
+    // No copying
+    TimerQueryRing(const TimerQueryRing &) = delete;
+    TimerQueryRing & operator=(const TimerQueryRing &) = delete;
+
+    /**
+    *  @brief
+    *    Get number of slots
+    *
+    *  @return
+    *    Number of measurements that can be pending at the same time
+    */
+    size_t size() const;
+
+    /**
+    *  @brief
+    *    Get number of pending measurements
+    *
+    *  @return
+    *    Number of measurements whose results have not been polled yet
+    */
+    size_t pending() const;
+
+    /**
+    *  @brief
+    *    Get number of dropped measurements
+    *
+    *  @return
+    *    Number of calls to begin() that failed because all slots were pending
+    */
+    size_t dropped() const;
+
+    /**
+    *  @brief
+    *    Start measurement
+    *
+    *  @return
+    *    'true' if the measurement has been started, 'false' if all slots are pending
+    */
+    bool begin();
+
+    /**
+    *  @brief
+    *    Stop measurement
+    *
+    *  @param[in] value
+    *    Value that is passed to the callback of poll() with the result, e.g., the CPU time of the measured code
+    *
+    *  @remarks
+    *    Does nothing if no measurement has been started.
+    */
+    void end(std::uint64_t value = 0);
+
+    /**
+    *  @brief
+    *    Read available results
+    *
+    *  @param[in] callback
+    *    Function that is called for each available result, oldest first
+    *
+    *  @return
+    *    Number of results that have been read
+    */
+    size_t poll(const Callback & callback);
+
+    /**
+    *  @brief
+    *    Ignore the results of all pending measurements
+    *
+    *  @remarks
+    *    This function does not use OpenGL, the slots are released by the next poll().
+    */
+    void discard();
+
+
+protected:
+    /**
+    *  @brief
+    *    Measurement slot
+    */
+    struct Slot
+    {
+        gl::GLuint    startQuery; ///< Timestamp query before the measured commands
+        gl::GLuint    endQuery;   ///< Timestamp query after the measured commands
+        std::uint64_t value;      ///< Value passed to end()
+        bool          discarded;  ///< 'true' if the result is ignored, else 'false'
+    };
+
+
+protected:
+    std::vector<Slot> m_slots;   ///< Measurement slots
+    size_t            m_first;   ///< Index of the oldest pending slot
+    size_t            m_pending; ///< Number of pending slots
+    bool              m_active;  ///< 'true' if a measurement has been started, else 'false'
+    size_t            m_dropped; ///< Number of dropped measurements
+};
+
+
+} // namespace gloperate
@@ -14,6 +14,7 @@
 namespace globjects
 {
     class Program;
+    class ProgramBinary;
     class Shader;
 }
 
@@ -32,6 +33,11 @@ namespace gloperate
 *    Stage that creates a program from multiple shaders
 *
 *    It expects input of pointers to globjects::Shader or cppassist::FilePath objects.
+*
+*    The program is linked when the stage is processed. If the program binary
+*    cache of the environment contains a binary for the same shader sources,
+*    the program is restored from it without compiling and linking the shaders,
+*    in which case no shaders are attached to the program.
 */
 class GLOPERATE_API ProgramStage : public Stage
 {
@@ -82,8 +88,9 @@ protected:
 
 protected:
     // OpenGL objects
+    std::unique_ptr<globjects::ProgramBinary>       m_binary;  ///< Binary from which the program has been restored (can be null)
     std::unique_ptr<globjects::Program>             m_program; ///< Program object
-    std::vector<std::unique_ptr<globjects::Shader>> m_shaders; ///< collection of self created shaders for later removal
+    std::vector<std::unique_ptr<globjects::Shader>> m_shaders; ///< Shaders loaded from the FilePath inputs
 
     // Signal connections
     cppexpose::ScopedConnection m_inputAddedConnection;
@@ -32,6 +32,11 @@ class StencilRenderTarget;
 /**
 *  @brief
 *    Stage that creates an empty render buffer with a specified size and format as render target
+*
+*    If the stage is declared as transient, the renderbuffer is obtained from
+*    the RenderTargetPool of the pipeline and shares its memory with the
+*    renderbuffers of other stages that are used at different times in the
+*    execution plan.
 */
 class GLOPERATE_API RenderbufferRenderTargetStage : public gloperate::Stage
 {
@@ -51,6 +56,7 @@ public:
     // Inputs
     Input<gl::GLenum> internalFormat;     ///< OpenGL internal image format
     Input<glm::vec4>  size;               ///< Viewport size (only z and w component is used as width and height)
+    Input<bool>       transient;          ///< Obtain renderbuffer from the render target pool of the pipeline, so it can be shared with other stages
 
     // Outputs
     Output<globjects::Renderbuffer *>        renderbuffer;        ///< Renderbuffer
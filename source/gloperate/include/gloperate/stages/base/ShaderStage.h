@@ -26,6 +26,8 @@ namespace gloperate
 /**
 *  @brief
 *    Stage that loads and creates a shader from a file path
+*
+*    The shader object is only replaced if the content of the file has changed.
 */
 class GLOPERATE_API ShaderStage : public Stage
 {
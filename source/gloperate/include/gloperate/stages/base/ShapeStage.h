@@ -78,7 +78,8 @@ protected:
 
 
 protected:
-    std::unique_ptr<gloperate::Shape> m_shape; ///< The generated shape
+    std::unique_ptr<gloperate::Shape>    m_shape;   ///< The generated shape
+    const gloperate::AbstractGLContext * m_context; ///< OpenGL context in which the shape is created
 };
 
 
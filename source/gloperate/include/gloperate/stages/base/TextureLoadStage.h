@@ -10,6 +10,7 @@
 
 #include <gloperate/gloperate-version.h>
 #include <gloperate/base/ExtendedProperties.h>
+#include <gloperate/base/ResourceRequest.h>
 #include <gloperate/pipeline/Stage.h>
 #include <gloperate/pipeline/Input.h>
 #include <gloperate/pipeline/Output.h>
@@ -22,6 +23,11 @@ namespace gloperate
 /**
 *  @brief
 *    Stage that loads a texture from a file
+*
+*    If 'asynchronous' is set, the file is decoded on a worker thread and
+*    the previous texture, or an empty one, is provided in the meantime.
+*    The stage is processed every frame until the texture has been loaded,
+*    so this is meant for canvases that are redrawn continuously.
 */
 class GLOPERATE_API TextureLoadStage : public Stage
 {
@@ -39,10 +45,11 @@ public:
 
 public:
     // Inputs
-    Input<cppassist::FilePath>   filename; ///< Texture filename
+    Input<cppassist::FilePath>   filename;     ///< Texture filename
+    Input<bool>                  asynchronous; ///< Load texture in the background?
 
     // Outputs
-    Output<globjects::Texture *> texture;  ///< Texture object
+    Output<globjects::Texture *> texture;      ///< Texture object
 
 
 public:
@@ -72,7 +79,9 @@ protected:
 
 
 protected:
-    std::unique_ptr<globjects::Texture> m_texture; ///< Texture
+    std::unique_ptr<globjects::Texture>   m_texture;         ///< Texture
+    ResourceRequest<globjects::Texture>   m_request;         ///< Pending request for the texture
+    std::string                           m_requestedPath;   ///< File name of the pending request
 };
 
 
@@ -32,6 +32,10 @@ class StencilRenderTarget;
 /**
 *  @brief
 *    Stage that creates an empty texture with a specified size and format as render target
+*
+*    If the stage is declared as transient, the texture is obtained from the
+*    RenderTargetPool of the pipeline and shares its memory with the textures
+*    of other stages that are used at different times in the execution plan.
 */
 class GLOPERATE_API TextureRenderTargetStage : public gloperate::Stage
 {
@@ -53,6 +57,7 @@ public:
     Input<gl::GLenum> format;         ///< OpenGL image format
     Input<gl::GLenum> type;           ///< OpenGL data type
     Input<glm::vec4>  size;           ///< Viewport size (only z and w component is used as width and height)
+    Input<bool>       transient;      ///< Obtain texture from the render target pool of the pipeline, so it can be shared with other stages
 
     // Outputs
     Output<globjects::Texture *>             texture;             ///< Texture
@@ -2,11 +2,17 @@
 #pragma once
 
 
+#include <vector>
+#include <memory>
+
+#include <glbinding/gl/types.h>
+
 #include <gloperate/gloperate_api.h>
 
 #include <gloperate/pipeline/Input.h>
 #include <gloperate/pipeline/Output.h>
 #include <gloperate/base/ExtendedProperties.h>
+#include <gloperate/rendering/RenderTargetType.h>
 
 
 namespace globjects
@@ -42,6 +48,10 @@ class StencilRenderTarget;
 *    The viewport is initialized with an invalid width and height (i.e., -1.0
 *    per component) which results in no rendering for rasterization stages and
 *    full clearing for clear stages.
+*
+*    The framebuffers configured by obtainFBO() are cached by the combination
+*    of attached render targets, so switching between configurations that have
+*    been used before does not require any attachment or draw buffer changes.
 */
 class GLOPERATE_API RenderInterface
 {
@@ -100,9 +110,33 @@ public:
     *
     *  @remarks
     *    allRenderTargetsCompatible() is expected to return 'true'.
+    *
+    *    For each combination of render targets, a separate framebuffer is
+    *    configured once and reused on subsequent calls. Render targets are
+    *    identified by their generation (see AbstractRenderTarget::generation()),
+    *    so a configuration is never reused for a new texture or renderbuffer
+    *    that happens to have the address of a destroyed one.
     */
     globjects::Framebuffer * obtainFBO() const;
 
+    /**
+    *  @brief
+    *    Get number of calls of obtainFBO() that reused a cached framebuffer configuration
+    *
+    *  @return
+    *    Number of cache hits
+    */
+    size_t fboCacheHits() const;
+
+    /**
+    *  @brief
+    *    Get number of calls of obtainFBO() that had to configure a framebuffer
+    *
+    *  @return
+    *    Number of cache misses
+    */
+    size_t fboCacheMisses() const;
+
     /**
     *  @brief
     *    Get a configured framebuffer containing one render target as attachment
@@ -484,6 +518,55 @@ public:
     void onContextDeinit();
 
 
+protected:
+    /**
+    *  @brief
+    *    Render target attached to a framebuffer configuration
+    */
+    struct AttachmentKey
+    {
+        RenderTargetType type;       ///< Type of the render target
+        size_t           generation; ///< Generation of the render target (see AbstractRenderTarget::generation(), 0 if there is no render target)
+        gl::GLenum       attachment; ///< Attachment point
+        gl::GLenum       drawBuffer; ///< Draw buffer (GL_NONE for non-color attachments)
+
+        bool operator==(const AttachmentKey & other) const;
+    };
+
+    /**
+    *  @brief
+    *    Cached framebuffer configuration
+    */
+    struct FBOConfiguration
+    {
+        std::vector<AttachmentKey>              attachments; ///< Attached render targets
+        std::vector<gl::GLenum>                 drawBuffers; ///< Draw buffers of the color attachments
+        std::unique_ptr<globjects::Framebuffer> fbo;         ///< Configured framebuffer (null if the default framebuffer is used)
+        globjects::Framebuffer                * result;      ///< Framebuffer returned by obtainFBO() (can be null)
+        size_t                                  lastUse;     ///< Value of the use counter when the configuration was last used
+    };
+
+
+protected:
+    /**
+    *  @brief
+    *    Collect render targets of all inputs
+    *
+    *  @param[out] attachments
+    *    Attached render targets
+    */
+    void collectAttachments(std::vector<AttachmentKey> & attachments) const;
+
+    /**
+    *  @brief
+    *    Configure a new framebuffer for the current render targets
+    *
+    *  @return
+    *    New configuration (never null)
+    */
+    std::unique_ptr<FBOConfiguration> createConfiguration() const;
+
+
 protected:
     std::unique_ptr<globjects::Framebuffer>           m_defaultFBO;                      ///< Default FBO for configuration
     std::unique_ptr<globjects::Framebuffer>           m_fbo;                             ///< Intermediate FBO for configuration
@@ -495,6 +578,12 @@ protected:
     std::vector<Output<DepthRenderTarget        *> *> m_depthRenderTargetOutputs;        ///< List of output depth render targets (pass-through)
     std::vector<Output<DepthStencilRenderTarget *> *> m_depthStencilRenderTargetOutputs; ///< List of output depth-stencil render targets (pass-through)
     std::vector<Output<StencilRenderTarget      *> *> m_stencilRenderTargetOutputs;      ///< List of output stencil render targets (pass-through)
+
+    mutable std::vector<std::unique_ptr<FBOConfiguration>> m_fboConfigurations; ///< Cached framebuffer configurations
+    mutable std::vector<AttachmentKey>                     m_attachments;       ///< Render targets of the current call (reused to avoid allocations)
+    mutable size_t                                         m_fboUseCounter;     ///< Incremented with each call of obtainFBO()
+    mutable size_t                                         m_fboCacheHits;      ///< Number of cache hits
+    mutable size_t                                         m_fboCacheMisses;    ///< Number of cache misses
 };
 
 
@@ -2,6 +2,14 @@
 #pragma once
 
 
+#include <vector>
+#include <memory>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <glbinding/gl/types.h>
+
 #include <cppexpose/plugin/plugin_api.h>
 
 #include <gloperate/gloperate-version.h>
@@ -12,7 +20,6 @@
 namespace globjects
 {
     class Texture;
-    class Buffer;
 }
 
 
@@ -21,11 +28,17 @@ namespace gloperate
 
 
 struct Light;
+class StreamingBuffer;
 
 
 /**
 *  @brief
 *    Stage that takes Light objects as inputs and creates texture buffers containing information of all lights
+*
+*    Only the lights whose inputs have changed are updated. The light data is
+*    written to ranges of a persistently mapped ring buffer (see StreamingBuffer),
+*    to which the buffer textures refer, so processing the stage neither allocates
+*    memory nor stalls on buffers that are still in use by the GPU.
 */
 class GLOPERATE_API LightBufferTextureStage : public Stage
 {
@@ -85,16 +98,35 @@ protected:
     // Helper functions
     void setupBufferTextures();
 
+    /**
+    *  @brief
+    *    Update light data from the light inputs
+    *
+    *  @return
+    *    'true' if any light data has been changed, else 'false'
+    */
+    bool updateLights();
+
+    /**
+    *  @brief
+    *    Write light data to the streaming buffer and update the buffer textures
+    */
+    void uploadLights();
+
 
 protected:
     std::unique_ptr<globjects::Texture> m_colorTypeTexture;   ///< Buffer texture for color & type information
     std::unique_ptr<globjects::Texture> m_positionTexture;    ///< Buffer texture for position information
     std::unique_ptr<globjects::Texture> m_attenuationTexture; ///< Buffer texture for attenuation information
-    std::unique_ptr<globjects::Buffer>  m_colorTypeBuffer;    ///< Buffer for color & type information
-    std::unique_ptr<globjects::Buffer>  m_positionBuffer;     ///< Buffer for position information
-    std::unique_ptr<globjects::Buffer>  m_attenuationBuffer;  ///< Buffer for attenuation information
-
-    std::vector< Input<Light> * > m_lightInputs; ///< Light inputs
+    std::unique_ptr<StreamingBuffer>    m_streamingBuffer;    ///< Ring buffer containing the light data referenced by the buffer textures
+    gl::GLint                           m_offsetAlignment;    ///< Required alignment of buffer texture offsets (in bytes)
+    bool                                m_uploaded;           ///< 'true' if the buffer textures refer to the current light data, else 'false'
+
+    std::vector< Input<Light> * > m_lightInputs;  ///< Light inputs
+    std::vector<bool>             m_lightValid;   ///< Validity of each light input at the last update
+    std::vector<glm::vec4>        m_colorsTypes;  ///< Color (RGB) and type (alpha) of valid lights
+    std::vector<glm::vec3>        m_positions;    ///< Positions of valid lights
+    std::vector<glm::vec3>        m_attenuations; ///< Attenuation coefficients of valid lights
 };
 
 
@@ -6,6 +6,8 @@
 #include <globjects/globjects.h>
 #include <globjects/DebugMessage.h>
 
+#include <gloperate/rendering/GeometryCache.h>
+
 
 namespace gloperate
 {
@@ -17,6 +19,8 @@ AbstractGLContext::AbstractGLContext()
 
 AbstractGLContext::~AbstractGLContext()
 {
+    // Forget shared geometry of this context
+    GeometryCache::releaseContext(this);
 }
 
 const GLContextFormat & AbstractGLContext::format() const
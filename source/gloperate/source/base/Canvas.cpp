@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <algorithm>
+#include <unordered_map>
 
 #include <glm/glm.hpp>
 
@@ -19,6 +20,7 @@
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/ComponentManager.h>
 #include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/PipelineSnapshot.h>
 #include <gloperate/pipeline/Slot.h>
 #include <gloperate/input/MouseDevice.h>
 #include <gloperate/input/KeyboardDevice.h>
@@ -40,6 +42,112 @@ namespace
 
 auto s_nextCanvasId = size_t(0);
 
+const size_t s_commandQueueCapacity = 256; ///< Number of updates that can be queued while a frame is rendered
+
+
+// Pipeline edits shared by the single scripting functions and batches (the canvas must be locked)
+
+std::string createStageIn(gloperate::Environment * environment, gloperate::Stage * stage, const std::string & name, const std::string & type)
+{
+    if (!stage || !stage->isPipeline())
+    {
+        return "";
+    }
+
+    auto pipeline = static_cast<gloperate::Pipeline *>(stage);
+
+    // Get component for the requested stage
+    auto component = environment->componentManager()->component<gloperate::Stage>(type);
+    if (!component)
+    {
+        return "";
+    }
+
+    // Create stage
+    auto newStage = component->createInstance(environment, name);
+    auto stagePtr = newStage.get();
+
+    pipeline->addStage(std::move(newStage));
+
+    return stagePtr->name();
+}
+
+bool removeStageFrom(gloperate::Stage * stage, const std::string & name)
+{
+    if (!stage || !stage->isPipeline())
+    {
+        return false;
+    }
+
+    auto pipeline = static_cast<gloperate::Pipeline *>(stage);
+
+    return pipeline->removeStage(pipeline->stage(name));
+}
+
+bool createSlotOn(gloperate::Stage * stage, const std::string & slot, const std::string & slotType, const std::string & type)
+{
+    if (!stage)
+    {
+        return false;
+    }
+
+    return stage->createSlot(slotType, type, slot) != nullptr;
+}
+
+bool connectSlots(gloperate::Stage * sourceStage, const std::string & sourceSlot, gloperate::Stage * destStage, const std::string & destSlot)
+{
+    if (!sourceStage || !destStage)
+    {
+        return false;
+    }
+
+    auto slotFrom = sourceStage->getSlot(sourceSlot);
+    auto slotTo   = destStage->getSlot(destSlot);
+
+    return slotFrom && slotTo && slotTo->connect(slotFrom);
+}
+
+bool disconnectSlot(gloperate::Stage * stage, const std::string & slot)
+{
+    auto slotTo = stage ? stage->getSlot(slot) : nullptr;
+    if (!slotTo)
+    {
+        return false;
+    }
+
+    slotTo->disconnect();
+    return true;
+}
+
+cppexpose::Variant slotValue(gloperate::Stage * stage, const std::string & slot)
+{
+    auto abstractSlot = stage ? stage->getSlot(slot) : nullptr;
+    if (!abstractSlot)
+    {
+        return cppexpose::Variant();
+    }
+
+    return abstractSlot->toVariant();
+}
+
+bool setSlotValue(gloperate::Stage * stage, const std::string & slot, const cppexpose::Variant & value)
+{
+    auto abstractSlot = stage ? stage->getSlot(slot) : nullptr;
+    if (!abstractSlot)
+    {
+        return false;
+    }
+
+    abstractSlot->fromVariant(value);
+    return true;
+}
+
+std::string stringArgument(const cppexpose::VariantMap & operation, const std::string & key)
+{
+    const auto it = operation.find(key);
+    return it != operation.end() ? it->second.toString() : "";
+}
+
 
 }
 
@@ -58,10 +166,18 @@ Canvas::Canvas(Environment * environment)
 , m_mouseDevice(cppassist::make_unique<MouseDevice>(m_environment->inputManager(), m_name))
 , m_keyboardDevice(cppassist::make_unique<KeyboardDevice>(m_environment->inputManager(), m_name))
 , m_replaceStage(false)
+, m_commands(s_commandQueueCapacity)
+, m_inputPending(false)
+, m_inputLatency(0)
 , m_colorTarget(cppassist::make_unique<ColorRenderTarget>())
 , m_depthTarget(cppassist::make_unique<DepthRenderTarget>())
 , m_depthStencilTarget(cppassist::make_unique<DepthStencilRenderTarget>())
 , m_stencilTarget(cppassist::make_unique<StencilRenderTarget>())
+, m_slotStage(nullptr)
+, m_slotRevision(0)
+, m_timeDeltaInput(nullptr)
+, m_viewportInput(nullptr)
+, m_viewportOutput(nullptr)
 {
     // Register functions
     addFunction("onStageInputChanged", this, &Canvas::scr_onStageInputChanged);
@@ -76,6 +192,9 @@ Canvas::Canvas(Environment * environment)
     addFunction("getSlot",             this, &Canvas::scr_getSlot);
     addFunction("getValue",            this, &Canvas::scr_getValue);
     addFunction("setValue",            this, &Canvas::scr_setValue);
+    addFunction("batch",               this, &Canvas::scr_batch);
+    addFunction("saveSnapshot",        this, &Canvas::scr_saveSnapshot);
+    addFunction("loadSnapshot",        this, &Canvas::scr_loadSnapshot);
 
     // Register canvas
     m_environment->registerCanvas(this);
@@ -115,6 +234,9 @@ void Canvas::setRenderStage(std::unique_ptr<Stage> && stage)
     // Set stage
     m_renderStage = std::move(stage);
 
+    // Look up slots of the new stage on the next use
+    m_slotStage = nullptr;
+
     // Connect to changes on the stage's input slots
     m_inputChangedConnection = m_renderStage->inputChanged.connect(this, &Canvas::stageInputChanged);
 
@@ -184,8 +306,6 @@ void Canvas::setOpenGLContext(AbstractGLContext * context)
 
 void Canvas::updateTime()
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     // In multithreaded viewers, updateTime() might get called several times
     // before render(). Therefore, the time delta is accumulated until the
     // pipeline is actually rendered, and then reset by the method render().
@@ -196,46 +316,23 @@ void Canvas::updateTime()
 
     // Determine time delta and virtual time
     float timeDelta = std::chrono::duration_cast<std::chrono::duration<float>>(duration).count();
-    m_timeDelta += timeDelta;
-
-    if (!m_renderStage)
-    {
-        return;
-    }
 
-    // Update timing
-    auto slotTimeDelta = m_renderStage->findInput<float>([](Input<float>* input) { return input->name() == "timeDelta"; });
-    if (slotTimeDelta)
-    {
-        slotTimeDelta->setValue(m_timeDelta);
-    }
+    Command command;
+    command.type      = Command::Type::TimeDelta;
+    command.timeDelta = timeDelta;
+    pushCommand(command);
 
-    // Check if a redraw is required
-    checkRedraw();
-
-    // Promote changed input value to scripting
-    promoteChangedInputs();
+    tryApplyCommands();
 }
 
 void Canvas::setViewport(const glm::vec4 & deviceViewport)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
+    Command command;
+    command.type     = Command::Type::Viewport;
+    command.viewport = deviceViewport;
+    pushCommand(command);
 
-    // Store viewport information
-    m_viewport  = deviceViewport;
-    m_initialized = true;
-
-    if (!m_renderStage)
-    {
-        return;
-    }
-
-    // Promote new viewport
-    auto slotViewport = m_renderStage->findInput<glm::vec4>([](Input<glm::vec4>* input) { return input->name() == "viewport"; });
-    if (slotViewport) slotViewport->setValue(m_viewport);
-
-    // Check if a redraw is required
-    checkRedraw();
+    tryApplyCommands();
 }
 
 const glm::vec4 & Canvas::viewport() const
@@ -247,7 +344,10 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    // Reset time delta
+    // Apply updates that have been queued since the last frame
+    applyCommands();
+
+    // Reset time delta, the time of the next frame is accumulated from now on
     m_timeDelta = 0.0f;
 
     auto fboName = targetFBO->hasName() ? targetFBO->name() : std::to_string(targetFBO->id());
@@ -275,14 +375,16 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         // Initialize stage
         m_renderStage->initContext(m_openGLContext);
 
+        updateSlots();
+
         // Promote viewport information
-        auto slotViewport = m_renderStage->findInput<glm::vec4>([](Input<glm::vec4>* input) { return input->name() == "viewport"; });
-        if (slotViewport) slotViewport->setValue(m_viewport);
+        if (m_viewportInput) m_viewportInput->setValue(m_viewport);
 
         // Mark output as required
-        m_renderStage->forAllOutputs<ColorRenderTarget *>([](Output<ColorRenderTarget *> * output) {
+        for (auto output : m_colorTargetOutputs)
+        {
             output->setRequired(true);
-        });
+        }
 
         // Replace finished
         m_replaceStage = false;
@@ -342,32 +444,45 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
         }
     }
 
+    updateSlots();
+
     // Update render stage input render targets
-    m_renderStage->forAllInputs<gloperate::ColorRenderTarget *>([this](Input<ColorRenderTarget *> * input) {
+    for (auto input : m_colorTargetInputs)
+    {
         input->setValue(m_colorTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::DepthRenderTarget *>([this](Input<DepthRenderTarget *> * input) {
+    }
+    for (auto input : m_depthTargetInputs)
+    {
         input->setValue(m_depthTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::DepthStencilRenderTarget *>([this](Input<DepthStencilRenderTarget *> * input) {
+    }
+    for (auto input : m_depthStencilTargetInputs)
+    {
         input->setValue(m_depthStencilTarget.get());
-    });
-    m_renderStage->forAllInputs<gloperate::StencilRenderTarget *>([this](Input<StencilRenderTarget *> * input) {
+    }
+    for (auto input : m_stencilTargetInputs)
+    {
         input->setValue(m_stencilTarget.get());
-    });
+    }
 
     // Render
     m_renderStage->process();
 
-    auto colorOutput = m_renderStage->findOutput<gloperate::ColorRenderTarget *>([this](Output<ColorRenderTarget *> * output) {
-        return **output != nullptr;
-    });
+    // Processing may have changed the interface of the render stage
+    updateSlots();
+
+    Output<ColorRenderTarget *> * colorOutput = nullptr;
+    for (auto output : m_colorTargetOutputs)
+    {
+        if (**output != nullptr)
+        {
+            colorOutput = output;
+            break;
+        }
+    }
 
     if (colorOutput)
     {
-        const auto viewport = m_renderStage->findOutput<glm::vec4>([this](Output<glm::vec4> *) {
-            return true;
-        });
+        const auto viewport = m_viewportOutput;
 
         const auto viewportDiffering = viewport && glm::distance(**viewport, m_viewport) > glm::epsilon<float>();
         const auto colorOutputDiffering = **colorOutput != m_colorTarget.get();
@@ -381,84 +496,188 @@ void Canvas::render(globjects::Framebuffer * targetFBO)
             m_blitStage->process();
         }
     }
+
+    // Measure time from the oldest input event until the frame has been submitted
+    if (m_inputPending)
+    {
+        const auto latency = std::chrono::steady_clock::now() - m_inputTime;
+        m_inputLatency = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+        m_inputPending = false;
+
+        debug(3, "gloperate") << "input latency: " << std::chrono::duration_cast<std::chrono::microseconds>(latency).count() << " us";
+    }
 }
 
-void Canvas::promoteKeyPress(int key, int modifier)
+std::chrono::nanoseconds Canvas::inputLatency() const
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return std::chrono::nanoseconds(m_inputLatency.load());
+}
 
+void Canvas::promoteKeyPress(int key, int modifier)
+{
     debug(2, "gloperate") << "keyPressed(" << key << ", " << modifier << ")";
 
     // Promote keyboard event
     m_keyboardDevice->keyPress(key, modifier);
 
-    // Check if a redraw is required
-    checkRedraw();
+    // Dispatch event
+    queueInput();
 }
 
 void Canvas::promoteKeyRelease(int key, int modifier)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     debug(2, "gloperate") << "keyReleased(" << key << ", " << modifier << ")";
 
     // Promote keyboard event
     m_keyboardDevice->keyRelease(key, modifier);
 
-    // Check if a redraw is required
-    checkRedraw();
+    // Dispatch event
+    queueInput();
 }
 
 void Canvas::promoteMouseMove(const glm::ivec2 & pos)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     debug(2, "gloperate") << "mouseMoved(" << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
     m_mouseDevice->move(pos);
 
-    // Check if a redraw is required
-    checkRedraw();
+    // Dispatch event
+    queueInput();
 }
 
 void Canvas::promoteMousePress(int button, const glm::ivec2 & pos)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     debug(2, "gloperate") << "mousePressed(" << button << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
     m_mouseDevice->buttonPress(button, pos);
 
-    // Check if a redraw is required
-    checkRedraw();
+    // Dispatch event
+    queueInput();
 }
 
 void Canvas::promoteMouseRelease(int button, const glm::ivec2 & pos)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     debug(2, "gloperate") << "mouseReleased(" << button << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
     m_mouseDevice->buttonRelease(button, pos);
 
-    // Check if a redraw is required
-    checkRedraw();
+    // Dispatch event
+    queueInput();
 }
 
 void Canvas::promoteMouseWheel(const glm::vec2 & delta, const glm::ivec2 & pos)
 {
-    std::lock_guard<std::mutex> lock(this->m_mutex);
-
     debug(2, "gloperate") << "mouseWheel(" << delta.x << ", " << delta.y << ", " << pos.x << ", " << pos.y << ")";
 
     // Promote mouse event
     m_mouseDevice->wheelScroll(delta, pos);
 
+    // Dispatch event
+    queueInput();
+}
+
+void Canvas::queueInput()
+{
+    Command command;
+    command.type = Command::Type::Input;
+    pushCommand(command);
+
+    tryApplyCommands();
+}
+
+void Canvas::pushCommand(const Command & command)
+{
+    Command timedCommand = command;
+    timedCommand.time = std::chrono::steady_clock::now();
+
+    // If the render thread falls behind, apply the queued updates to make room
+    while (!m_commands.push(timedCommand))
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+
+        applyCommands();
+    }
+}
+
+void Canvas::tryApplyCommands()
+{
+    // Never wait for a frame that is currently rendered, it applies the updates itself
+    std::unique_lock<std::mutex> lock(this->m_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return;
+    }
+
+    applyCommands();
+
+    if (!m_renderStage)
+    {
+        return;
+    }
+
     // Check if a redraw is required
     checkRedraw();
+
+    // Promote changed input value to scripting
+    promoteChangedInputs();
+}
+
+void Canvas::applyCommands()
+{
+    auto timeChanged     = false;
+    auto viewportChanged = false;
+
+    Command command;
+    while (m_commands.pop(command))
+    {
+        switch (command.type)
+        {
+            case Command::Type::TimeDelta:
+                m_timeDelta += command.timeDelta;
+                timeChanged = true;
+                break;
+
+            case Command::Type::Viewport:
+                m_viewport      = command.viewport;
+                m_initialized   = true;
+                viewportChanged = true;
+                break;
+
+            case Command::Type::Input:
+                // Latency is measured from the oldest event that has not been rendered
+                if (!m_inputPending)
+                {
+                    m_inputTime    = command.time;
+                    m_inputPending = true;
+                }
+                break;
+        }
+    }
+
+    // Dispatch input events that have been queued since the last frame
+    m_environment->inputManager()->processEvents();
+
+    if (!m_renderStage)
+    {
+        return;
+    }
+
+    updateSlots();
+
+    // Update timing
+    if (timeChanged && m_timeDeltaInput)
+    {
+        m_timeDeltaInput->setValue(m_timeDelta);
+    }
+
+    // Promote new viewport
+    if (viewportChanged && m_viewportInput)
+    {
+        m_viewportInput->setValue(m_viewport);
+    }
 }
 
 void Canvas::checkRedraw()
@@ -468,13 +687,17 @@ void Canvas::checkRedraw()
         return;
     }
 
+    updateSlots();
+
     bool redraw = false;
-    m_renderStage->forAllOutputs<ColorRenderTarget *>([& redraw](Output<ColorRenderTarget *> * output) {
+    for (auto output : m_colorTargetOutputs)
+    {
         if (**output && !output->isValid())
         {
             redraw = true;
+            break;
         }
-    });
+    }
 
     if (redraw)
     {
@@ -564,60 +787,21 @@ std::string Canvas::scr_createStage(const std::string & path, const std::string
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-
-    if (stage && stage->isPipeline())
-    {
-        Pipeline * pipeline = static_cast<Pipeline*>(stage);
-
-        // Get component manager
-        auto componentManager = m_environment->componentManager();
-
-        // Get component for the requested stage
-        auto component = componentManager->component<gloperate::Stage>(type);
-        if (component)
-        {
-            // Create stage
-            auto stage = component->createInstance(m_environment, name);
-            auto stagePtr = stage.get();
-
-            pipeline->addStage(std::move(stage));
-
-            return stagePtr->name();
-        }
-    }
-
-    return "";
+    return createStageIn(m_environment, getStageObject(path), name, type);
 }
 
 void Canvas::scr_removeStage(const std::string & path, const std::string & name)
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-
-    if (stage && stage->isPipeline())
-    {
-        Pipeline * pipeline = static_cast<Pipeline*>(stage);
-
-        Stage * targetStage = pipeline->stage(name);
-        if (targetStage)
-        {
-            pipeline->removeStage(targetStage);
-        }
-    }
+    removeStageFrom(getStageObject(path), name);
 }
 
 void Canvas::scr_createSlot(const std::string & path, const std::string & slot, const std::string & slotType, const std::string & type)
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-
-    if (stage)
-    {
-        stage->createSlot(slotType, type, slot);
-    }
+    createSlotOn(getStageObject(path), slot, slotType, type);
 }
 
 cppexpose::Variant Canvas::scr_getConnections(const std::string & path)
@@ -682,36 +866,14 @@ void Canvas::scr_createConnection(const std::string & sourcePath, const std::str
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * sourceStage = getStageObject(sourcePath);
-    Stage * destStage   = getStageObject(destPath);
-
-    if (sourceStage && destStage)
-    {
-        AbstractSlot * slotFrom = sourceStage->getSlot(sourceSlot);
-        AbstractSlot * slotTo   = destStage->getSlot(destSlot);
-
-        if (slotFrom && slotTo)
-        {
-            slotTo->connect(slotFrom);
-        }
-    }
+    connectSlots(getStageObject(sourcePath), sourceSlot, getStageObject(destPath), destSlot);
 }
 
 void Canvas::scr_removeConnection(const std::string & path, const std::string & slot)
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-
-    if (stage)
-    {
-        AbstractSlot * slotTo = stage->getSlot(slot);
-
-        if (slotTo)
-        {
-            slotTo->disconnect();
-        }
-    }
+    disconnectSlot(getStageObject(path), slot);
 }
 
 cppexpose::Variant Canvas::scr_getStage(const std::string & path)
@@ -778,32 +940,124 @@ cppexpose::Variant Canvas::scr_getValue(const std::string & path, const std::str
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-    if (stage)
+    return slotValue(getStageObject(path), slotName);
+}
+
+void Canvas::scr_setValue(const std::string & path, const std::string & slotName, const cppexpose::Variant & value)
+{
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    setSlotValue(getStageObject(path), slotName, value);
+}
+
+cppexpose::Variant Canvas::scr_batch(const cppexpose::Variant & operations)
+{
+    const auto list = operations.asArray();
+    if (!list)
     {
-        AbstractSlot * slot = stage->getSlot(slotName);
-        if (slot)
+        return cppexpose::Variant();
+    }
+
+    Variant results = Variant::array();
+    results.asArray()->reserve(list->size());
+
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    // Resolve each stage path once per batch. Unresolved paths are not
+    // cached, as the stage may be created by a later operation.
+    std::unordered_map<std::string, Stage *> stages;
+
+    const auto stageObject = [this, &stages] (const std::string & path) -> Stage *
+    {
+        const auto it = stages.find(path);
+        if (it != stages.end())
+        {
+            return it->second;
+        }
+
+        const auto stage = getStageObject(path);
+        if (stage)
+        {
+            stages.emplace(path, stage);
+        }
+
+        return stage;
+    };
+
+    for (const auto & operation : *list)
+    {
+        const auto args = operation.asMap();
+        const auto op   = args ? stringArgument(*args, "op") : "";
+
+        if (op == "setValue")
+        {
+            const auto value = args->find("value");
+            results.asArray()->push_back(value != args->end() && setSlotValue(stageObject(stringArgument(*args, "path")), stringArgument(*args, "slot"), value->second));
+        }
+        else if (op == "getValue")
+        {
+            results.asArray()->push_back(slotValue(stageObject(stringArgument(*args, "path")), stringArgument(*args, "slot")));
+        }
+        else if (op == "createConnection")
+        {
+            results.asArray()->push_back(connectSlots(
+                stageObject(stringArgument(*args, "sourcePath")), stringArgument(*args, "sourceSlot"),
+                stageObject(stringArgument(*args, "destPath")),   stringArgument(*args, "destSlot")
+            ));
+        }
+        else if (op == "removeConnection")
         {
-            return slot->toVariant();
+            results.asArray()->push_back(disconnectSlot(stageObject(stringArgument(*args, "path")), stringArgument(*args, "slot")));
+        }
+        else if (op == "createStage")
+        {
+            results.asArray()->push_back(createStageIn(m_environment, stageObject(stringArgument(*args, "path")), stringArgument(*args, "name"), stringArgument(*args, "type")));
+        }
+        else if (op == "removeStage")
+        {
+            results.asArray()->push_back(removeStageFrom(stageObject(stringArgument(*args, "path")), stringArgument(*args, "name")));
+
+            // Paths may refer to the removed stage or its children
+            stages.clear();
+        }
+        else if (op == "createSlot")
+        {
+            results.asArray()->push_back(createSlotOn(stageObject(stringArgument(*args, "path")), stringArgument(*args, "slot"), stringArgument(*args, "slotType"), stringArgument(*args, "type")));
+        }
+        else
+        {
+            warning("gloperate") << "batch: unknown operation '" << op << "'";
+            results.asArray()->push_back(cppexpose::Variant());
         }
     }
 
-    return cppexpose::Variant();
+    return results;
 }
 
-void Canvas::scr_setValue(const std::string & path, const std::string & slotName, const cppexpose::Variant & value)
+bool Canvas::scr_saveSnapshot(const std::string & filename)
 {
     std::lock_guard<std::mutex> lock(this->m_mutex);
 
-    Stage * stage = getStageObject(path);
-    if (stage)
+    if (!m_renderStage || !m_renderStage->isPipeline())
     {
-        AbstractSlot * slot = stage->getSlot(slotName);
-        if (slot)
-        {
-            slot->fromVariant(value);
-        }
+        return false;
     }
+
+    return PipelineSnapshot::save(static_cast<Pipeline *>(m_renderStage.get()), filename);
+}
+
+bool Canvas::scr_loadSnapshot(const std::string & filename)
+{
+    auto pipeline = PipelineSnapshot::load(m_environment, filename);
+    if (!pipeline)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    setRenderStage(std::move(pipeline));
+    return true;
 }
 
 Stage * Canvas::getStageObject(const std::string & path) const
@@ -873,5 +1127,28 @@ cppexpose::Variant Canvas::getSlotStatus(const std::string & path, const std::st
     return status;
 }
 
+void Canvas::updateSlots()
+{
+    // Slots only have to be looked up again if the stage or its interface has changed
+    if (m_slotStage == m_renderStage.get() && m_slotRevision == m_renderStage->slotRevision())
+    {
+        return;
+    }
+
+    m_timeDeltaInput           = m_renderStage->input<float>("timeDelta");
+    m_viewportInput            = m_renderStage->input<glm::vec4>("viewport");
+    m_colorTargetInputs        = m_renderStage->inputs<ColorRenderTarget *>();
+    m_depthTargetInputs        = m_renderStage->inputs<DepthRenderTarget *>();
+    m_depthStencilTargetInputs = m_renderStage->inputs<DepthStencilRenderTarget *>();
+    m_stencilTargetInputs      = m_renderStage->inputs<StencilRenderTarget *>();
+    m_colorTargetOutputs       = m_renderStage->outputs<ColorRenderTarget *>();
+
+    const auto viewportOutputs = m_renderStage->outputs<glm::vec4>();
+    m_viewportOutput = viewportOutputs.empty() ? nullptr : viewportOutputs.front();
+
+    m_slotStage    = m_renderStage.get();
+    m_slotRevision = m_renderStage->slotRevision();
+}
+
 
 } // namespace gloperate
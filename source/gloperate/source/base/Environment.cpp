@@ -22,8 +22,11 @@ Environment::Environment()
 , m_system(this)
 , m_inputManager(this)
 , m_timerManager(this)
+, m_programBinaryCache()
+, m_profiler()
 , m_scriptContext(nullptr)
 , m_safeMode(false)
+, m_threadPool()
 {
     addProperty(&m_componentManager);
     addProperty(&m_resourceManager);
@@ -76,6 +79,36 @@ TimerManager * Environment::timerManager()
     return &m_timerManager;
 }
 
+const ThreadPool * Environment::threadPool() const
+{
+    return &m_threadPool;
+}
+
+ThreadPool * Environment::threadPool()
+{
+    return &m_threadPool;
+}
+
+const ProgramBinaryCache * Environment::programBinaryCache() const
+{
+    return &m_programBinaryCache;
+}
+
+ProgramBinaryCache * Environment::programBinaryCache()
+{
+    return &m_programBinaryCache;
+}
+
+const Profiler * Environment::profiler() const
+{
+    return &m_profiler;
+}
+
+Profiler * Environment::profiler()
+{
+    return &m_profiler;
+}
+
 const std::vector<Canvas *> & Environment::canvases() const
 {
     return m_canvases;
@@ -0,0 +1,161 @@
+
+#include <gloperate/base/MappedFile.h>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace gloperate
+{
+
+
+MappedFile::MappedFile()
+: m_data(nullptr)
+, m_size(0)
+, m_file(nullptr)
+, m_mapping(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string & filename)
+{
+    close();
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const char *>(data);
+    m_size    = static_cast<size_t>(size.QuadPart);
+#else
+    const int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping stays valid after closing the file descriptor
+    ::close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const char *>(data);
+    m_size = size;
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (!m_data)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    CloseHandle(static_cast<HANDLE>(m_file));
+#else
+    munmap(const_cast<char *>(m_data), m_size);
+#endif
+
+    m_data    = nullptr;
+    m_size    = 0;
+    m_file    = nullptr;
+    m_mapping = nullptr;
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+const char * MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+void MappedFile::prefetch(size_t offset, size_t size) const
+{
+    if (!m_data || offset >= m_size)
+    {
+        return;
+    }
+
+    if (size > m_size - offset)
+    {
+        size = m_size - offset;
+    }
+
+#ifdef WIN32
+    // PrefetchVirtualMemory is not available on all supported versions of Windows
+    (void)size;
+#else
+    // Align range to pages
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto begin    = offset / pageSize * pageSize;
+
+    madvise(const_cast<char *>(m_data) + begin, offset + size - begin, MADV_WILLNEED);
+#endif
+}
+
+
+} // namespace gloperate
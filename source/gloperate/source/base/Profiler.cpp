@@ -0,0 +1,199 @@
+
+#include <gloperate/base/Profiler.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+
+namespace
+{
+
+
+const std::uint64_t s_calibrationInterval = 1000000000; ///< Time after which GPU timestamps are related to profiler time again (in nanoseconds)
+
+
+void writeString(std::ostream & stream, const std::string & str)
+{
+    stream << '"';
+
+    for (const auto c : str)
+    {
+        switch (c)
+        {
+            case '"':  stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n";  break;
+            case '\t': stream << "\\t";  break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    stream << c;
+                }
+        }
+    }
+
+    stream << '"';
+}
+
+void writeMicroseconds(std::ostream & stream, std::uint64_t nanoseconds)
+{
+    stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+Profiler::Profiler(size_t maxSpans)
+: m_maxSpans(std::max(maxSpans, size_t(1)))
+, m_epoch(Clock::now())
+, m_enabled(false)
+, m_calibrated(false)
+, m_gpuOffset(0)
+, m_calibrationTime(0)
+{
+}
+
+Profiler::~Profiler()
+{
+}
+
+bool Profiler::isEnabled() const
+{
+    return m_enabled;
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+std::uint64_t Profiler::time(Clock::time_point time) const
+{
+    if (time < m_epoch)
+    {
+        return 0;
+    }
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_epoch).count();
+}
+
+void Profiler::addCPUSpan(const std::string & name, std::uint64_t begin, std::uint64_t end)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Number CPU threads in the order in which they add spans, 0 is the GPU
+    const auto it = m_threads.emplace(std::this_thread::get_id(), static_cast<unsigned int>(m_threads.size() + 1)).first;
+
+    addSpan(Span{ name, begin, end, it->second });
+}
+
+void Profiler::addGPUSpan(const std::string & name, std::uint64_t begin, std::uint64_t end)
+{
+    const auto now = time(Clock::now());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Relate GPU clock to profiler time, the clocks may drift apart
+    if (!m_calibrated || now - m_calibrationTime > s_calibrationInterval)
+    {
+        gl::GLint64 timestamp = 0;
+        gl::glGetInteger64v(gl::GL_TIMESTAMP, &timestamp);
+
+        m_calibrationTime = time(Clock::now());
+        m_gpuOffset       = static_cast<std::int64_t>(m_calibrationTime) - static_cast<std::int64_t>(timestamp);
+        m_calibrated      = true;
+    }
+
+    const auto toProfilerTime = [this] (std::uint64_t timestamp)
+    {
+        return static_cast<std::uint64_t>(std::max(static_cast<std::int64_t>(timestamp) + m_gpuOffset, std::int64_t(0)));
+    };
+
+    addSpan(Span{ name, toProfilerTime(begin), toProfilerTime(end), 0 });
+}
+
+std::vector<Profiler::Span> Profiler::spans() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return std::vector<Span>(m_spans.begin(), m_spans.end());
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_spans.clear();
+}
+
+void Profiler::writeTrace(std::ostream & stream) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    // Name tracks
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+    for (const auto & thread : m_threads)
+    {
+        stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.second
+               << ",\"args\":{\"name\":\"CPU thread " << thread.second << "\"}}";
+    }
+
+    // Complete events, nesting is derived from the time ranges on each track
+    for (const auto & span : m_spans)
+    {
+        stream << ",\n{\"name\":";
+        writeString(stream, span.name);
+        stream << ",\"cat\":\"" << (span.thread == 0 ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.thread << ",\"ts\":";
+        writeMicroseconds(stream, span.begin);
+        stream << ",\"dur\":";
+        writeMicroseconds(stream, span.end > span.begin ? span.end - span.begin : 0);
+        stream << "}";
+    }
+
+    stream << "\n]}\n";
+}
+
+bool Profiler::exportTrace(const std::string & filename) const
+{
+    std::ofstream stream(filename, std::ios::trunc);
+
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    writeTrace(stream);
+
+    return static_cast<bool>(stream);
+}
+
+void Profiler::addSpan(Span && span)
+{
+    if (m_spans.size() == m_maxSpans)
+    {
+        m_spans.pop_front();
+    }
+
+    m_spans.push_back(std::move(span));
+}
+
+
+} // namespace gloperate
@@ -27,6 +27,8 @@ ResourceManager::~ResourceManager()
 
 std::vector<AbstractLoader *> ResourceManager::loaders() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     // Get list of raw pointers
     std::vector<AbstractLoader *> loaders;
     std::transform(m_loaders.begin(), m_loaders.end(), std::back_inserter(loaders), [] (const std::unique_ptr<AbstractLoader> & loader)
@@ -40,6 +42,8 @@ std::vector<AbstractLoader *> ResourceManager::loaders() const
 
 std::vector<AbstractStorer *> ResourceManager::storers() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     // Get list of raw pointers
     std::vector<AbstractStorer *> storers;
     std::transform(m_storers.begin(), m_storers.end(), std::back_inserter(storers), [](const std::unique_ptr<AbstractStorer> & storer) { return storer.get(); });
@@ -48,30 +52,52 @@ std::vector<AbstractStorer *> ResourceManager::storers() const
     return storers;
 }
 
-void ResourceManager::updateComponents() const
+std::string ResourceManager::extension(const std::string & filename)
 {
-    // Release previous components
-    clearComponents();
+    // Get file extension
+    std::string ext = cppassist::FilePath(filename).extension();
+    auto pos = ext.find_last_of('.');
+    if (pos != std::string::npos)
+    {
+        ext = ext.substr(pos + 1);
+    }
 
+    return ext;
+}
+
+ThreadPool * ResourceManager::threadPool() const
+{
+    return m_environment->threadPool();
+}
+
+void ResourceManager::updateComponents() const
+{
     // Get available loader components
-    auto loaders = m_environment->componentManager()->components<AbstractLoader>();
-    for (auto component : loaders) {
-        // Create loader
-        auto loader = component->createInstance(m_environment);
-        m_loaders.push_back(std::move(loader));
+    if (m_loaders.empty()) {
+        auto loaders = m_environment->componentManager()->components<AbstractLoader>();
+        for (auto component : loaders) {
+            // Create loader
+            auto loader = component->createInstance(m_environment);
+            m_loaders.push_back(std::move(loader));
+        }
+
+        m_loaderIndex.clear();
     }
 
     // Get available storer components
-    auto storers = m_environment->componentManager()->components<AbstractStorer>();
-    for (auto component : storers) {
-        // Create storer
-        auto storer = component->createInstance(m_environment);
-        m_storers.push_back(std::move(storer));
+    if (m_storers.empty()) {
+        auto storers = m_environment->componentManager()->components<AbstractStorer>();
+        for (auto component : storers) {
+            // Create storer
+            auto storer = component->createInstance(m_environment);
+            m_storers.push_back(std::move(storer));
+        }
     }
 }
 
 void ResourceManager::clearComponents() const
 {
+    m_loaderIndex.clear();
     m_loaders.clear();
     m_storers.clear();
 }
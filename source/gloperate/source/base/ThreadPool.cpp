@@ -0,0 +1,220 @@
+
+#include <gloperate/base/ThreadPool.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <cppassist/memory/make_unique.h>
+
+
+namespace
+{
+    // Pool and queue index of the current worker thread
+    thread_local const gloperate::ThreadPool * currentPool = nullptr;
+    thread_local unsigned int currentIndex = 0;
+}
+
+
+namespace gloperate
+{
+
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+: m_numThreads(numThreads)
+, m_pending(0)
+, m_nextQueue(0)
+, m_stop(false)
+{
+    if (m_numThreads == 0)
+    {
+        m_numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    for (unsigned int i = 0; i < m_numThreads; ++i)
+    {
+        m_queues.push_back(cppassist::make_unique<Queue>());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto & thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned int ThreadPool::numThreads() const
+{
+    return m_numThreads;
+}
+
+void ThreadPool::schedule(Task task)
+{
+    assert(task);
+
+    std::call_once(m_started, [this] () { start(); });
+
+    // Use own queue of a worker, or distribute tasks from the outside
+    const auto index = (currentPool == this) ? currentIndex : (m_nextQueue++ % m_numThreads);
+
+    // Count the task before it can be taken, so the counter never drops below zero
+    ++m_pending;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+
+    // Wake up an idle worker
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+
+    m_condition.notify_one();
+}
+
+bool ThreadPool::executePending()
+{
+    Task task;
+
+    if (!takeTask((currentPool == this) ? currentIndex : m_numThreads, task))
+    {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)> & func, size_t grainSize)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Create a few ranges per thread for load balancing
+    const auto numRanges = static_cast<size_t>(m_numThreads + 1) * 4;
+    const auto rangeSize = std::max(std::max(grainSize, size_t(1)), (count + numRanges - 1) / numRanges);
+
+    if (rangeSize >= count)
+    {
+        func(0, count);
+        return;
+    }
+
+    std::atomic<size_t> remaining((count + rangeSize - 1) / rangeSize);
+
+    // Schedule all but the first range
+    for (auto begin = rangeSize; begin < count; begin += rangeSize)
+    {
+        const auto end = std::min(begin + rangeSize, count);
+
+        schedule([&func, &remaining, begin, end] ()
+        {
+            func(begin, end);
+            --remaining;
+        });
+    }
+
+    // Process first range on the calling thread
+    func(0, rangeSize);
+    --remaining;
+
+    // Help with pending tasks until all ranges are done
+    while (remaining > 0)
+    {
+        if (!executePending())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::start()
+{
+    for (unsigned int i = 0; i < m_numThreads; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+void ThreadPool::run(unsigned int index)
+{
+    currentPool  = this;
+    currentIndex = index;
+
+    while (true)
+    {
+        Task task;
+
+        if (takeTask(index, task))
+        {
+            task();
+            continue;
+        }
+
+        // Wait for new tasks
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] ()
+        {
+            return m_stop || m_pending > 0;
+        });
+
+        if (m_stop && m_pending == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::takeTask(unsigned int index, Task & task)
+{
+    if (m_pending == 0)
+    {
+        return false;
+    }
+
+    // Take newest task from own queue
+    if (index < m_numThreads)
+    {
+        auto & queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --m_pending;
+            return true;
+        }
+    }
+
+    // Steal oldest task from another queue
+    for (unsigned int i = 1; i <= m_numThreads; ++i)
+    {
+        auto & queue = *m_queues[(index + i) % m_numThreads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --m_pending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+} // namespace gloperate
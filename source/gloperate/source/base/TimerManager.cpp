@@ -6,14 +6,6 @@
 #include <cppassist/memory/make_unique.h>
 
 
-// [TODO] Implement garbage collection of stopped scripting timers.
-//
-// At the moment, scripting timers are only deleted on shutdown.
-// We can't delete timers directly when they are stopped, because the call to timer.stop()
-// may be a result of the callback function itself, which hasn't returned, yet.
-// To avoid deleting a function that is currently being called, we have to defer deletion.
-
-
 namespace gloperate
 {
 
@@ -22,6 +14,8 @@ TimerManager::TimerManager(Environment * environment)
 : cppexpose::Object("timer")
 , m_environment(environment)
 , m_nextId(1)
+, m_time(0.0)
+, m_updating(false)
 {
     // Register functions
     addFunction("start",    this, &TimerManager::scr_start);
@@ -47,15 +41,71 @@ void TimerManager::update()
 
 void TimerManager::update(float delta)
 {
-    for (auto it = m_timers.begin(); it != m_timers.end(); ++it)
+    if (delta < 0.0f)
     {
+        return;
+    }
+
+    m_time += delta;
+
+    // Collect elapsed timers first, so that timers which are started
+    // or rescheduled by the callbacks fire in the next update at the earliest
+    std::vector<int> elapsed;
+
+    while (!m_deadlines.empty() && m_deadlines.top().time <= m_time)
+    {
+        elapsed.push_back(m_deadlines.top().id);
+
+        m_deadlines.pop();
+        removeStaleDeadlines();
+    }
+
+    // Call timer functions
+    m_updating = true;
+
+    for (int id : elapsed)
+    {
+        // Timer may have been stopped by a previous callback
+        const auto it = m_timers.find(id);
+        if (it == m_timers.end() || !it->second->active)
+        {
+            continue;
+        }
+
         Timer * timer = it->second.get();
 
-        if (timer->active)
+        // Reset timer
+        if (timer->singleShot)
         {
-            updateTimer(timer, delta);
+            stopTimer(id, timer);
         }
+        else
+        {
+            schedule(id, timer);
+        }
+
+        // Timer elapsed
+        std::vector<cppexpose::Variant> params;
+        cppexpose::Variant res = timer->func.call(params);
+    }
+
+    m_updating = false;
+
+    // Delete stopped timers, now that none of their functions is being called
+    deleteStoppedTimers();
+}
+
+float TimerManager::remainingTime() const
+{
+    if (m_deadlines.empty())
+    {
+        return -1.0f;
     }
+
+    // Subtract the time that has passed since the last update
+    const double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(m_clock.elapsed()).count();
+
+    return std::max(static_cast<float>(m_deadlines.top().time - m_time - elapsed), 0.0f);
 }
 
 int TimerManager::scr_start(int msec, const cppexpose::Variant & func)
@@ -71,13 +121,18 @@ int TimerManager::scr_once(int msec, const cppexpose::Variant & func)
 void TimerManager::scr_stop(int id)
 {
     // Check timer ID
-    if (m_timers.count(id) < 1) {
+    const auto it = m_timers.find(id);
+    if (it == m_timers.end()) {
         return;
     }
 
     // Stop timer
-    Timer * timer = m_timers.at(id).get();
-    stopTimer(timer);
+    stopTimer(id, it->second.get());
+
+    if (!m_updating)
+    {
+        deleteStoppedTimers();
+    }
 }
 
 void TimerManager::scr_stopAll()
@@ -86,8 +141,12 @@ void TimerManager::scr_stopAll()
     for (auto it = m_timers.begin(); it != m_timers.end(); ++it)
     {
         // Stop timer
-        Timer * timer = it->second.get();
-        stopTimer(timer);
+        stopTimer(it->first, it->second.get());
+    }
+
+    if (!m_updating)
+    {
+        deleteStoppedTimers();
     }
 }
 
@@ -110,56 +169,70 @@ int TimerManager::startTimer(const cppexpose::Variant & func, int msec, bool sin
     // Create and start timer
     auto timer = cppassist::make_unique<Timer>();
     timer->interval   = msec / 1000.0f;
-    timer->remaining  = msec / 1000.0f;
     timer->singleShot = singleShot;
     timer->active     = true;
     timer->func       = function;
 
     // Store timer
     int id = m_nextId++;
+    schedule(id, timer.get());
     m_timers[id] = std::move(timer);
 
     // Return timer ID
     return id;
 }
 
-void TimerManager::stopTimer(Timer * timer)
+void TimerManager::stopTimer(int id, Timer * timer)
 {
+    if (!timer->active)
+    {
+        return;
+    }
+
     timer->active     = false;
     timer->interval   = 0.0f;
-    timer->remaining  = 0.0f;
+    timer->deadline   = 0.0;
     timer->singleShot = false;
+
+    // Defer deletion, the timer's function may currently be called
+    m_stopped.push_back(id);
+
+    // Keep an active timer at the top of the heap
+    removeStaleDeadlines();
 }
 
-void TimerManager::updateTimer(Timer * timer, float delta)
+void TimerManager::schedule(int id, Timer * timer)
 {
-    if (timer->active && delta >= 0.0f)
+    timer->deadline = m_time + timer->interval;
+
+    m_deadlines.push(Deadline{ timer->deadline, id });
+}
+
+void TimerManager::removeStaleDeadlines()
+{
+    // Entries of stopped timers are only removed when they reach the top
+    while (!m_deadlines.empty())
     {
-        if (timer->remaining > delta)
-        {
-            timer->remaining -= delta;
-        }
-        else
+        const auto it = m_timers.find(m_deadlines.top().id);
+
+        if (it != m_timers.end() && it->second->active)
         {
-            // Timer elapsed
-            std::vector<cppexpose::Variant> params;
-            cppexpose::Variant res = timer->func.call(params);
-
-            // Reset timer
-            if (timer->singleShot)
-            {
-                timer->active     = false;
-                timer->interval   = 0.0f;
-                timer->remaining  = 0.0f;
-                timer->singleShot = false;
-            }
-            else
-            {
-                timer->remaining = timer->interval;
-            }
+            break;
         }
+
+        m_deadlines.pop();
     }
 }
 
+void TimerManager::deleteStoppedTimers()
+{
+    for (int id : m_stopped)
+    {
+        m_timers.erase(id);
+    }
+
+    m_stopped.clear();
+}
+
 
 } // namespace gloperate
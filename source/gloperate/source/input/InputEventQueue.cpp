@@ -0,0 +1,54 @@
+
+#include <gloperate/input/InputEventQueue.h>
+
+#include <cassert>
+
+#include <gloperate/input/InputEvent.h>
+
+
+namespace gloperate
+{
+
+
+InputEventQueue::InputEventQueue(size_t capacity)
+: m_events(capacity)
+{
+}
+
+InputEventQueue::~InputEventQueue()
+{
+    // Destroy remaining events
+    while (pop())
+    {
+    }
+}
+
+size_t InputEventQueue::capacity() const
+{
+    return m_events.capacity();
+}
+
+bool InputEventQueue::push(std::unique_ptr<InputEvent> && event)
+{
+    assert(event != nullptr);
+
+    // Pass ownership to the queue only if the event has been queued
+    if (!m_events.push(event.get()))
+    {
+        return false;
+    }
+
+    event.release();
+    return true;
+}
+
+std::unique_ptr<InputEvent> InputEventQueue::pop()
+{
+    InputEvent * event = nullptr;
+    m_events.pop(event);
+
+    return std::unique_ptr<InputEvent>(event);
+}
+
+
+} // namespace gloperate
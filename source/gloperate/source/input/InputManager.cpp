@@ -2,6 +2,9 @@
 #include <gloperate/input/InputManager.h>
 
 #include <cassert>
+#include <vector>
+
+#include <cppassist/logging/logging.h>
 
 #include <gloperate/input/AbstractDeviceProvider.h>
 #include <gloperate/input/AbstractDevice.h>
@@ -13,9 +16,13 @@ namespace gloperate
 {
 
 
-InputManager::InputManager(Environment * environment)
+InputManager::InputManager(Environment * environment, size_t queueCapacity)
 : cppexpose::Object("input")
 , m_environment(environment)
+, m_queue(queueCapacity)
+, m_historySize(64)
+, m_droppedEvents(0)
+, m_coalescedEvents(0)
 {
 }
 
@@ -45,12 +52,99 @@ void InputManager::onEvent(std::unique_ptr<InputEvent> && event)
 {
     assert(event != nullptr);
 
-    for (auto consumer : m_consumers)
+    if (!m_queue.push(std::move(event)))
+    {
+        ++m_droppedEvents;
+    }
+}
+
+void InputManager::processEvents()
+{
+    std::unique_lock<std::mutex> lock(m_processMutex, std::try_to_lock);
+    if (!lock.owns_lock())
     {
-        consumer->onEvent(event.get());
+        return;
     }
 
-	m_events.push_back(std::move(event));
+    // Take events that have been queued so far, newer events are processed next time
+    std::vector<std::unique_ptr<InputEvent>> events;
+
+    while (events.size() < m_queue.capacity())
+    {
+        auto event = m_queue.pop();
+        if (!event)
+        {
+            break;
+        }
+
+        events.push_back(std::move(event));
+    }
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        auto & event = events[i];
+
+        // Skip mouse moves that are directly followed by another move of the same device
+        if (i + 1 < events.size() &&
+            event->type() == InputEvent::Type::MouseMove &&
+            events[i + 1]->type() == InputEvent::Type::MouseMove &&
+            event->dispatchingDevice() == events[i + 1]->dispatchingDevice())
+        {
+            ++m_coalescedEvents;
+            continue;
+        }
+
+        for (auto consumer : m_consumers)
+        {
+            consumer->onEvent(event.get());
+        }
+
+        // Keep event in the history
+        if (m_historySize > 0)
+        {
+            m_history.push_back(std::move(event));
+        }
+    }
+
+    while (m_history.size() > m_historySize)
+    {
+        m_history.pop_front();
+    }
+
+    if (!events.empty())
+    {
+        cppassist::debug(4, "gloperate") << "processed " << events.size() << " input events";
+    }
+}
+
+const std::deque<std::unique_ptr<InputEvent>> & InputManager::history() const
+{
+    return m_history;
+}
+
+size_t InputManager::historySize() const
+{
+    return m_historySize;
+}
+
+void InputManager::setHistorySize(size_t size)
+{
+    m_historySize = size;
+
+    while (m_history.size() > m_historySize)
+    {
+        m_history.pop_front();
+    }
+}
+
+size_t InputManager::droppedEvents() const
+{
+    return m_droppedEvents;
+}
+
+size_t InputManager::coalescedEvents() const
+{
+    return m_coalescedEvents;
 }
 
 
@@ -2,6 +2,7 @@
 #include <gloperate/loaders/ColorGradientLoader.h>
 
 #include <algorithm>
+#include <memory>
 
 #include <cppassist/fs/readfile.h>
 #include <cppassist/fs/FilePath.h>
@@ -111,5 +112,21 @@ ColorGradientList * ColorGradientLoader::load(const std::string & filename, cons
     return colorGradientList;
 }
 
+std::function<ColorGradientList * ()> ColorGradientLoader::prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
+{
+    // Color gradients do not need an OpenGL context, so they are loaded entirely on the worker thread
+    auto colorGradientList = std::make_shared<std::unique_ptr<ColorGradientList>>(load(filename, options, progress));
+
+    if (!*colorGradientList)
+    {
+        return nullptr;
+    }
+
+    return [colorGradientList] ()
+    {
+        return colorGradientList->release();
+    };
+}
+
 
 } // namespace gloperate
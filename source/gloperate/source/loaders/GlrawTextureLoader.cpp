@@ -2,21 +2,251 @@
 #include <gloperate/loaders/GlrawTextureLoader.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
 
 #include <cppassist/fs/FilePath.h>
-#include <cppassist/fs/readfile.h>
-#include <cppassist/fs/RawFile.h>
-#include <cppassist/fs/DescriptiveRawFile.h>
+#include <cppassist/logging/logging.h>
 
 #include <cppexpose/variant/Variant.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
 
 #include <globjects/Texture.h>
 
+#include <gloperate/base/MappedFile.h>
 #include <gloperate/loaders/RawFileNameSuffix.h>
 
 
+namespace
+{
+
+
+const std::uint16_t s_glrawMagic      = 0xC6F5;
+const size_t        s_glrawPrefixSize = sizeof(std::uint16_t) + sizeof(std::uint64_t);
+const std::uint8_t  s_glrawIntType    = 1;
+const size_t        s_tileSize        = 4 * 1024 * 1024; ///< Number of bytes uploaded at once
+
+
+template <typename T>
+T option(const cppexpose::Variant & options, const std::string & name, const T & defaultValue)
+{
+    const auto map = options.asMap();
+    if (!map)
+    {
+        return defaultValue;
+    }
+
+    const auto it = map->find(name);
+    return it != map->end() ? it->second.value<T>() : defaultValue;
+}
+
+size_t numComponents(gl::GLenum format)
+{
+    switch (format)
+    {
+    case gl::GL_RED:
+    case gl::GL_GREEN:
+    case gl::GL_BLUE:
+    case gl::GL_ALPHA:
+    case gl::GL_LUMINANCE:
+    case gl::GL_DEPTH_COMPONENT:
+    case gl::GL_STENCIL_INDEX:
+    case gl::GL_RED_INTEGER:
+    case gl::GL_GREEN_INTEGER:
+    case gl::GL_BLUE_INTEGER:
+        return 1;
+
+    case gl::GL_RG:
+    case gl::GL_LUMINANCE_ALPHA:
+    case gl::GL_RG_INTEGER:
+        return 2;
+
+    case gl::GL_RGB:
+    case gl::GL_BGR:
+    case gl::GL_RGB_INTEGER:
+    case gl::GL_BGR_INTEGER:
+        return 3;
+
+    case gl::GL_RGBA:
+    case gl::GL_BGRA:
+    case gl::GL_RGBA_INTEGER:
+    case gl::GL_BGRA_INTEGER:
+        return 4;
+
+    default:
+        return 0;
+    }
+}
+
+size_t componentSize(gl::GLenum type)
+{
+    switch (type)
+    {
+    case gl::GL_BYTE:
+    case gl::GL_UNSIGNED_BYTE:
+        return 1;
+
+    case gl::GL_SHORT:
+    case gl::GL_UNSIGNED_SHORT:
+    case gl::GL_HALF_FLOAT:
+        return 2;
+
+    case gl::GL_INT:
+    case gl::GL_UNSIGNED_INT:
+    case gl::GL_FLOAT:
+        return 4;
+
+    default:
+        return 0;
+    }
+}
+
+// Size of a pixel of a packed type, which holds all components
+size_t packedSize(gl::GLenum type)
+{
+    switch (type)
+    {
+    case gl::GL_UNSIGNED_BYTE_3_3_2:
+    case gl::GL_UNSIGNED_BYTE_2_3_3_REV:
+        return 1;
+
+    case gl::GL_UNSIGNED_SHORT_5_6_5:
+    case gl::GL_UNSIGNED_SHORT_5_6_5_REV:
+    case gl::GL_UNSIGNED_SHORT_4_4_4_4:
+    case gl::GL_UNSIGNED_SHORT_4_4_4_4_REV:
+    case gl::GL_UNSIGNED_SHORT_5_5_5_1:
+    case gl::GL_UNSIGNED_SHORT_1_5_5_5_REV:
+        return 2;
+
+    case gl::GL_UNSIGNED_INT_8_8_8_8:
+    case gl::GL_UNSIGNED_INT_8_8_8_8_REV:
+    case gl::GL_UNSIGNED_INT_10_10_10_2:
+    case gl::GL_UNSIGNED_INT_2_10_10_10_REV:
+    case gl::GL_UNSIGNED_INT_24_8:
+    case gl::GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case gl::GL_UNSIGNED_INT_5_9_9_9_REV:
+        return 4;
+
+    case gl::GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+        return 8;
+
+    default:
+        return 0;
+    }
+}
+
+// Size of a pixel in bytes, 0 if unknown
+size_t pixelSize(gl::GLenum format, gl::GLenum type)
+{
+    const auto packed = packedSize(type);
+    if (packed > 0)
+    {
+        return packed;
+    }
+
+    return numComponents(format) * componentSize(type);
+}
+
+// Internal format for integer pixel formats, GL_NONE if unsupported
+gl::GLenum integerInternalFormat(size_t components, gl::GLenum type)
+{
+    static const gl::GLenum formats[][4] = {
+        { gl::GL_R8I,   gl::GL_RG8I,   gl::GL_RGB8I,   gl::GL_RGBA8I   },
+        { gl::GL_R8UI,  gl::GL_RG8UI,  gl::GL_RGB8UI,  gl::GL_RGBA8UI  },
+        { gl::GL_R16I,  gl::GL_RG16I,  gl::GL_RGB16I,  gl::GL_RGBA16I  },
+        { gl::GL_R16UI, gl::GL_RG16UI, gl::GL_RGB16UI, gl::GL_RGBA16UI },
+        { gl::GL_R32I,  gl::GL_RG32I,  gl::GL_RGB32I,  gl::GL_RGBA32I  },
+        { gl::GL_R32UI, gl::GL_RG32UI, gl::GL_RGB32UI, gl::GL_RGBA32UI }
+    };
+
+    if (components < 1 || components > 4)
+    {
+        return gl::GL_NONE;
+    }
+
+    switch (type)
+    {
+    case gl::GL_BYTE:           return formats[0][components - 1];
+    case gl::GL_UNSIGNED_BYTE:  return formats[1][components - 1];
+    case gl::GL_SHORT:          return formats[2][components - 1];
+    case gl::GL_UNSIGNED_SHORT: return formats[3][components - 1];
+    case gl::GL_INT:            return formats[4][components - 1];
+    case gl::GL_UNSIGNED_INT:   return formats[5][components - 1];
+
+    case gl::GL_UNSIGNED_INT_2_10_10_10_REV:
+        return components == 4 ? gl::GL_RGB10_A2UI : gl::GL_NONE;
+
+    default:
+        return gl::GL_NONE;
+    }
+}
+
+// Internal format of a texture for the given pixel format and type, GL_NONE if unsupported
+gl::GLenum internalFormat(gl::GLenum format, gl::GLenum type)
+{
+    switch (format)
+    {
+    case gl::GL_RED:
+        return gl::GL_R8;
+
+    case gl::GL_RG:
+        return gl::GL_RG8;
+
+    case gl::GL_RGB:
+    case gl::GL_BGR:
+        return gl::GL_RGB8;
+
+    case gl::GL_RGBA:
+    case gl::GL_BGRA:
+        return gl::GL_RGBA8;
+
+    case gl::GL_RED_INTEGER:
+    case gl::GL_GREEN_INTEGER:
+    case gl::GL_BLUE_INTEGER:
+    case gl::GL_RG_INTEGER:
+    case gl::GL_RGB_INTEGER:
+    case gl::GL_BGR_INTEGER:
+    case gl::GL_RGBA_INTEGER:
+    case gl::GL_BGRA_INTEGER:
+        return integerInternalFormat(numComponents(format), type);
+
+    case gl::GL_STENCIL_INDEX:
+        return type == gl::GL_UNSIGNED_BYTE ? gl::GL_STENCIL_INDEX8 : gl::GL_NONE;
+
+    case gl::GL_DEPTH_COMPONENT:
+        return gl::GL_DEPTH_COMPONENT;
+
+    case gl::GL_DEPTH_STENCIL:
+        if (type == gl::GL_UNSIGNED_INT_24_8)
+        {
+            return gl::GL_DEPTH24_STENCIL8;
+        }
+
+        return type == gl::GL_FLOAT_32_UNSIGNED_INT_24_8_REV ? gl::GL_DEPTH32F_STENCIL8 : gl::GL_NONE;
+
+    default:
+        // Other formats (e.g., luminance) are converted to RGBA as before
+        return gl::GL_RGBA8;
+    }
+}
+
+std::uint64_t glrawDataOffset(const char * header)
+{
+    std::uint64_t offset = 0;
+    std::memcpy(&offset, header + sizeof(std::uint16_t), sizeof(offset));
+
+    return offset;
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -63,106 +293,374 @@ std::string GlrawTextureLoader::allLoadingTypes() const
     return allTypes;
 }
 
-globjects::Texture * GlrawTextureLoader::load(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)>) const
+globjects::Texture * GlrawTextureLoader::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
 {
-    globjects::Texture * texture = nullptr;
-
-    cppassist::FilePath filePath(filename);
-    if (filePath.extension() == "glraw")
-        texture = loadGLRawImage(filename);
-    else if (filePath.extension() == "raw")
-        texture = loadRawImage(filename);
+    auto createTexture = prepare(filename, options, progress);
 
-    return texture;
+    return createTexture ? createTexture() : nullptr;
 }
 
-globjects::Texture * GlrawTextureLoader::loadGLRawImage(const std::string & filename) const
+std::function<globjects::Texture * ()> GlrawTextureLoader::prepare(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
 {
-    cppassist::DescriptiveRawFile rawFile;
+    const auto extension = cppassist::FilePath(filename).extension();
+    const bool glraw = (extension == "glraw");
 
-    if (!rawFile.load(filename))
+    if (!glraw && extension != "raw")
+    {
         return nullptr;
+    }
 
-    const int w = rawFile.intProperty("width");
-    const int h = rawFile.intProperty("height");
+    ImageLayout layout;
+    Region      region;
+    size_t      first = 0;
+    size_t      count = 0;
 
-    globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
+    // Map file into memory
+    auto file = std::make_shared<MappedFile>();
 
-    if (rawFile.hasIntProperty("format"))
+    if (option<bool>(options, "mapped", true) && file->open(filename))
     {
-        auto format = static_cast<gl::GLenum>(rawFile.intProperty("format"));
-        auto type = static_cast<gl::GLenum>(rawFile.intProperty("type"));
+        const bool valid = glraw ? readGLRawHeader(file->data(), file->size(), layout) : readRawFileName(filename, file->size(), layout);
 
-        texture->image2D(
-            0,
-            gl::GL_RGBA8,
-            w,
-            h,
-            0,
-            format,
-            type,
-            rawFile.data()
-        );
+        if (valid && layout.complete && layout.size == 0 && layout.offset < file->size())
+        {
+            layout.size = file->size() - layout.offset;
+        }
+
+        if (!valid || layout.size == 0 || layout.offset + layout.size > file->size() ||
+            !selectRegion(options, layout, region, first, count))
+        {
+            return nullptr;
+        }
+
+        // Start reading the region while the texture is not yet requested
+        file->prefetch(first, count);
+
+        const char * data = file->data() + first;
+
+        // Upload texture on the context thread, the file stays mapped until then
+        return [file, data, layout, region, progress] ()
+        {
+            return upload(data, layout, region, progress);
+        };
+    }
+
+    // Read only the required part of the file
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+
+    if (!stream.is_open())
+    {
+        return nullptr;
+    }
+
+    const auto fileSize = static_cast<size_t>(stream.tellg());
+    stream.seekg(0);
+
+    if (glraw)
+    {
+        std::vector<char> header(s_glrawPrefixSize);
+
+        if (!stream.read(header.data(), header.size()))
+        {
+            return nullptr;
+        }
+
+        const auto headerSize = glrawDataOffset(header.data());
+
+        if (headerSize < s_glrawPrefixSize || headerSize > fileSize)
+        {
+            return nullptr;
+        }
+
+        header.resize(static_cast<size_t>(headerSize));
+
+        if (!stream.read(header.data() + s_glrawPrefixSize, header.size() - s_glrawPrefixSize) ||
+            !readGLRawHeader(header.data(), header.size(), layout))
+        {
+            return nullptr;
+        }
+    }
+    else if (!readRawFileName(filename, fileSize, layout))
+    {
+        return nullptr;
+    }
+
+    if (layout.complete && layout.size == 0 && layout.offset < fileSize)
+    {
+        layout.size = fileSize - layout.offset;
+    }
+
+    if (layout.size == 0 || layout.offset + layout.size > fileSize || !selectRegion(options, layout, region, first, count))
+    {
+        return nullptr;
+    }
+
+    auto buffer = std::make_shared<std::vector<char>>(count);
+
+    if (!stream.seekg(first) || !stream.read(buffer->data(), buffer->size()))
+    {
+        return nullptr;
+    }
+
+    // Upload texture on the context thread
+    return [buffer, layout, region, progress] ()
+    {
+        return upload(buffer->data(), layout, region, progress);
+    };
+}
+
+bool GlrawTextureLoader::readGLRawHeader(const char * header, size_t size, ImageLayout & layout)
+{
+    if (size < s_glrawPrefixSize)
+    {
+        return false;
+    }
+
+    std::uint16_t magic = 0;
+    std::memcpy(&magic, header, sizeof(magic));
+
+    const auto offset = glrawDataOffset(header);
+
+    if (magic != s_glrawMagic || offset < s_glrawPrefixSize || offset > size)
+    {
+        return false;
+    }
+
+    // Read integer properties: type, null-terminated name, value
+    std::map<std::string, int> properties;
+
+    const char * current = header + s_glrawPrefixSize;
+    const char * end     = header + offset;
+
+    while (current < end && static_cast<std::uint8_t>(*current) == s_glrawIntType)
+    {
+        const auto nameEnd = std::find(current + 1, end, '\0');
+
+        if (nameEnd == end || end - (nameEnd + 1) < static_cast<std::ptrdiff_t>(sizeof(std::int32_t)))
+        {
+            return false;
+        }
+
+        std::int32_t value = 0;
+        std::memcpy(&value, nameEnd + 1, sizeof(value));
+
+        properties[std::string(current + 1, nameEnd)] = value;
+
+        current = nameEnd + 1 + sizeof(value);
+    }
+
+    // Other properties (e.g., strings) are not needed for the layout
+
+    layout.width      = properties["width"];
+    layout.height     = properties["height"];
+    layout.compressed = (properties.count("format") == 0);
+    layout.offset     = static_cast<size_t>(offset);
+
+    if (layout.width <= 0 || layout.height <= 0)
+    {
+        return false;
+    }
+
+    if (!layout.compressed)
+    {
+        layout.format         = static_cast<gl::GLenum>(properties["format"]);
+        layout.type           = static_cast<gl::GLenum>(properties["type"]);
+        layout.internalFormat = internalFormat(layout.format, layout.type);
+        layout.complete       = pixelSize(layout.format, layout.type) == 0;
+        layout.size           = static_cast<size_t>(layout.width) * layout.height * pixelSize(layout.format, layout.type);
     }
     else
     {
-        auto compressedFormat = static_cast<gl::GLenum>(rawFile.intProperty("compressedFormat"));
-        auto size = rawFile.intProperty("size");
+        layout.format         = static_cast<gl::GLenum>(properties["compressedFormat"]);
+        layout.type           = gl::GL_NONE;
+        layout.internalFormat = layout.format;
+        layout.complete       = false;
+        layout.size           = static_cast<size_t>(std::max(properties["size"], 0));
+    }
 
-        texture->compressedImage2D(
-            0,
-            compressedFormat,
-            w,
-            h,
-            0,
-            size,
-            rawFile.data()
-        );
+    if (!isSupported(layout))
+    {
+        return false;
     }
 
-    return texture;
+    // If the size of a pixel is unknown, the data fills the rest of the file
+    return layout.size > 0 || layout.complete;
 }
 
-globjects::Texture * GlrawTextureLoader::loadRawImage(const std::string & filename) const
+bool GlrawTextureLoader::readRawFileName(const std::string & filename, size_t fileSize, ImageLayout & layout)
 {
     RawFileNameSuffix suffix(filename);
 
-    if (!suffix.isValid())
-        return nullptr;
+    if (!suffix.isValid() || suffix.width() <= 0 || suffix.height() <= 0)
+    {
+        return false;
+    }
 
-    //read file
-    cppassist::RawFile rawFile;
-    if (!rawFile.load(filename))
-        return nullptr;
+    layout.width      = suffix.width();
+    layout.height     = suffix.height();
+    layout.compressed = suffix.compressed();
+    layout.offset     = 0;
 
+    if (!layout.compressed)
+    {
+        layout.format         = suffix.format();
+        layout.type           = suffix.type();
+        layout.internalFormat = internalFormat(layout.format, layout.type);
+        layout.complete       = pixelSize(layout.format, layout.type) == 0;
+        layout.size           = !layout.complete ? static_cast<size_t>(layout.width) * layout.height * pixelSize(layout.format, layout.type) : fileSize;
+    }
+    else
+    {
+        // The data of compressed images fills the whole file
+        layout.format         = suffix.type();
+        layout.type           = gl::GL_NONE;
+        layout.internalFormat = layout.format;
+        layout.complete       = false;
+        layout.size           = fileSize;
+    }
+
+    return isSupported(layout) && layout.size > 0;
+}
+
+bool GlrawTextureLoader::isSupported(const ImageLayout & layout)
+{
+    if (layout.internalFormat == gl::GL_NONE)
+    {
+        cppassist::critical() << "Unsupported combination of pixel format " << static_cast<unsigned int>(layout.format)
+                              << " and type " << static_cast<unsigned int>(layout.type);
+        return false;
+    }
+
+    return true;
+}
+
+bool GlrawTextureLoader::selectRegion(const cppexpose::Variant & options, const ImageLayout & layout, Region & region, size_t & first, size_t & count)
+{
+    // Compressed images and images with unknown pixel size are always loaded completely
+    if (layout.compressed || layout.complete)
+    {
+        region = Region{ 0, 0, layout.width, layout.height };
+        first  = layout.offset;
+        count  = layout.size;
+
+        return true;
+    }
+
+    region.x      = std::max(option<int>(options, "x", 0), 0);
+    region.y      = std::max(option<int>(options, "y", 0), 0);
+    region.width  = std::min(option<int>(options, "width",  layout.width  - region.x), layout.width  - region.x);
+    region.height = std::min(option<int>(options, "height", layout.height - region.y), layout.height - region.y);
+
+    if (region.width <= 0 || region.height <= 0)
+    {
+        return false;
+    }
+
+    // Rows of the region, from the first pixel to the last one
+    const auto bytesPerPixel = pixelSize(layout.format, layout.type);
+    const auto rowSize       = static_cast<size_t>(layout.width) * bytesPerPixel;
+
+    first = layout.offset + region.y * rowSize + region.x * bytesPerPixel;
+    count = (region.height - 1) * rowSize + region.width * bytesPerPixel;
+
+    return true;
+}
+
+globjects::Texture * GlrawTextureLoader::upload(const char * data, const ImageLayout & layout, const Region & region, const std::function<void(int, int)> & progress)
+{
     globjects::Texture * texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D).release();
 
-    if (!suffix.compressed())
+    if (layout.compressed)
+    {
+        texture->compressedImage2D(
+            0,
+            layout.format,
+            layout.width,
+            layout.height,
+            0,
+            static_cast<gl::GLsizei>(layout.size),
+            data
+        );
+
+        if (progress)
+        {
+            progress(1, 1);
+        }
+
+        return texture;
+    }
+
+    // Rows cannot be addressed if the size of a pixel is unknown, so the image is uploaded at once
+    if (layout.complete)
     {
         texture->image2D(
             0,
-            gl::GL_RGBA8,
-            suffix.width(),
-            suffix.height(),
+            layout.internalFormat,
+            layout.width,
+            layout.height,
             0,
-            suffix.format(),
-            suffix.type(),
-            rawFile.data()
+            layout.format,
+            layout.type,
+            data
         );
+
+        if (progress)
+        {
+            progress(1, 1);
+        }
+
+        return texture;
     }
-    else
+
+    // Allocate texture storage
+    texture->image2D(
+        0,
+        layout.internalFormat,
+        region.width,
+        region.height,
+        0,
+        layout.format,
+        layout.type,
+        nullptr
+    );
+
+    // Rows of the region are not contiguous if it is narrower than the image
+    gl::GLint alignment = 4;
+    gl::GLint rowLength = 0;
+    gl::glGetIntegerv(gl::GL_UNPACK_ALIGNMENT, &alignment);
+    gl::glGetIntegerv(gl::GL_UNPACK_ROW_LENGTH, &rowLength);
+
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, 1);
+    gl::glPixelStorei(gl::GL_UNPACK_ROW_LENGTH, layout.width);
+
+    // Upload in tiles of rows, so that the pages of a mapped file are read in order
+    const auto rowSize  = static_cast<size_t>(layout.width) * pixelSize(layout.format, layout.type);
+    const auto tileRows = static_cast<int>(std::max<size_t>(s_tileSize / rowSize, 1));
+
+    for (int row = 0; row < region.height; row += tileRows)
     {
-        texture->compressedImage2D(
+        const int rows = std::min(tileRows, region.height - row);
+
+        texture->subImage2D(
             0,
-            gl::GL_RGBA8,
-            suffix.width(),
-            suffix.height(),
             0,
-            rawFile.size(),
-            rawFile.data()
+            row,
+            region.width,
+            rows,
+            layout.format,
+            layout.type,
+            data + row * rowSize
         );
+
+        if (progress)
+        {
+            progress(row + rows, region.height);
+        }
     }
 
+    gl::glPixelStorei(gl::GL_UNPACK_ROW_LENGTH, rowLength);
+    gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, alignment);
+
     return texture;
 }
 
@@ -2,18 +2,51 @@
 #include <gloperate/loaders/ShaderLoader.h>
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
-#include <cppassist/fs/readfile.h>
 #include <cppassist/fs/FilePath.h>
 
 #include <cppexpose/variant/Variant.h>
 
 #include <glbinding-aux/Meta.h>
 
-#include <globjects/base/File.h>
+#include <globjects/base/StaticStringSource.h>
 #include <globjects/Shader.h>
 
 
+namespace
+{
+
+
+// Owner of a cached shader source, destroyed after the shader that uses it
+class SourceOwner
+{
+public:
+    explicit SourceOwner(std::shared_ptr<globjects::StaticStringSource> source)
+    : m_source(std::move(source))
+    {
+    }
+
+protected:
+    std::shared_ptr<globjects::StaticStringSource> m_source;
+};
+
+// Shader that keeps its cached source alive
+class CachedShader : private SourceOwner, public globjects::Shader
+{
+public:
+    CachedShader(gl::GLenum type, std::shared_ptr<globjects::StaticStringSource> source)
+    : SourceOwner(std::move(source))
+    , globjects::Shader(type, m_source.get())
+    {
+    }
+};
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -75,22 +108,74 @@ std::string ShaderLoader::allLoadingTypes() const
     return allTypes;
 }
 
-globjects::Shader * ShaderLoader::load(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)> ) const
+globjects::Shader * ShaderLoader::load(const std::string & filename, const cppexpose::Variant & options, std::function<void(int, int)> progress) const
 {
-    globjects::Shader * shader;
+    auto createShader = prepare(filename, options, progress);
+
+    return createShader ? createShader() : nullptr;
+}
 
+std::function<globjects::Shader * ()> ShaderLoader::prepare(const std::string & filename, const cppexpose::Variant &, std::function<void(int, int)> ) const
+{
     auto it = m_extensionToType.find(cppassist::FilePath(filename).extension());
 
-    // [TODO] Remove file memory leak
-    globjects::File * file = new globjects::File(filename, false);
+    if (it == m_extensionToType.end()) {
+        return nullptr;
+    }
+
+    // Read source code
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
 
-    if (it == m_extensionToType.end() || file->string().empty()) {
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const auto code = stream.str();
+
+    if (code.empty()) {
         return nullptr;
     }
 
-    shader = new globjects::Shader((*it).second, file);
+    // Look up source with the same content
+    const auto hash = std::hash<std::string>()(code);
+
+    std::lock_guard<std::mutex> lock(m_sourcesMutex);
+
+    std::shared_ptr<globjects::StaticStringSource> source;
+
+    const auto range = m_sources.equal_range(hash);
+    for (auto sourceIt = range.first; sourceIt != range.second; ++sourceIt) {
+        auto cached = sourceIt->second.lock();
+
+        if (cached && cached->string() == code) {
+            source = std::move(cached);
+            break;
+        }
+    }
+
+    // Add source to the cache
+    if (!source) {
+        // Remove sources whose shaders have all been destroyed
+        for (auto sourceIt = m_sources.begin(); sourceIt != m_sources.end(); ) {
+            if (sourceIt->second.expired()) {
+                sourceIt = m_sources.erase(sourceIt);
+            } else {
+                ++sourceIt;
+            }
+        }
+
+        source = std::make_shared<globjects::StaticStringSource>(code);
+        m_sources.emplace(hash, source);
+    }
+
+    // Create shader on the context thread
+    const auto type = (*it).second;
 
-    return shader;
+    return [type, source] () -> globjects::Shader *
+    {
+        return new CachedShader(type, source);
+    };
 }
 
 
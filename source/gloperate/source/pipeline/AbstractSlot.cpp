@@ -88,7 +88,18 @@ bool AbstractSlot::isFeedback() const
 
 void AbstractSlot::setFeedback(bool feedback)
 {
+    if (m_feedback == feedback)
+    {
+        return;
+    }
+
     m_feedback = feedback;
+
+    // Feedback connections are ignored for the stage order
+    if (Stage * stage = parentStage())
+    {
+        stage->invalidateInputConnections();
+    }
 }
 
 bool AbstractSlot::isConnected() const
@@ -3,10 +3,15 @@
 
 #include <iostream>
 #include <vector>
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 #include <cppassist/logging/logging.h>
 #include <cppassist/string/manipulation.h>
+#include <cppassist/memory/make_unique.h>
 
 #include <cppexpose/variant/Variant.h>
 
@@ -14,6 +19,7 @@
 #include <gloperate/base/ComponentManager.h>
 #include <gloperate/pipeline/Input.h>
 #include <gloperate/pipeline/Output.h>
+#include <gloperate/rendering/RenderTargetPool.h>
 
 
 using namespace cppassist;
@@ -24,12 +30,15 @@ namespace gloperate
 {
 
 
-// [TODO] invalidate sorting when stages or connections change
-
-
 Pipeline::Pipeline(Environment * environment, const std::string & className, const std::string & name)
 : Stage(environment, className, name)
 , m_sorted(false)
+, m_parallel(false)
+, m_currentStage(0)
+, m_processing(false)
+, m_visitedStages(0)
+, m_skippedStages(0)
+, m_renderTargetPool(cppassist::make_unique<RenderTargetPool>())
 {
 }
 
@@ -91,6 +100,7 @@ void Pipeline::addStage(std::unique_ptr<Stage> && stage)
 void Pipeline::registerStage(Stage * stage)
 {
     // Add stage
+    m_stageIndices[stage] = m_stages.size();
     m_stages.push_back(stage);
     if (stage->name() != "") {
         m_stagesMap.insert(std::make_pair(stage->name(), stage));
@@ -98,9 +108,24 @@ void Pipeline::registerStage(Stage * stage)
 
     debug(1, "gloperate") << stage->qualifiedName() << ": add to pipeline";
 
-    // Shouldn't be required if each slot of a stage would disconnect from connections
-    // and this would be propagated to the normal stage order invalidation
-    invalidateStageOrder();
+    // New stage has to be visited at least once
+    markStageDirty(stage);
+
+    // Collect dependencies of the new stage, and of stages that
+    // have already been connected to it before it was added
+    m_reconnectedStages.insert(stage);
+
+    for (auto other : m_stages)
+    {
+        for (auto slot : other->inputs())
+        {
+            if (slot->isConnected() && slot->source()->parentStage() == stage)
+            {
+                m_reconnectedStages.insert(other);
+                break;
+            }
+        }
+    }
 
     // Emit signal
     stageAdded(stage);
@@ -113,14 +138,46 @@ bool Pipeline::removeStage(Stage * stage)
         return false;
     }
 
-    auto it = std::find(m_stages.begin(), m_stages.end(), stage);
-    if (it == m_stages.end())
+    auto indexIt = m_stageIndices.find(stage);
+    if (indexIt == m_stageIndices.end())
     {
         return false;
     }
 
-    m_stages.erase(it);
+    // Remove stage from the execution plan, the order of the remaining stages stays valid
+    const auto index = indexIt->second;
+    m_stages.erase(m_stages.begin() + index);
+    m_stageIndices.erase(indexIt);
+
+    for (auto i = index; i < m_stages.size(); ++i)
+    {
+        m_stageIndices[m_stages[i]] = i;
+    }
+
     m_stagesMap.erase(stage->name());
+    m_reconnectedStages.erase(stage);
+    m_renderTargetPool->release(stage);
+
+    {
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        m_dirtyStages.erase(stage);
+    }
+
+    // Remove stage from adjacency lists
+    for (auto dependency : m_dependencies[stage])
+    {
+        auto & dependents = m_dependents[dependency];
+        dependents.erase(std::remove(dependents.begin(), dependents.end(), stage), dependents.end());
+    }
+
+    for (auto dependent : m_dependents[stage])
+    {
+        auto & dependencies = m_dependencies[dependent];
+        dependencies.erase(std::remove(dependencies.begin(), dependencies.end(), stage), dependencies.end());
+    }
+
+    m_dependencies.erase(stage);
+    m_dependents.erase(stage);
 
     debug(1, "gloperate") << stage->qualifiedName() << ": remove from pipeline";
 
@@ -128,11 +185,6 @@ bool Pipeline::removeStage(Stage * stage)
 
     removeProperty(stage);
 
-    // [TODO]
-    // Shouldn't be required if each slot of a stage would disconnect from connections
-    // and this would be propagated to the normal stage order invalidation
-    invalidateStageOrder();
-
     return true;
 }
 
@@ -142,6 +194,120 @@ void Pipeline::invalidateStageOrder()
     m_sorted = false;
 }
 
+void Pipeline::invalidateStageDependencies(Stage * stage)
+{
+    assert(stage);
+
+    if (m_stageIndices.count(stage) == 0)
+    {
+        return;
+    }
+
+    debug(2, "gloperate") << stage->qualifiedName() << ": invalidate dependencies; update stage order on next process";
+    m_reconnectedStages.insert(stage);
+}
+
+bool Pipeline::setStageOrder(const std::vector<Stage *> & stages)
+{
+    if (stages.size() != m_stages.size())
+    {
+        return false;
+    }
+
+    std::unordered_set<const Stage *> unique(stages.begin(), stages.end());
+    if (unique.size() != stages.size())
+    {
+        return false;
+    }
+
+    for (auto stage : stages)
+    {
+        if (m_stageIndices.count(stage) == 0)
+        {
+            return false;
+        }
+    }
+
+    debug(2, "gloperate") << this->qualifiedName() << ": adopt stage order; check dependencies on next process";
+
+    m_stages = stages;
+
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        m_stageIndices[m_stages[i]] = i;
+    }
+
+    // Collect the dependencies of all stages, which only reorders stages if the order is not valid
+    m_dependencies.clear();
+    m_dependents.clear();
+    m_reconnectedStages.insert(m_stages.begin(), m_stages.end());
+    m_sorted = true;
+
+    return true;
+}
+
+bool Pipeline::parallelExecution() const
+{
+    return m_parallel;
+}
+
+void Pipeline::setParallelExecution(bool enabled)
+{
+    debug(2, "gloperate") << this->qualifiedName() << ": set parallel execution to " << enabled;
+    m_parallel = enabled;
+
+    // Parallel execution does not track dirty stages, so visit all stages once
+    if (!m_parallel)
+    {
+        for (auto stage : m_stages)
+        {
+            markStageDirty(stage);
+        }
+    }
+}
+
+void Pipeline::markStageDirty(Stage * stage)
+{
+    assert(stage);
+
+    {
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+
+        auto indexIt = m_stageIndices.find(stage);
+        if (indexIt == m_stageIndices.end() || !m_dirtyStages.insert(stage).second)
+        {
+            return;
+        }
+
+        // Visit stage in the current execution, if it has not been passed yet
+        if (m_processing && indexIt->second > m_currentStage)
+        {
+            m_dirtyQueue.push_back(indexIt->second);
+            std::push_heap(m_dirtyQueue.begin(), m_dirtyQueue.end(), std::greater<size_t>());
+        }
+    }
+
+    debug(4, "gloperate") << stage->qualifiedName() << ": mark dirty";
+
+    // The pipeline itself has to be visited by its parent pipeline
+    markDirty();
+}
+
+size_t Pipeline::visitedStages() const
+{
+    return m_visitedStages;
+}
+
+size_t Pipeline::skippedStages() const
+{
+    return m_skippedStages;
+}
+
+RenderTargetPool * Pipeline::renderTargetPool() const
+{
+    return m_renderTargetPool.get();
+}
+
 bool Pipeline::isPipeline() const
 {
     return true;
@@ -151,72 +317,434 @@ void Pipeline::sortStages()
 {
     debug("gloperate") << this->qualifiedName() << ": sort stages";
 
-    auto couldBeSorted = true;
-    std::vector<Stage *> sorted;
-    std::set<Stage *> touched;
+    // Rebuild adjacency lists
+    m_dependencies.clear();
+    m_dependents.clear();
+    m_reconnectedStages.clear();
 
-    std::function<void(Stage *)> addSorted = [&](Stage * stage)
+    for (auto stage : m_stages)
     {
-        m_stages.erase(find(m_stages.begin(), m_stages.end(), stage));
-        sorted.push_back(stage);
-    };
+        auto & dependencies = m_dependencies[stage];
+        dependencies = collectDependencies(stage);
+
+        for (auto dependency : dependencies)
+        {
+            m_dependents[dependency].push_back(stage);
+        }
+    }
+
+    // Depth-first search, keeping the current order for independent stages
+    enum class Mark { None, Visiting, Done };
+
+    auto couldBeSorted = true;
+    std::vector<Stage *> sorted;
+    std::unordered_map<const Stage *, Mark> marks;
+    sorted.reserve(m_stages.size());
 
     std::function<void(Stage *)> visit = [&](Stage * stage)
     {
-        if (!couldBeSorted)
+        auto & mark = marks[stage];
+
+        if (mark == Mark::Done)
         {
-            addSorted(stage);
             return;
         }
 
-        if (touched.count(stage) > 0)
+        if (mark == Mark::Visiting)
         {
-            critical() << "Pipeline is not a directed acyclic graph";
+            if (couldBeSorted)
+            {
+                critical() << "Pipeline is not a directed acyclic graph";
+            }
+
             couldBeSorted = false;
-            addSorted(stage);
             return;
         }
 
-        touched.insert(stage);
+        mark = Mark::Visiting;
+
+        for (auto dependency : m_dependencies[stage])
+        {
+            visit(dependency);
+        }
+
+        marks[stage] = Mark::Done;
+        sorted.push_back(stage);
+    };
+
+    for (auto stage : m_stages)
+    {
+        visit(stage);
+    }
+
+    debug(2, "gloperate") << "Stage order after sorting";
+    for (const auto stage : sorted)
+    {
+        debug(2, "gloperate") << stage->qualifiedName();
+    }
+
+    m_stages = sorted;
+    m_sorted = couldBeSorted;
+
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        m_stageIndices[m_stages[i]] = i;
+    }
+}
+
+void Pipeline::updateStageOrder()
+{
+    if (m_sorted)
+    {
+        // Update only the dependencies that have changed
+        auto reconnectedStages = std::vector<Stage *>(m_reconnectedStages.begin(), m_reconnectedStages.end());
+        m_reconnectedStages.clear();
 
-        for (auto stageIt = m_stages.begin(); stageIt != m_stages.end(); /* nop */)
+        for (auto stage : reconnectedStages)
         {
-            if (!stage->requires(*stageIt, false))
+            if (!setDependencies(stage, collectDependencies(stage)))
             {
-                ++stageIt;
-                continue;
+                m_sorted = false;
+                break;
             }
+        }
+    }
 
-            auto nextStage = *stageIt;
-            visit(nextStage);
+    if (!m_sorted)
+    {
+        sortStages();
+    }
+}
 
-            if (!couldBeSorted)
+std::vector<Stage *> Pipeline::collectDependencies(const Stage * stage) const
+{
+    std::vector<Stage *> dependencies;
+
+    for (auto slot : stage->inputs())
+    {
+        if (slot->isFeedback() || !slot->isConnected())
+            continue;
+
+        // Only stages of this pipeline are relevant for the stage order
+        auto source = slot->source()->parentStage();
+        if (m_stageIndices.count(source) == 0)
+            continue;
+
+        if (std::find(dependencies.begin(), dependencies.end(), source) == dependencies.end())
+        {
+            dependencies.push_back(source);
+        }
+    }
+
+    return dependencies;
+}
+
+bool Pipeline::setDependencies(Stage * stage, const std::vector<Stage *> & dependencies)
+{
+    auto & oldDependencies = m_dependencies[stage];
+
+    // Remove dependencies that no longer exist, which keeps the stage order valid
+    for (auto dependency : oldDependencies)
+    {
+        if (std::find(dependencies.begin(), dependencies.end(), dependency) == dependencies.end())
+        {
+            auto & dependents = m_dependents[dependency];
+            dependents.erase(std::remove(dependents.begin(), dependents.end(), stage), dependents.end());
+        }
+    }
+
+    // Add new dependencies
+    std::vector<Stage *> addedDependencies;
+    for (auto dependency : dependencies)
+    {
+        if (std::find(oldDependencies.begin(), oldDependencies.end(), dependency) == oldDependencies.end())
+        {
+            m_dependents[dependency].push_back(stage);
+            addedDependencies.push_back(dependency);
+        }
+    }
+
+    oldDependencies = dependencies;
+
+    // Update stage order for each new dependency
+    for (auto dependency : addedDependencies)
+    {
+        if (!insertDependency(dependency, stage))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Pipeline::insertDependency(Stage * source, Stage * target)
+{
+    const auto lowerBound = m_stageIndices[target];
+    const auto upperBound = m_stageIndices[source];
+
+    // Nothing to do if the source is already executed before the target
+    if (upperBound < lowerBound)
+    {
+        return true;
+    }
+
+    if (source == target)
+    {
+        critical() << "Pipeline is not a directed acyclic graph";
+        return false;
+    }
+
+    debug(2, "gloperate") << this->qualifiedName() << ": reorder stages " << lowerBound << " to " << upperBound;
+
+    // Find stages in the affected range that depend on the target ...
+    std::vector<Stage *> forward;
+    std::unordered_set<const Stage *> visited;
+    std::vector<Stage *> stack(1, target);
+    visited.insert(target);
+
+    while (!stack.empty())
+    {
+        auto stage = stack.back();
+        stack.pop_back();
+        forward.push_back(stage);
+
+        for (auto dependent : m_dependents[stage])
+        {
+            if (dependent == source)
+            {
+                critical() << "Pipeline is not a directed acyclic graph";
+                return false;
+            }
+
+            if (m_stageIndices[dependent] < upperBound && visited.insert(dependent).second)
             {
-                addSorted(stage);
-                return;
+                stack.push_back(dependent);
             }
+        }
+    }
+
+    // ... and stages in the affected range the source depends on
+    std::vector<Stage *> backward;
+    stack.assign(1, source);
+    visited.insert(source);
+
+    while (!stack.empty())
+    {
+        auto stage = stack.back();
+        stack.pop_back();
+        backward.push_back(stage);
 
-            stageIt = m_stages.begin();
+        for (auto dependency : m_dependencies[stage])
+        {
+            if (m_stageIndices[dependency] > lowerBound && visited.insert(dependency).second)
+            {
+                stack.push_back(dependency);
+            }
         }
+    }
 
-        addSorted(stage);
+    // Reassign the positions of both sets, putting the source side first
+    const auto byIndex = [this] (const Stage * a, const Stage * b)
+    {
+        return m_stageIndices[a] < m_stageIndices[b];
     };
 
-    while (!m_stages.empty())
+    std::sort(forward.begin(), forward.end(), byIndex);
+    std::sort(backward.begin(), backward.end(), byIndex);
+
+    std::vector<size_t> indices;
+    indices.reserve(forward.size() + backward.size());
+
+    for (auto stage : backward) indices.push_back(m_stageIndices[stage]);
+    for (auto stage : forward)  indices.push_back(m_stageIndices[stage]);
+
+    std::sort(indices.begin(), indices.end());
+
+    auto index = indices.begin();
+    for (auto stage : backward) m_stages[*index++] = stage;
+    for (auto stage : forward)  m_stages[*index++] = stage;
+
+    for (auto i : indices)
     {
-        auto stageIt = m_stages.begin();
-        auto stage = *stageIt;
-        visit(stage);
+        m_stageIndices[m_stages[i]] = i;
     }
 
-    debug(2, "gloperate") << "Stage order after sorting";
-    for (const auto stage : sorted)
+    return true;
+}
+
+void Pipeline::processStage(Stage * stage)
+{
+    if (stage->needsProcessing()) {
+        // Transient render targets are only used on the rendering thread
+        if (!stage->isContextFree())
+        {
+            m_renderTargetPool->prepareStage(stage);
+        }
+
+        stage->process();
+    }
+    else
     {
-        debug(2, "gloperate") << stage->qualifiedName();
+        debug(2, "gloperate") << stage->qualifiedName() << ": omit execution";
     }
+}
 
-    m_stages = sorted;
-    m_sorted = couldBeSorted;
+void Pipeline::processDirty()
+{
+    std::unique_lock<std::mutex> lock(m_dirtyMutex);
+
+    // Visit dirty stages in the order of the execution plan
+    m_dirtyQueue.clear();
+    for (auto stage : m_dirtyStages)
+    {
+        m_dirtyQueue.push_back(m_stageIndices[stage]);
+    }
+
+    std::make_heap(m_dirtyQueue.begin(), m_dirtyQueue.end(), std::greater<size_t>());
+
+    m_processing    = true;
+    m_currentStage  = 0;
+    m_visitedStages = 0;
+
+    while (!m_dirtyQueue.empty())
+    {
+        std::pop_heap(m_dirtyQueue.begin(), m_dirtyQueue.end(), std::greater<size_t>());
+        const auto index = m_dirtyQueue.back();
+        m_dirtyQueue.pop_back();
+
+        if (index >= m_stages.size())
+        {
+            continue;
+        }
+
+        auto stage = m_stages[index];
+        m_dirtyStages.erase(stage);
+        m_currentStage = index;
+        ++m_visitedStages;
+
+        // Stages marked while processing this stage are added to the queue
+        lock.unlock();
+        processStage(stage);
+        lock.lock();
+
+        // Keep stages that have to be visited again
+        if (stage->alwaysProcessed() || stage->needsProcessing())
+        {
+            m_dirtyStages.insert(stage);
+        }
+    }
+
+    m_processing    = false;
+    m_skippedStages = m_stages.size() - std::min(m_visitedStages, m_stages.size());
+}
+
+void Pipeline::processParallel()
+{
+    auto & threadPool = *environment()->threadPool();
+    const auto numStages = m_stages.size();
+
+    // Build index-based dependency graph of the current plan
+    std::vector<std::vector<size_t>> dependents(numStages);
+    std::unique_ptr<std::atomic<size_t>[]> pending(new std::atomic<size_t>[numStages]);
+
+    for (size_t i = 0; i < numStages; ++i)
+    {
+        pending[i] = m_dependencies[m_stages[i]].size();
+
+        for (auto dependent : m_dependents[m_stages[i]])
+        {
+            dependents[i].push_back(m_stageIndices[dependent]);
+        }
+    }
+
+    std::atomic<size_t>     running(0);
+    std::mutex              mutex;
+    std::condition_variable finished;
+
+    // Release stages that have been waiting for a processed stage
+    std::function<void(size_t)> complete;
+    const auto scheduleStage = [&] (size_t index)
+    {
+        ++running;
+        threadPool.schedule([this, index, &complete] ()
+        {
+            processStage(m_stages[index]);
+            complete(index);
+        });
+    };
+
+    complete = [&] (size_t index)
+    {
+        for (auto dependent : dependents[index])
+        {
+            if (--pending[dependent] == 0 && m_stages[dependent]->isContextFree())
+            {
+                scheduleStage(dependent);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (m_stages[index]->isContextFree())
+        {
+            --running;
+        }
+
+        finished.notify_all();
+    };
+
+    // Help the thread pool until the condition is met. Note that this executes
+    // any pending task of the pool on the rendering thread, not only the stages
+    // of this frame (e.g., asynchronous resource loads scheduled by other
+    // components). Pool tasks must therefore never rely on running on a
+    // particular thread or on the OpenGL context being (in)active.
+    const auto waitFor = [&] (const std::function<bool()> & condition)
+    {
+        while (!condition())
+        {
+            if (!threadPool.executePending())
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                finished.wait(lock, condition);
+            }
+        }
+    };
+
+    // Start context-free stages without dependencies (collect them first,
+    // as the scheduled stages will already release their dependents)
+    std::vector<size_t> initialStages;
+    for (size_t i = 0; i < numStages; ++i)
+    {
+        if (m_stages[i]->isContextFree() && pending[i] == 0)
+        {
+            initialStages.push_back(i);
+        }
+    }
+
+    for (auto index : initialStages)
+    {
+        scheduleStage(index);
+    }
+
+    // Process all other stages on this thread in the order of the plan
+    for (size_t i = 0; i < numStages; ++i)
+    {
+        if (m_stages[i]->isContextFree())
+        {
+            continue;
+        }
+
+        waitFor([&pending, i] () { return pending[i] == 0; });
+
+        processStage(m_stages[i]);
+        complete(i);
+    }
+
+    waitFor([&running] () { return running == 0; });
+
+    // Make sure that the last worker has released the mutex
+    std::lock_guard<std::mutex> lock(mutex);
 }
 
 void Pipeline::onContextInit(AbstractGLContext * context)
@@ -233,24 +761,42 @@ void Pipeline::onContextDeinit(AbstractGLContext * context)
     {
         stage->deinitContext(context);
     }
+
+    m_renderTargetPool->clear();
 }
 
 void Pipeline::onProcess()
 {
-    if (!m_sorted) {
-        sortStages();
+    const auto reconnected = !m_sorted || !m_reconnectedStages.empty();
+
+    updateStageOrder();
+
+    // Share transient render targets according to the last execution
+    if (reconnected)
+    {
+        m_renderTargetPool->resetLifetimes();
+    }
+    else
+    {
+        m_renderTargetPool->updateLifetimes(this);
     }
 
-    for (auto stage : m_stages)
+    if (m_parallel && m_sorted)
     {
-        if (stage->needsProcessing()) {
-            stage->process();
-        }
-        else
+        // All stages are visited, dirty stages are only tracked for serial execution
         {
-            debug(2, "gloperate") << stage->qualifiedName() << ": omit execution";
+            std::lock_guard<std::mutex> lock(m_dirtyMutex);
+            m_dirtyStages.clear();
         }
+
+        processParallel();
+
+        m_visitedStages = m_stages.size();
+        m_skippedStages = 0;
+        return;
     }
+
+    processDirty();
 }
 
 void Pipeline::onInputValueChanged(AbstractSlot *)
@@ -0,0 +1,871 @@
+
+#include <gloperate/pipeline/PipelineSnapshot.h>
+
+#include <cstring>
+#include <fstream>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <cppassist/logging/logging.h>
+#include <cppassist/string/manipulation.h>
+
+#include <cppexpose/variant/Variant.h>
+
+#include <gloperate/base/Environment.h>
+#include <gloperate/base/ComponentManager.h>
+#include <gloperate/base/MappedFile.h>
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/AbstractSlot.h>
+
+
+using namespace cppassist;
+using namespace cppexpose;
+
+
+namespace
+{
+
+
+const char s_magic[8] = { 'G', 'L', 'O', 'P', 'S', 'N', 'A', 'P' }; ///< Identifier at the beginning of each snapshot
+
+// Stage flags
+const std::uint8_t s_stagePipeline = 0x01; ///< Stage is a pipeline, its stages follow its slots
+
+// Slot flags
+const std::uint8_t s_slotInput     = 0x01; ///< Slot is an input (else an output)
+const std::uint8_t s_slotDynamic   = 0x02; ///< Slot has been created at runtime
+const std::uint8_t s_slotFeedback  = 0x04; ///< Slot is a feedback input
+const std::uint8_t s_slotConnected = 0x08; ///< Slot is connected, the source follows
+const std::uint8_t s_slotValue     = 0x10; ///< Value of the slot follows
+const std::uint8_t s_sourceInput   = 0x20; ///< Source of the connection is an input (else an output)
+
+// Value tags
+enum class ValueTag : std::uint8_t
+{
+    Null = 0,
+    Bool,
+    Int,
+    UInt,
+    Float,
+    String,
+    Array,
+    Map
+};
+
+const unsigned int s_maxValueDepth = 64; ///< Maximum nesting depth of arrays and maps in a value
+
+
+/**
+*  @brief
+*    Little-endian encoder
+*/
+class Writer
+{
+public:
+    void writeUInt8(std::uint8_t value)
+    {
+        m_data.push_back(static_cast<char>(value));
+    }
+
+    void writeUInt32(std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            m_data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    void writeUInt64(std::uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            m_data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    void writeString(const std::string & value)
+    {
+        writeUInt32(static_cast<std::uint32_t>(value.size()));
+        m_data.insert(m_data.end(), value.begin(), value.end());
+    }
+
+    void writeBytes(const char * data, size_t size)
+    {
+        m_data.insert(m_data.end(), data, data + size);
+    }
+
+    void writeValue(const Variant & value, unsigned int depth = 0)
+    {
+        if (value.isNull())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Null));
+        }
+        else if (value.hasType<bool>())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Bool));
+            writeUInt8(value.value<bool>() ? 1 : 0);
+        }
+        else if (value.hasType<std::string>())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::String));
+            writeString(value.value<std::string>());
+        }
+        else if (value.hasType<float>() || value.hasType<double>())
+        {
+            const auto number = value.value<double>();
+
+            std::uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Float));
+            writeUInt64(bits);
+        }
+        else if (value.hasType<char>() || value.hasType<short>() || value.hasType<int>() || value.hasType<long>() || value.hasType<long long>())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Int));
+            writeUInt64(static_cast<std::uint64_t>(value.value<long long>()));
+        }
+        else if (value.hasType<unsigned char>() || value.hasType<unsigned short>() || value.hasType<unsigned int>() || value.hasType<unsigned long>() || value.hasType<unsigned long long>())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::UInt));
+            writeUInt64(static_cast<std::uint64_t>(value.value<unsigned long long>()));
+        }
+        else if (depth >= s_maxValueDepth)
+        {
+            // Values nested deeper than a reader accepts are not stored
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Null));
+        }
+        else if (const auto array = value.asArray())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Array));
+            writeUInt32(static_cast<std::uint32_t>(array->size()));
+
+            for (const auto & element : *array)
+            {
+                writeValue(element, depth + 1);
+            }
+        }
+        else if (const auto map = value.asMap())
+        {
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Map));
+            writeUInt32(static_cast<std::uint32_t>(map->size()));
+
+            for (const auto & element : *map)
+            {
+                writeString(element.first);
+                writeValue(element.second, depth + 1);
+            }
+        }
+        else
+        {
+            // Values without a portable representation (e.g., pointers) are not stored
+            writeUInt8(static_cast<std::uint8_t>(ValueTag::Null));
+        }
+    }
+
+    std::vector<char> & data()
+    {
+        return m_data;
+    }
+
+
+protected:
+    std::vector<char> m_data; ///< Encoded data
+};
+
+
+/**
+*  @brief
+*    Little-endian decoder with bounds checking
+*/
+class Reader
+{
+public:
+    Reader(const char * data, size_t size)
+    : m_data(data)
+    , m_size(size)
+    , m_pos(0)
+    {
+    }
+
+    bool readUInt8(std::uint8_t & value)
+    {
+        if (m_size - m_pos < 1)
+        {
+            return false;
+        }
+
+        value = static_cast<std::uint8_t>(m_data[m_pos++]);
+        return true;
+    }
+
+    bool readUInt32(std::uint32_t & value)
+    {
+        if (m_size - m_pos < 4)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(m_data[m_pos++])) << (8 * i);
+        }
+
+        return true;
+    }
+
+    bool readUInt64(std::uint64_t & value)
+    {
+        if (m_size - m_pos < 8)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(m_data[m_pos++])) << (8 * i);
+        }
+
+        return true;
+    }
+
+    bool readString(std::string & value)
+    {
+        std::uint32_t size = 0;
+        if (!readUInt32(size) || m_size - m_pos < size)
+        {
+            return false;
+        }
+
+        value.assign(m_data + m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool readBytes(char * data, size_t size)
+    {
+        if (m_size - m_pos < size)
+        {
+            return false;
+        }
+
+        std::memcpy(data, m_data + m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool readValue(Variant & value, unsigned int depth = 0)
+    {
+        std::uint8_t tag = 0;
+        if (!readUInt8(tag))
+        {
+            return false;
+        }
+
+        // Reject deeply nested values instead of exhausting the stack
+        if ((static_cast<ValueTag>(tag) == ValueTag::Array || static_cast<ValueTag>(tag) == ValueTag::Map) && depth >= s_maxValueDepth)
+        {
+            return false;
+        }
+
+        switch (static_cast<ValueTag>(tag))
+        {
+            case ValueTag::Null:
+                value = Variant();
+                return true;
+
+            case ValueTag::Bool:
+            {
+                std::uint8_t flag = 0;
+                if (!readUInt8(flag)) return false;
+
+                value = Variant(flag != 0);
+                return true;
+            }
+
+            case ValueTag::Int:
+            case ValueTag::UInt:
+            {
+                std::uint64_t bits = 0;
+                if (!readUInt64(bits)) return false;
+
+                if (static_cast<ValueTag>(tag) == ValueTag::Int)
+                {
+                    value = Variant(static_cast<long long>(bits));
+                }
+                else
+                {
+                    value = Variant(static_cast<unsigned long long>(bits));
+                }
+
+                return true;
+            }
+
+            case ValueTag::Float:
+            {
+                std::uint64_t bits = 0;
+                if (!readUInt64(bits)) return false;
+
+                double number;
+                std::memcpy(&number, &bits, sizeof(number));
+
+                value = Variant(number);
+                return true;
+            }
+
+            case ValueTag::String:
+            {
+                std::string str;
+                if (!readString(str)) return false;
+
+                value = Variant(str);
+                return true;
+            }
+
+            case ValueTag::Array:
+            {
+                std::uint32_t count = 0;
+                if (!readUInt32(count)) return false;
+
+                value = Variant::array();
+
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    Variant element;
+                    if (!readValue(element, depth + 1)) return false;
+
+                    value.asArray()->push_back(element);
+                }
+
+                return true;
+            }
+
+            case ValueTag::Map:
+            {
+                std::uint32_t count = 0;
+                if (!readUInt32(count)) return false;
+
+                value = Variant::map();
+
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    std::string key;
+                    Variant element;
+                    if (!readString(key) || !readValue(element, depth + 1)) return false;
+
+                    (*value.asMap())[key] = element;
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+protected:
+    const char * m_data; ///< Encoded data
+    size_t       m_size; ///< Size of the encoded data
+    size_t       m_pos;  ///< Current read position
+};
+
+
+/**
+*  @brief
+*    Slot whose connection and value are restored after all stages have been created
+*/
+struct PendingSlot
+{
+    gloperate::AbstractSlot * slot;       ///< Restored slot
+    std::uint8_t              flags;      ///< Slot flags
+    std::string               sourcePath; ///< Path of the source stage relative to the root pipeline
+    std::string               sourceSlot; ///< Name of the source slot
+    Variant                   value;      ///< Value of the slot
+};
+
+
+/**
+*  @brief
+*    State while restoring a snapshot
+*/
+struct RestoreState
+{
+    gloperate::Environment                                                     * environment; ///< Environment of the pipeline
+    gloperate::Pipeline                                                        * root;        ///< Root pipeline
+    std::vector<PendingSlot>                                                     slots;       ///< Slots to be connected or set
+    std::vector<std::pair<gloperate::Pipeline *, std::vector<gloperate::Stage *>>> orders;    ///< Stage order of each pipeline
+};
+
+
+std::unordered_map<std::type_index, std::string> stageComponents(gloperate::Environment * environment)
+{
+    std::unordered_map<std::type_index, std::string> components;
+
+    for (auto component : environment->componentManager()->components())
+    {
+        const auto stageComponent = dynamic_cast<gloperate::AbstractComponent<gloperate::Stage> *>(component);
+
+        if (stageComponent)
+        {
+            components.emplace(std::type_index(stageComponent->instanceType()), stageComponent->name());
+        }
+    }
+
+    return components;
+}
+
+std::string relativePath(const gloperate::Pipeline * root, const gloperate::Stage * stage, bool & inside)
+{
+    std::string path;
+
+    while (stage && stage != root)
+    {
+        path = path.empty() ? stage->name() : stage->name() + "." + path;
+        stage = stage->parentPipeline();
+    }
+
+    inside = (stage == root);
+    return path;
+}
+
+gloperate::Stage * resolvePath(gloperate::Pipeline * root, const std::string & path)
+{
+    gloperate::Stage * stage = root;
+
+    if (path.empty())
+    {
+        return stage;
+    }
+
+    for (const auto & name : cppassist::string::split(path, '.'))
+    {
+        if (!stage || !stage->isPipeline())
+        {
+            return nullptr;
+        }
+
+        stage = static_cast<gloperate::Pipeline *>(stage)->stage(name);
+    }
+
+    return stage;
+}
+
+void writeStage(Writer & writer, const gloperate::Pipeline * root, const gloperate::Stage * stage, const std::unordered_map<std::type_index, std::string> & components)
+{
+    // Stage header
+    const auto component = components.find(std::type_index(typeid(*stage)));
+
+    writer.writeString(stage->name());
+    writer.writeString(component != components.end() ? component->second : "");
+    writer.writeUInt8(stage->isPipeline() ? s_stagePipeline : 0);
+
+    // Slots
+    writer.writeUInt32(static_cast<std::uint32_t>(stage->inputs().size() + stage->outputs().size()));
+
+    const auto writeSlot = [&writer, root] (const gloperate::AbstractSlot * slot, bool input)
+    {
+        std::uint8_t flags = input ? s_slotInput : 0;
+        if (slot->isDynamic())  flags |= s_slotDynamic;
+        if (slot->isFeedback()) flags |= s_slotFeedback;
+
+        std::string sourcePath;
+        auto source = slot->isConnected() ? slot->source() : nullptr;
+
+        if (source)
+        {
+            // Connections to slots outside of the pipeline cannot be restored
+            auto inside = false;
+            sourcePath = relativePath(root, source->parentStage(), inside);
+
+            if (!inside)
+            {
+                warning("gloperate") << "snapshot: connection of " << slot->qualifiedName() << " leaves the pipeline and is not stored";
+                source = nullptr;
+            }
+        }
+
+        if (source)
+        {
+            flags |= s_slotConnected;
+
+            const auto sourceStage = source->parentStage();
+            if (sourceStage->input(source->name()) == source)
+            {
+                flags |= s_sourceInput;
+            }
+        }
+        else if (input)
+        {
+            flags |= s_slotValue;
+        }
+
+        writer.writeUInt8(flags);
+        writer.writeString(slot->name());
+        writer.writeString(slot->typeName());
+
+        if (flags & s_slotConnected)
+        {
+            writer.writeString(sourcePath);
+            writer.writeString(source->name());
+        }
+
+        if (flags & s_slotValue)
+        {
+            writer.writeValue(slot->toVariant());
+        }
+    };
+
+    for (auto slot : stage->inputs())
+    {
+        writeSlot(slot, true);
+    }
+
+    for (auto slot : stage->outputs())
+    {
+        writeSlot(slot, false);
+    }
+
+    // Stages in the order of execution
+    if (stage->isPipeline())
+    {
+        const auto & stages = static_cast<const gloperate::Pipeline *>(stage)->stages();
+
+        writer.writeUInt32(static_cast<std::uint32_t>(stages.size()));
+
+        for (auto subStage : stages)
+        {
+            writeStage(writer, root, subStage, components);
+        }
+    }
+}
+
+bool readStage(Reader & reader, RestoreState & state, gloperate::Stage * stage, bool isPipeline)
+{
+    if (stage && stage->isPipeline() != isPipeline)
+    {
+        critical("gloperate") << "snapshot: stage " << stage->qualifiedName() << " does not match the snapshot";
+        return false;
+    }
+
+    // Slots
+    std::uint32_t slotCount = 0;
+    if (!reader.readUInt32(slotCount))
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < slotCount; ++i)
+    {
+        PendingSlot pending;
+        pending.slot  = nullptr;
+        pending.flags = 0;
+
+        std::string name;
+        std::string type;
+
+        if (!reader.readUInt8(pending.flags) || !reader.readString(name) || !reader.readString(type))
+        {
+            return false;
+        }
+
+        if ((pending.flags & s_slotConnected) && (!reader.readString(pending.sourcePath) || !reader.readString(pending.sourceSlot)))
+        {
+            return false;
+        }
+
+        if ((pending.flags & s_slotValue) && !reader.readValue(pending.value))
+        {
+            return false;
+        }
+
+        // Stages that could not be created are skipped
+        if (!stage)
+        {
+            continue;
+        }
+
+        const auto input = (pending.flags & s_slotInput) != 0;
+        pending.slot = input ? stage->input(name) : stage->output(name);
+
+        if (!pending.slot && (pending.flags & s_slotDynamic))
+        {
+            pending.slot = stage->createSlot(input ? "Input" : "Output", type, name);
+        }
+
+        if (!pending.slot)
+        {
+            warning("gloperate") << "snapshot: cannot restore slot " << stage->qualifiedName() << "." << name << " of type " << type;
+            continue;
+        }
+
+        pending.slot->setFeedback((pending.flags & s_slotFeedback) != 0);
+        state.slots.push_back(std::move(pending));
+    }
+
+    if (!isPipeline)
+    {
+        return true;
+    }
+
+    // Stages
+    std::uint32_t stageCount = 0;
+    if (!reader.readUInt32(stageCount))
+    {
+        return false;
+    }
+
+    const auto pipeline = static_cast<gloperate::Pipeline *>(stage);
+    std::vector<gloperate::Stage *> order;
+    order.reserve(stageCount);
+
+    for (std::uint32_t i = 0; i < stageCount; ++i)
+    {
+        std::string name;
+        std::string componentName;
+        std::uint8_t flags = 0;
+
+        if (!reader.readString(name) || !reader.readString(componentName) || !reader.readUInt8(flags))
+        {
+            return false;
+        }
+
+        gloperate::Stage * subStage = nullptr;
+
+        if (pipeline)
+        {
+            // Reuse stages created by the pipeline itself
+            subStage = pipeline->stage(name);
+
+            if (!subStage)
+            {
+                auto component = componentName.empty() ? nullptr : state.environment->componentManager()->component<gloperate::Stage>(componentName);
+
+                if (component)
+                {
+                    auto newStage = component->createInstance(state.environment, name);
+                    subStage = newStage.get();
+
+                    pipeline->addStage(std::move(newStage));
+                }
+                else
+                {
+                    warning("gloperate") << "snapshot: cannot create stage " << pipeline->qualifiedName() << "." << name << " of type '" << componentName << "'";
+                }
+            }
+
+            if (subStage)
+            {
+                order.push_back(subStage);
+            }
+        }
+
+        if (!readStage(reader, state, subStage, (flags & s_stagePipeline) != 0))
+        {
+            return false;
+        }
+    }
+
+    if (!pipeline)
+    {
+        return true;
+    }
+
+    // Remove stages that are not part of the snapshot
+    const std::unordered_set<gloperate::Stage *> restored(order.begin(), order.end());
+    const auto stages = pipeline->stages();
+
+    for (auto subStage : stages)
+    {
+        if (restored.count(subStage) == 0)
+        {
+            pipeline->removeStage(subStage);
+        }
+    }
+
+    state.orders.emplace_back(pipeline, std::move(order));
+
+    return true;
+}
+
+bool readHeader(Reader & reader)
+{
+    char magic[sizeof(s_magic)];
+    std::uint32_t version = 0;
+    std::uint32_t reserved = 0;
+
+    if (!reader.readBytes(magic, sizeof(magic)) || std::memcmp(magic, s_magic, sizeof(magic)) != 0)
+    {
+        critical("gloperate") << "snapshot: invalid data";
+        return false;
+    }
+
+    if (!reader.readUInt32(version) || !reader.readUInt32(reserved) || version != gloperate::PipelineSnapshot::version)
+    {
+        critical("gloperate") << "snapshot: unsupported version " << version;
+        return false;
+    }
+
+    return true;
+}
+
+bool restoreRoot(Reader & reader, gloperate::Pipeline * pipeline)
+{
+    RestoreState state;
+    state.environment = pipeline->environment();
+    state.root        = pipeline;
+
+    // Create stages and slots
+    if (!readStage(reader, state, pipeline, true))
+    {
+        critical("gloperate") << "snapshot: invalid data";
+        return false;
+    }
+
+    // Restore connections, all stages exist now
+    for (const auto & pending : state.slots)
+    {
+        if (!(pending.flags & s_slotConnected))
+        {
+            if (pending.slot->isConnected())
+            {
+                pending.slot->disconnect();
+            }
+
+            continue;
+        }
+
+        const auto sourceStage = resolvePath(state.root, pending.sourcePath);
+        const auto source = !sourceStage ? nullptr : (pending.flags & s_sourceInput) ? sourceStage->input(pending.sourceSlot) : sourceStage->output(pending.sourceSlot);
+
+        if (!source || !pending.slot->connect(source))
+        {
+            warning("gloperate") << "snapshot: cannot connect " << pending.slot->qualifiedName() << " to " << pending.sourcePath << "." << pending.sourceSlot;
+        }
+    }
+
+    // Restore values of unconnected inputs
+    for (const auto & pending : state.slots)
+    {
+        if ((pending.flags & s_slotValue) && !pending.value.isNull())
+        {
+            pending.slot->fromVariant(pending.value);
+        }
+    }
+
+    // Adopt the stored execution plans
+    for (const auto & order : state.orders)
+    {
+        order.first->setStageOrder(order.second);
+    }
+
+    return true;
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+const std::uint32_t PipelineSnapshot::version = 1;
+
+
+std::vector<char> PipelineSnapshot::save(const Pipeline * pipeline)
+{
+    Writer writer;
+
+    writer.writeBytes(s_magic, sizeof(s_magic));
+    writer.writeUInt32(version);
+    writer.writeUInt32(0);
+
+    writeStage(writer, pipeline, pipeline, stageComponents(pipeline->environment()));
+
+    return std::move(writer.data());
+}
+
+bool PipelineSnapshot::save(const Pipeline * pipeline, const std::string & filename)
+{
+    const auto data = save(pipeline);
+
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    return static_cast<bool>(stream);
+}
+
+std::unique_ptr<Pipeline> PipelineSnapshot::load(Environment * environment, const char * data, size_t size)
+{
+    Reader reader(data, size);
+
+    std::string name;
+    std::string componentName;
+    std::uint8_t flags = 0;
+
+    if (!readHeader(reader) || !reader.readString(name) || !reader.readString(componentName) || !reader.readUInt8(flags))
+    {
+        return nullptr;
+    }
+
+    // Create root pipeline
+    auto component = componentName.empty() ? nullptr : environment->componentManager()->component<gloperate::Stage>(componentName);
+    auto stage     = component ? component->createInstance(environment, name) : nullptr;
+
+    if (!stage || !stage->isPipeline() || !(flags & s_stagePipeline))
+    {
+        critical("gloperate") << "snapshot: cannot create pipeline of type '" << componentName << "'";
+        return nullptr;
+    }
+
+    auto pipeline = std::unique_ptr<Pipeline>(static_cast<Pipeline *>(stage.release()));
+
+    if (!restoreRoot(reader, pipeline.get()))
+    {
+        return nullptr;
+    }
+
+    return pipeline;
+}
+
+std::unique_ptr<Pipeline> PipelineSnapshot::load(Environment * environment, const std::string & filename)
+{
+    MappedFile file;
+
+    if (!file.open(filename))
+    {
+        critical("gloperate") << "snapshot: cannot open " << filename;
+        return nullptr;
+    }
+
+    return load(environment, file.data(), file.size());
+}
+
+bool PipelineSnapshot::restore(Pipeline * pipeline, const char * data, size_t size)
+{
+    Reader reader(data, size);
+
+    std::string name;
+    std::string componentName;
+    std::uint8_t flags = 0;
+
+    if (!readHeader(reader) || !reader.readString(name) || !reader.readString(componentName) || !reader.readUInt8(flags) || !(flags & s_stagePipeline))
+    {
+        return false;
+    }
+
+    return restoreRoot(reader, pipeline);
+}
+
+
+} // namespace gloperate
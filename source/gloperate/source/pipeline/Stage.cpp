@@ -2,9 +2,12 @@
 #include <gloperate/pipeline/Stage.h>
 
 #include <algorithm>
+#include <chrono>
+#include <mutex>
 
 #include <cppassist/string/conversion.h>
 #include <cppassist/logging/logging.h>
+#include <cppassist/memory/make_unique.h>
 
 #include <cppexpose/variant/Variant.h>
 
@@ -13,9 +16,11 @@
 #include <globjects/Texture.h>
 #include <globjects/Framebuffer.h>
 
+#include <gloperate/base/Environment.h>
 #include <gloperate/base/ExtendedProperties.h>
 #include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/pipeline/AbstractSlot.h>
+#include <gloperate/rendering/TimerQueryRing.h>
 
 
 using namespace cppassist;
@@ -24,13 +29,36 @@ using namespace cppexpose;
 
 namespace
 {
-    enum Query
+    // Number of iterations whose GPU times can be pending
+    const size_t s_timerQueries = 8;
+
+    // Serializes the propagation of slot changes, as context-free stages may be processed in parallel
+    std::recursive_mutex propagationMutex;
+
+    // Result for types without slots
+    const std::vector<gloperate::AbstractSlot *> noSlots;
+
+    // Remove slot from the lists of slots by type, without accessing the slot (it may be in destruction)
+    void removeFromTypeIndex(std::unordered_map<std::type_index, std::vector<gloperate::AbstractSlot *>> & slotsByType, gloperate::AbstractSlot * slot)
     {
-        PairOneStart = 0,
-        PairOneEnd = 1,
-        PairTwoStart = 2,
-        PairTwoEnd = 3
-    };
+        for (auto it = slotsByType.begin(); it != slotsByType.end(); ++it)
+        {
+            auto & slots = it->second;
+            const auto pos = std::find(slots.begin(), slots.end(), slot);
+
+            if (pos != slots.end())
+            {
+                slots.erase(pos);
+
+                if (slots.empty())
+                {
+                    slotsByType.erase(it);
+                }
+
+                return;
+            }
+        }
+    }
 }
 
 
@@ -54,12 +82,13 @@ Stage::Stage(Environment * environment, const std::string & className, const std
 : cppexpose::Object((name.empty()) ? className : name)
 , m_environment(environment)
 , m_alwaysProcess(false)
+, m_contextFree(false)
 , m_timeMeasurement(false)
-, m_useQueryPairOne(true)
 , m_resultAvailable(false)
 , m_lastCPUDuration(0)
 , m_currentCPUDuration(0)
 , m_lastGPUDuration(0)
+, m_slotRevision(0)
 {
     // Set object class name
     setClassName(className);
@@ -111,21 +140,6 @@ void Stage::initContext(AbstractGLContext * context)
 {
     debug(2, "gloperate") << this->qualifiedName() << ": initContext";
 
-    // Create time queries
-    gl::glGenQueries(4, m_queries.data());
-
-    // Dummy querys for first frame
-    if (m_useQueryPairOne)
-    {
-        gl::glQueryCounter(m_queries[Query::PairOneStart], gl::GL_TIMESTAMP);
-        gl::glQueryCounter(m_queries[Query::PairOneEnd], gl::GL_TIMESTAMP);
-    }
-    else
-    {
-        gl::glQueryCounter(m_queries[Query::PairTwoStart], gl::GL_TIMESTAMP);
-        gl::glQueryCounter(m_queries[Query::PairTwoEnd], gl::GL_TIMESTAMP);
-    }
-
     onContextInit(context);
 }
 
@@ -133,54 +147,94 @@ void Stage::deinitContext(AbstractGLContext * context)
 {
     debug(2, "gloperate") << this->qualifiedName() << ": deinitContex";
     onContextDeinit(context);
+
+    // Release time queries
+    m_timerQueries.reset();
 }
 
 void Stage::process()
 {
     debug(1, "gloperate") << this->qualifiedName() << ": processing";
 
-    if (m_timeMeasurement)
-    {
-        // Get currently used queries
-        auto usedStartQuery   = m_useQueryPairOne ? Query::PairOneStart : Query::PairTwoStart;
-        auto usedEndQuery     = m_useQueryPairOne ? Query::PairOneEnd   : Query::PairTwoEnd;
-        auto unusedStartQuery = m_useQueryPairOne ? Query::PairTwoStart : Query::PairOneStart;
-        auto unusedEndQuery   = m_useQueryPairOne ? Query::PairTwoEnd   : Query::PairOneEnd;
-
-        // Start CPU time measurement
-        auto cpu_start = std::chrono::high_resolution_clock::now();
+    auto profiler = m_environment ? m_environment->profiler() : nullptr;
+    const auto profiling = profiler && profiler->isEnabled();
 
-        // Start GPU time measurement
-        gl::glQueryCounter(m_queries[unusedStartQuery], gl::GL_TIMESTAMP);
+    if (!m_timeMeasurement && !profiling)
+    {
+        onProcess();
+    }
+    else if (m_contextFree)
+    {
+        // Measure CPU time only, as there may be no OpenGL context on this thread
+        auto cpu_start = std::chrono::steady_clock::now();
 
-        // Execute stage
         onProcess();
 
-        // Stop CPU time measurement
-        auto cpu_end = std::chrono::high_resolution_clock::now();
+        auto cpu_end = std::chrono::steady_clock::now();
         m_lastCPUDuration = m_currentCPUDuration;
         m_currentCPUDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(cpu_end - cpu_start).count();
+        m_lastGPUDuration = 0;
 
-        // Stop GPU time measurement
-        gl::glQueryCounter(m_queries[unusedEndQuery], gl::GL_TIMESTAMP);
-
-        // Get GPU values from last frame
-        gl::GLuint64 gpu_start, gpu_end;
-        gl::glGetQueryObjectui64v(m_queries[usedStartQuery], gl::GL_QUERY_RESULT, &gpu_start);
-        gl::glGetQueryObjectui64v(m_queries[usedEndQuery], gl::GL_QUERY_RESULT, &gpu_end);
-        m_lastGPUDuration = gpu_end - gpu_start;
-
-        // Switch queries for next frame
-        m_useQueryPairOne = !m_useQueryPairOne;
+        if (profiling)
+        {
+            profiler->addCPUSpan(qualifiedName(), profiler->time(cpu_start), profiler->time(cpu_end));
+        }
 
         // Emit measured times
-        if (m_resultAvailable) {
-            timeMeasured(m_lastCPUDuration, m_lastGPUDuration);
-        } else m_resultAvailable = true;
+        if (m_timeMeasurement)
+        {
+            if (m_resultAvailable) {
+                timeMeasured(m_lastCPUDuration, m_lastGPUDuration);
+            } else m_resultAvailable = true;
+        }
     }
     else
     {
+        if (!m_timerQueries)
+        {
+            m_timerQueries = cppassist::make_unique<TimerQueryRing>(s_timerQueries);
+        }
+
+        // Start CPU time measurement
+        auto cpu_start = std::chrono::steady_clock::now();
+
+        // Start GPU time measurement (skipped if the GPU is too far behind)
+        m_timerQueries->begin();
+
+        // Execute stage
         onProcess();
+
+        // Stop CPU time measurement
+        auto cpu_end = std::chrono::steady_clock::now();
+        auto cpu_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(cpu_end - cpu_start).count();
+
+        // Stop GPU time measurement, the CPU time is reported together with the GPU time
+        m_timerQueries->end(cpu_duration);
+
+        const auto name = profiling ? qualifiedName() : std::string();
+
+        if (profiling)
+        {
+            profiler->addCPUSpan(name, profiler->time(cpu_start), profiler->time(cpu_end));
+        }
+
+        // Get results of earlier iterations that the GPU has finished, without waiting
+        m_timerQueries->poll([this, profiler, profiling, &name] (std::uint64_t cpuDuration, gl::GLuint64 gpu_start, gl::GLuint64 gpu_end)
+        {
+            m_lastCPUDuration = cpuDuration;
+            m_lastGPUDuration = gpu_end - gpu_start;
+
+            if (profiling)
+            {
+                profiler->addGPUSpan(name, gpu_start, gpu_end);
+            }
+
+            // Emit measured times
+            if (m_timeMeasurement)
+            {
+                timeMeasured(m_lastCPUDuration, m_lastGPUDuration);
+            }
+        });
     }
 
     for (auto input : m_inputs)
@@ -217,6 +271,22 @@ void Stage::setAlwaysProcessed(bool alwaysProcess)
 {
     debug(2, "gloperate") << this->qualifiedName() << ": set always processed to " << alwaysProcess;
     m_alwaysProcess = alwaysProcess;
+
+    if (m_alwaysProcess)
+    {
+        markDirty();
+    }
+}
+
+bool Stage::isContextFree() const
+{
+    return m_contextFree;
+}
+
+void Stage::setContextFree(bool contextFree)
+{
+    debug(2, "gloperate") << this->qualifiedName() << ": set context-free to " << contextFree;
+    m_contextFree = contextFree;
 }
 
 void Stage::invalidateOutputs()
@@ -351,8 +421,17 @@ void Stage::registerInput(AbstractSlot * input)
         m_inputsMap.insert(std::make_pair(input->name(), input));
     }
 
+    m_inputsByType[std::type_index(input->type())].push_back(input);
+    ++m_slotRevision;
+
     debug(2, "gloperate") << input->qualifiedName() << ": add input to stage";
 
+    // Update dependencies if the input has already been connected
+    if (input->isConnected())
+    {
+        invalidateInputConnections();
+    }
+
     // Emit signal
     inputAdded(input);
 }
@@ -368,6 +447,11 @@ void Stage::removeInput(AbstractSlot * input)
         // Remove input
         m_inputs.erase(it);
         m_inputsMap.erase(input->name());
+        removeFromTypeIndex(m_inputsByType, input);
+        ++m_slotRevision;
+
+        // Update dependencies (the input must not be accessed here, as it may be in destruction)
+        invalidateInputConnections();
 
         // Emit signal
         inputRemoved(input);
@@ -441,6 +525,9 @@ void Stage::registerOutput(AbstractSlot * output)
         m_outputsMap.insert(std::make_pair(output->name(), output));
     }
 
+    m_outputsByType[std::type_index(output->type())].push_back(output);
+    ++m_slotRevision;
+
     debug(2, "gloperate") << output->qualifiedName() << ": add output to stage";
 
     // Emit signal
@@ -458,6 +545,8 @@ void Stage::removeOutput(AbstractSlot * output)
         // Remove output
         m_outputs.erase(it);
         m_outputsMap.erase(output->name());
+        removeFromTypeIndex(m_outputsByType, output);
+        ++m_slotRevision;
 
         // Emit signal
         outputRemoved(output);
@@ -467,14 +556,26 @@ void Stage::removeOutput(AbstractSlot * output)
     removeProperty(output);
 }
 
+void Stage::markDirty()
+{
+    if (Pipeline * pipeline = parentPipeline())
+    {
+        pipeline->markStageDirty(this);
+    }
+}
+
 void Stage::outputRequiredChanged(AbstractSlot * slot)
 {
     debug(2, "gloperate") << this->qualifiedName() << ": output required changed for " << slot->qualifiedName();
+
+    std::lock_guard<std::recursive_mutex> lock(propagationMutex);
     onOutputRequiredChanged(slot);
 }
 
 void Stage::inputValueChanged(AbstractSlot * slot)
 {
+    std::lock_guard<std::recursive_mutex> lock(propagationMutex);
+
     inputChanged(slot);
 
     onInputValueChanged(slot);
@@ -482,11 +583,15 @@ void Stage::inputValueChanged(AbstractSlot * slot)
 
 void Stage::inputValueInvalidated(AbstractSlot * slot)
 {
+    std::lock_guard<std::recursive_mutex> lock(propagationMutex);
+
     onInputValueInvalidated(slot);
 }
 
 void Stage::inputOptionsChanged(AbstractSlot * slot)
 {
+    std::lock_guard<std::recursive_mutex> lock(propagationMutex);
+
     inputChanged(slot);
 }
 
@@ -586,12 +691,31 @@ void Stage::onOutputRequiredChanged(AbstractSlot *)
 
 void Stage::invalidateInputConnections()
 {
-    if (parentPipeline())
+    if (Pipeline * pipeline = parentPipeline())
     {
-        parentPipeline()->invalidateStageOrder();
+        pipeline->invalidateStageDependencies(this);
     }
 }
 
+size_t Stage::slotRevision() const
+{
+    return m_slotRevision;
+}
+
+const std::vector<AbstractSlot *> & Stage::inputsOfType(const std::type_info & type) const
+{
+    const auto it = m_inputsByType.find(std::type_index(type));
+
+    return it != m_inputsByType.end() ? it->second : noSlots;
+}
+
+const std::vector<AbstractSlot *> & Stage::outputsOfType(const std::type_info & type) const
+{
+    const auto it = m_outputsByType.find(std::type_index(type));
+
+    return it != m_outputsByType.end() ? it->second : noSlots;
+}
+
 void Stage::forAllInputs(std::function<void(gloperate::AbstractSlot *)> callback)
 {
     for (const auto input : m_inputs)
@@ -630,6 +754,12 @@ void Stage::setTimeMeasurement(bool enabled, bool)
     m_currentCPUDuration = 0;
     m_lastCPUDuration    = 0;
     m_lastGPUDuration    = 0;
+
+    // Do not report results measured before
+    if (m_timerQueries)
+    {
+        m_timerQueries->discard();
+    }
 }
 
 
@@ -1,6 +1,8 @@
 
 #include <gloperate/rendering/AbstractRenderTarget.h>
 
+#include <atomic>
+
 #include <glbinding/gl/types.h>
 #include <glbinding/gl/enum.h>
 
@@ -10,6 +12,22 @@
 #include <globjects/Texture.h>
 
 
+namespace
+{
+
+
+std::atomic<size_t> s_generation(0);
+
+
+size_t nextGeneration()
+{
+    return ++s_generation;
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -20,6 +38,7 @@ AbstractRenderTarget::AbstractRenderTarget()
 , m_texture(nullptr)
 , m_renderbuffer(nullptr)
 , m_userDefinedFBOAttachment(nullptr)
+, m_generation(nextGeneration())
 {
 }
 
@@ -50,6 +69,7 @@ void AbstractRenderTarget::releaseTarget()
     }
 
     m_currentTargetType = RenderTargetType::Invalid;
+    m_generation        = nextGeneration();
 }
 
 void AbstractRenderTarget::setTarget(globjects::Texture * texture)
@@ -72,6 +92,11 @@ void AbstractRenderTarget::setTarget(globjects::Renderbuffer * renderbuffer)
 
 void AbstractRenderTarget::setTarget(gl::GLenum attachment)
 {
+    if (m_currentTargetType == RenderTargetType::DefaultFBOAttachment && m_defaultFBOAttachment == attachment)
+    {
+        return;
+    }
+
     releaseTarget();
 
     m_currentTargetType = RenderTargetType::DefaultFBOAttachment;
@@ -120,6 +145,11 @@ bool AbstractRenderTarget::attachmentRequiresUserDefinedFramebuffer() const
         || m_currentTargetType == RenderTargetType::UserDefinedFBOAttachment;
 }
 
+size_t AbstractRenderTarget::generation() const
+{
+    return m_generation;
+}
+
 gl::GLenum AbstractRenderTarget::clearBufferAttachment() const
 {
     return attachmentRequiresUserDefinedFramebuffer()
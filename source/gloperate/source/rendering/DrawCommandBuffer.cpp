@@ -0,0 +1,118 @@
+
+#include <gloperate/rendering/DrawCommandBuffer.h>
+
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+
+
+namespace gloperate
+{
+
+
+DrawCommandBuffer::DrawCommandBuffer()
+: m_buffer(cppassist::make_unique<globjects::Buffer>())
+, m_capacity(0)
+, m_modified(false)
+{
+}
+
+DrawCommandBuffer::~DrawCommandBuffer()
+{
+}
+
+void DrawCommandBuffer::clear()
+{
+    m_arraysCommands.clear();
+    m_elementsCommands.clear();
+
+    m_modified = true;
+}
+
+void DrawCommandBuffer::addArrays(gl::GLuint count, gl::GLuint instanceCount, gl::GLuint first, gl::GLuint baseInstance)
+{
+    m_arraysCommands.push_back(ArraysCommand{ count, instanceCount, first, baseInstance });
+
+    m_modified = true;
+}
+
+void DrawCommandBuffer::addElements(gl::GLuint count, gl::GLuint instanceCount, gl::GLuint firstIndex, gl::GLint baseVertex, gl::GLuint baseInstance)
+{
+    m_elementsCommands.push_back(ElementsCommand{ count, instanceCount, firstIndex, baseVertex, baseInstance });
+
+    m_modified = true;
+}
+
+const std::vector<DrawCommandBuffer::ArraysCommand> & DrawCommandBuffer::arraysCommands() const
+{
+    return m_arraysCommands;
+}
+
+std::vector<DrawCommandBuffer::ArraysCommand> & DrawCommandBuffer::arraysCommands()
+{
+    m_modified = true;
+
+    return m_arraysCommands;
+}
+
+const std::vector<DrawCommandBuffer::ElementsCommand> & DrawCommandBuffer::elementsCommands() const
+{
+    return m_elementsCommands;
+}
+
+std::vector<DrawCommandBuffer::ElementsCommand> & DrawCommandBuffer::elementsCommands()
+{
+    m_modified = true;
+
+    return m_elementsCommands;
+}
+
+void DrawCommandBuffer::upload()
+{
+    if (!m_modified)
+    {
+        return;
+    }
+
+    const auto arraysSize   = m_arraysCommands.size() * sizeof(ArraysCommand);
+    const auto elementsSize = m_elementsCommands.size() * sizeof(ElementsCommand);
+    const auto size         = arraysSize + elementsSize;
+
+    // Grow geometrically, so that filling a few more commands each frame does not reallocate
+    if (size > m_capacity)
+    {
+        m_capacity = std::max(size, 2 * m_capacity);
+    }
+
+    // Orphan the previous storage, which may still be used by pending draw calls
+    m_buffer->setData(static_cast<gl::GLsizeiptr>(m_capacity), nullptr, gl::GL_DYNAMIC_DRAW);
+
+    if (arraysSize > 0)
+    {
+        m_buffer->setSubData(0, static_cast<gl::GLsizeiptr>(arraysSize), m_arraysCommands.data());
+    }
+
+    if (elementsSize > 0)
+    {
+        m_buffer->setSubData(static_cast<gl::GLintptr>(arraysSize), static_cast<gl::GLsizeiptr>(elementsSize), m_elementsCommands.data());
+    }
+
+    m_modified = false;
+}
+
+globjects::Buffer * DrawCommandBuffer::buffer() const
+{
+    return m_buffer.get();
+}
+
+size_t DrawCommandBuffer::elementsOffset() const
+{
+    return m_arraysCommands.size() * sizeof(ArraysCommand);
+}
+
+
+} // namespace gloperate
@@ -6,10 +6,13 @@
 #include <cppassist/memory/make_unique.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
 
 #include <globjects/VertexArray.h>
 #include <globjects/VertexAttributeBinding.h>
 
+#include <gloperate/rendering/DrawCommandBuffer.h>
+
 
 namespace gloperate
 {
@@ -19,6 +22,8 @@ Drawable::Drawable()
 : m_vao(cppassist::make_unique<globjects::VertexArray>())
 , m_drawMode(DrawMode::Arrays)
 , m_size(0)
+, m_instanceCount(1)
+, m_commandBuffer(nullptr)
 , m_primitiveMode(gl::GL_TRIANGLES)
 , m_indexBufferType(gl::GL_UNSIGNED_INT)
 , m_indexBuffer(nullptr)
@@ -58,6 +63,14 @@ void Drawable::draw(DrawMode drawMode) const
         drawElements();
         break;
 
+    case DrawMode::ArraysIndirect:
+        drawArraysIndirect(m_primitiveMode);
+        break;
+
+    case DrawMode::ElementsIndirect:
+        drawElementsIndirect(m_primitiveMode);
+        break;
+
     case DrawMode::Arrays:
     default:
         drawArrays();
@@ -82,7 +95,14 @@ void Drawable::drawArrays(gl::GLint first, gl::GLsizei count) const
 
 void Drawable::drawArrays(gl::GLenum mode, gl::GLint first, gl::GLsizei count) const
 {
-    m_vao->drawArrays(mode, first, count);
+    if (m_instanceCount != 1)
+    {
+        m_vao->drawArraysInstanced(mode, first, count, m_instanceCount);
+    }
+    else
+    {
+        m_vao->drawArrays(mode, first, count);
+    }
 }
 
 void Drawable::drawElements() const
@@ -107,13 +127,66 @@ void Drawable::drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type,
     // [TODO]: rethink recorded vao state
     globjects::Buffer::unbind(gl::GL_ELEMENT_ARRAY_BUFFER);
 
-    m_vao->drawElements(mode, count, type, indices);
+    if (m_instanceCount != 1)
+    {
+        m_vao->drawElementsInstanced(mode, count, type, indices, m_instanceCount);
+    }
+    else
+    {
+        m_vao->drawElements(mode, count, type, indices);
+    }
 }
 
 void Drawable::drawElements(gl::GLenum mode, gl::GLsizei count, gl::GLenum type, globjects::Buffer *) const
 {
     // [TODO]: rethink recorded vao state
-    m_vao->drawElements(mode, count, type, nullptr);
+    if (m_instanceCount != 1)
+    {
+        m_vao->drawElementsInstanced(mode, count, type, nullptr, m_instanceCount);
+    }
+    else
+    {
+        m_vao->drawElements(mode, count, type, nullptr);
+    }
+}
+
+void Drawable::drawArraysIndirect(gl::GLenum mode) const
+{
+    if (!m_commandBuffer || m_commandBuffer->arraysCommands().empty())
+    {
+        return;
+    }
+
+    m_commandBuffer->upload();
+
+    m_vao->bind();
+    m_commandBuffer->buffer()->bind(gl::GL_DRAW_INDIRECT_BUFFER);
+
+    gl::glMultiDrawArraysIndirect(mode, nullptr, static_cast<gl::GLsizei>(m_commandBuffer->arraysCommands().size()), 0);
+
+    globjects::Buffer::unbind(gl::GL_DRAW_INDIRECT_BUFFER);
+    m_vao->unbind();
+}
+
+void Drawable::drawElementsIndirect(gl::GLenum mode) const
+{
+    if (!m_commandBuffer || m_commandBuffer->elementsCommands().empty())
+    {
+        return;
+    }
+
+    m_commandBuffer->upload();
+
+    m_vao->bind();
+    m_commandBuffer->buffer()->bind(gl::GL_DRAW_INDIRECT_BUFFER);
+
+    // The elements commands follow the arrays commands in the buffer
+    const auto offset = reinterpret_cast<const void *>(m_commandBuffer->elementsOffset());
+
+    gl::glMultiDrawElementsIndirect(mode, m_indexBufferType, offset, static_cast<gl::GLsizei>(m_commandBuffer->elementsCommands().size()), 0);
+
+    globjects::Buffer::unbind(gl::GL_DRAW_INDIRECT_BUFFER);
+    m_vao->unbind();
 }
 
 gl::GLsizei Drawable::size() const
@@ -126,6 +199,26 @@ void Drawable::setSize(gl::GLsizei size)
     m_size = size;
 }
 
+gl::GLsizei Drawable::instanceCount() const
+{
+    return m_instanceCount;
+}
+
+void Drawable::setInstanceCount(gl::GLsizei instanceCount)
+{
+    m_instanceCount = instanceCount;
+}
+
+DrawCommandBuffer * Drawable::commandBuffer() const
+{
+    return m_commandBuffer;
+}
+
+void Drawable::setCommandBuffer(DrawCommandBuffer * commandBuffer)
+{
+    m_commandBuffer = commandBuffer;
+}
+
 gl::GLenum Drawable::primitiveMode() const
 {
     return m_primitiveMode;
@@ -227,6 +320,11 @@ void Drawable::setAttributeBindingFormatL(size_t bindingIndex, gl::GLint size, g
     m_vao->binding(bindingIndex)->setLFormat(size, type, relativeOffset);
 }
 
+void Drawable::setAttributeBindingDivisor(size_t bindingIndex, gl::GLint divisor)
+{
+    m_vao->binding(bindingIndex)->setDivisor(divisor);
+}
+
 void Drawable::bindAttribute(size_t bindingIndex, gl::GLint attributeIndex)
 {
     m_vao->binding(bindingIndex)->setAttribute(attributeIndex);
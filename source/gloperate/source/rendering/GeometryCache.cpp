@@ -0,0 +1,85 @@
+
+#include <gloperate/rendering/GeometryCache.h>
+
+#include <tuple>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Buffer.h>
+
+
+namespace gloperate
+{
+
+
+std::mutex GeometryCache::s_mutex;
+std::map<GeometryCache::Key, std::weak_ptr<const GeometryCache::Geometry>> GeometryCache::s_geometries;
+
+
+bool GeometryCache::Key::operator<(const Key & other) const
+{
+    return std::tie(context, type, level, size, texCoords) < std::tie(other.context, other.type, other.level, other.size, other.texCoords);
+}
+
+GeometryCache::Geometry::Geometry()
+: indexType(gl::GL_UNSIGNED_INT)
+, size(0)
+{
+}
+
+GeometryCache::Geometry::~Geometry()
+{
+}
+
+std::shared_ptr<const GeometryCache::Geometry> GeometryCache::obtain(const Key & key, const std::function<std::unique_ptr<Geometry> ()> & create)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    // Reuse geometry that is still in use
+    auto & entry = s_geometries[key];
+    auto geometry = entry.lock();
+
+    if (geometry)
+    {
+        return geometry;
+    }
+
+    // Remove geometry that is not used anymore
+    for (auto it = s_geometries.begin(); it != s_geometries.end(); )
+    {
+        if (it->second.expired() && &it->second != &entry)
+        {
+            it = s_geometries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Create geometry
+    geometry = std::shared_ptr<const Geometry>(create());
+    entry    = geometry;
+
+    return geometry;
+}
+
+void GeometryCache::releaseContext(const AbstractGLContext * context)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto it = s_geometries.begin(); it != s_geometries.end(); )
+    {
+        if (it->first.context == context)
+        {
+            it = s_geometries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+} // namespace gloperate
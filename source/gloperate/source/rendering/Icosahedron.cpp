@@ -11,6 +11,17 @@
 using namespace glm;
 
 
+namespace
+{
+
+
+const size_t     s_maxValence = 6;                             ///< Maximum number of edges per point on refined icosahedra
+const gl::GLuint s_noPoint    = static_cast<gl::GLuint>(-1); ///< Marks unused entries of the edge table
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
@@ -117,7 +128,7 @@ const std::vector<glm::vec2> & Icosahedron::texcoords() const
     return m_texcoords;
 }
 
-const std::vector<std::array<gl::GLushort, 3>> & Icosahedron::indices() const
+const std::vector<Icosahedron::Face> & Icosahedron::indices() const
 {
     return m_indices;
 }
@@ -127,23 +138,39 @@ void Icosahedron::refine(
 ,   std::vector<Face> & indices
 ,   const unsigned char levels)
 {
-    std::unordered_map<uint, gl::GLushort> cache;
+    // Each level adds a point per edge (3 edges per face, each shared by 2 faces) and quadruples the faces
+    size_t numVertices = vertices.size();
+    size_t numFaces    = indices.size();
+
+    for(int i = 0; i < levels; ++i)
+    {
+        numVertices += numFaces * 3 / 2;
+        numFaces    *= 4;
+    }
+
+    vertices.reserve(numVertices);
+    indices.reserve(numFaces);
+
+    std::vector<Edge> edges;
 
     for(int i = 0; i < levels; ++i)
     {
+        // Only edges between the points of the previous level are split
+        edges.assign(vertices.size() * s_maxValence, Edge{ s_noPoint, s_noPoint });
+
         const int size(static_cast<int>(indices.size()));
 
         for(int f = 0; f < size; ++f)
         {
             Face & face = indices[f];
 
-            const gl::GLushort a(face[0]);
-            const gl::GLushort b(face[1]);
-            const gl::GLushort c(face[2]);
+            const gl::GLuint a(face[0]);
+            const gl::GLuint b(face[1]);
+            const gl::GLuint c(face[2]);
 
-            const gl::GLushort ab(split(a, b, vertices, cache));
-            const gl::GLushort bc(split(b, c, vertices, cache));
-            const gl::GLushort ca(split(c, a, vertices, cache));
+            const gl::GLuint ab(split(a, b, vertices, edges));
+            const gl::GLuint bc(split(b, c, vertices, edges));
+            const gl::GLuint ca(split(c, a, vertices, edges));
 
             face = {{ ab, bc, ca }};
 
@@ -154,27 +181,35 @@ void Icosahedron::refine(
     }
 }
 
-gl::GLushort Icosahedron::split(
-    const gl::GLushort a
-,   const gl::GLushort b
+gl::GLuint Icosahedron::split(
+    const gl::GLuint a
+,   const gl::GLuint b
 ,   std::vector<vec3> & points
-,   std::unordered_map<uint, gl::GLushort> & cache)
+,   std::vector<Edge> & edges)
 {
     const bool aSmaller(a < b);
 
-    const uint smaller(aSmaller ? a : b);
-    const uint greater(aSmaller ? b : a);
-    const uint hash((smaller << 16) + greater);
+    const gl::GLuint smaller(aSmaller ? a : b);
+    const gl::GLuint greater(aSmaller ? b : a);
+
+    // Look up edge in the entries of the smaller point
+    const auto begin = edges.begin() + smaller * s_maxValence;
+    const auto end   = begin + s_maxValence;
+
+    auto edge = begin;
+    while (edge != end && edge->other != s_noPoint && edge->other != greater)
+        ++edge;
 
-    auto h(cache.find(hash));
-    if(cache.end() != h)
-        return h->second;
+    if (edge != end && edge->other == greater)
+        return edge->midpoint;
 
     points.push_back(normalize((points[a] + points[b]) * 0.5f));
 
-    const gl::GLushort i = static_cast<gl::GLushort>(points.size() - 1);
+    const gl::GLuint i = static_cast<gl::GLuint>(points.size() - 1);
 
-    cache[hash] = i;
+    // Points with more edges than on an icosahedron only lose the sharing of midpoints
+    if (edge != end)
+        *edge = Edge{ greater, i };
 
     return i;
 }
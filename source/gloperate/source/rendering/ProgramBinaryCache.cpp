@@ -0,0 +1,391 @@
+
+#include <gloperate/rendering/ProgramBinaryCache.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <set>
+
+#include <cppassist/logging/logging.h>
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/extension.h>
+#include <glbinding/gl/functions.h>
+#include <glbinding/Version.h>
+#include <glbinding-aux/ContextInfo.h>
+
+#include <globjects/NamedString.h>
+#include <globjects/Program.h>
+#include <globjects/ProgramBinary.h>
+#include <globjects/Shader.h>
+
+
+namespace
+{
+
+
+const char          s_magic[8]   = { 'G', 'L', 'O', 'P', 'B', 'I', 'N', '1' };
+const std::uint64_t s_fnvOffset  = 14695981039346656037ull;
+const std::uint64_t s_fnvPrime   = 1099511628211ull;
+
+
+std::uint64_t fnv1a(const void * data, size_t size, std::uint64_t hash)
+{
+    const auto bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= s_fnvPrime;
+    }
+
+    return hash;
+}
+
+// Hash contents of all named strings included by a source, recursively
+bool hashIncludes(const std::string & source, std::set<std::string> & included, std::uint64_t & hash)
+{
+    std::istringstream stream(source);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        // Find '#include <name>' or '#include "name"'
+        auto pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '#')
+        {
+            continue;
+        }
+
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+        {
+            continue;
+        }
+
+        pos = line.find_first_not_of(" \t", pos + 7);
+        if (pos == std::string::npos || (line[pos] != '<' && line[pos] != '"'))
+        {
+            continue;
+        }
+
+        const auto end = line.find(line[pos] == '<' ? '>' : '"', pos + 1);
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+
+        const auto name = line.substr(pos + 1, end - pos - 1);
+
+        // Includes relative to include paths cannot be resolved here
+        const auto namedString = globjects::NamedString::obtain(name);
+        if (!namedString)
+        {
+            return false;
+        }
+
+        if (!included.insert(name).second)
+        {
+            continue;
+        }
+
+        const auto contents = namedString->string();
+        const auto size     = static_cast<std::uint64_t>(contents.size());
+
+        hash = fnv1a(name.data(), name.size(), hash);
+        hash = fnv1a(&size, sizeof(size), hash);
+        hash = fnv1a(contents.data(), contents.size(), hash);
+
+        if (!hashIncludes(contents, included, hash))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+void writeValue(std::ostream & stream, const T & value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream & stream, T & value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+ProgramBinaryCache::ProgramBinaryCache()
+: m_hits(0)
+, m_misses(0)
+{
+}
+
+ProgramBinaryCache::~ProgramBinaryCache()
+{
+}
+
+std::string ProgramBinaryCache::directory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_directory;
+}
+
+void ProgramBinaryCache::setDirectory(const std::string & directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_directory = directory;
+}
+
+std::unique_ptr<globjects::ProgramBinary> ProgramBinaryCache::load(const std::vector<globjects::Shader *> & shaders)
+{
+    if (shaders.empty() || !isSupported())
+    {
+        return nullptr;
+    }
+
+    const auto driver = driverString();
+    auto programKey = std::uint64_t(0);
+
+    if (!key(shaders, driver, programKey))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Look up binary in memory
+    auto it = m_binaries.find(programKey);
+
+    // Look up binary in the cache directory
+    if (it == m_binaries.end() && !m_directory.empty())
+    {
+        Binary binary;
+
+        if (readBinary(filename(programKey), programKey, driver, binary))
+        {
+            it = m_binaries.emplace(programKey, std::move(binary)).first;
+        }
+    }
+
+    if (it == m_binaries.end())
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    return cppassist::make_unique<globjects::ProgramBinary>(it->second.format, it->second.data);
+}
+
+void ProgramBinaryCache::store(const std::vector<globjects::Shader *> & shaders, const globjects::Program * program)
+{
+    if (shaders.empty() || !isSupported() || !program->isLinked())
+    {
+        return;
+    }
+
+    // Retrieve binary from the driver
+    std::unique_ptr<globjects::ProgramBinary> programBinary = program->getBinary();
+
+    if (!programBinary || programBinary->length() <= 0)
+    {
+        return;
+    }
+
+    const auto data = static_cast<const char *>(programBinary->data());
+
+    Binary binary;
+    binary.format = programBinary->format();
+    binary.data.assign(data, data + programBinary->length());
+
+    const auto driver = driverString();
+    auto programKey = std::uint64_t(0);
+
+    if (!key(shaders, driver, programKey))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Write binary to the cache directory
+    if (!m_directory.empty() && !writeBinary(filename(programKey), programKey, driver, binary))
+    {
+        cppassist::debug(1, "gloperate") << "Could not write program binary to " << filename(programKey);
+    }
+
+    m_binaries[programKey] = std::move(binary);
+}
+
+void ProgramBinaryCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_binaries.clear();
+}
+
+size_t ProgramBinaryCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_hits;
+}
+
+size_t ProgramBinaryCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_misses;
+}
+
+bool ProgramBinaryCache::isSupported()
+{
+    // Program binaries are core since OpenGL 4.1
+    if (glbinding::aux::ContextInfo::version() < glbinding::Version(4, 1) &&
+        glbinding::aux::ContextInfo::extensions().count(gl::GLextension::GL_ARB_get_program_binary) == 0)
+    {
+        return false;
+    }
+
+    // Drivers may support the functions without providing any binary format
+    gl::GLint numFormats = 0;
+    gl::glGetIntegerv(gl::GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+    return numFormats > 0;
+}
+
+std::string ProgramBinaryCache::driverString()
+{
+    return glbinding::aux::ContextInfo::vendor() + "\n" +
+           glbinding::aux::ContextInfo::renderer() + "\n" +
+           glbinding::aux::ContextInfo::version().toString();
+}
+
+bool ProgramBinaryCache::key(const std::vector<globjects::Shader *> & shaders, const std::string & driver, std::uint64_t & programKey)
+{
+    auto hash = fnv1a(driver.data(), driver.size(), s_fnvOffset);
+    auto included = std::set<std::string>();
+
+    for (const auto shader : shaders)
+    {
+        const auto type   = static_cast<std::uint32_t>(shader->type());
+        const auto source = shader->getSource();
+        const auto size   = static_cast<std::uint64_t>(source.size());
+
+        hash = fnv1a(&type, sizeof(type), hash);
+        hash = fnv1a(&size, sizeof(size), hash);
+        hash = fnv1a(source.data(), source.size(), hash);
+
+        if (!hashIncludes(source, included, hash))
+        {
+            return false;
+        }
+    }
+
+    programKey = hash;
+    return true;
+}
+
+std::string ProgramBinaryCache::filename(std::uint64_t key) const
+{
+    std::stringstream stream;
+    stream << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".glbin";
+
+    return stream.str();
+}
+
+bool ProgramBinaryCache::readBinary(const std::string & filename, std::uint64_t key, const std::string & driver, Binary & binary)
+{
+    std::ifstream stream(filename, std::ios::binary);
+
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    // Check header
+    char          magic[sizeof(s_magic)];
+    std::uint64_t fileKey = 0;
+    std::uint32_t driverSize = 0;
+
+    if (!stream.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), s_magic) ||
+        !readValue(stream, fileKey) || fileKey != key ||
+        !readValue(stream, driverSize) || driverSize != driver.size())
+    {
+        return false;
+    }
+
+    std::string fileDriver(driverSize, '\0');
+
+    if (!stream.read(&fileDriver[0], driverSize) || fileDriver != driver)
+    {
+        return false;
+    }
+
+    // Read binary
+    std::uint32_t format = 0;
+    std::uint64_t size   = 0;
+
+    if (!readValue(stream, format) || !readValue(stream, size) || size == 0)
+    {
+        return false;
+    }
+
+    binary.format = static_cast<gl::GLenum>(format);
+    binary.data.resize(static_cast<size_t>(size));
+
+    return static_cast<bool>(stream.read(binary.data.data(), binary.data.size()));
+}
+
+bool ProgramBinaryCache::writeBinary(const std::string & filename, std::uint64_t key, const std::string & driver, const Binary & binary)
+{
+    // Write to a temporary file first, so that concurrent readers never see partial binaries
+    const auto tempFilename = filename + ".tmp";
+
+    {
+        std::ofstream stream(tempFilename, std::ios::binary | std::ios::trunc);
+
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        stream.write(s_magic, sizeof(s_magic));
+        writeValue(stream, key);
+        writeValue(stream, static_cast<std::uint32_t>(driver.size()));
+        stream.write(driver.data(), driver.size());
+        writeValue(stream, static_cast<std::uint32_t>(binary.format));
+        writeValue(stream, static_cast<std::uint64_t>(binary.data.size()));
+        stream.write(binary.data.data(), binary.data.size());
+
+        if (!stream)
+        {
+            std::remove(tempFilename.c_str());
+            return false;
+        }
+    }
+
+    // Replace previous file
+    std::remove(filename.c_str());
+
+    return std::rename(tempFilename.c_str(), filename.c_str()) == 0;
+}
+
+
+} // namespace gloperate
@@ -38,9 +38,18 @@ RenderPass::~RenderPass()
 
 void RenderPass::draw() const
 {
-    bindResources();
-    
-    if (m_stateBefore)
+    draw(nullptr, nullptr);
+}
+
+void RenderPass::draw(const RenderPass * previous, const RenderPass * next) const
+{
+    bindResources(previous);
+
+    // The previous render pass has skipped its state after rendering, if it has the same states
+    const bool sameStatesAsPrevious = previous && previous->m_stateBefore == m_stateBefore && previous->m_stateAfter == m_stateAfter;
+    const bool sameStatesAsNext     = next && next->m_stateBefore == m_stateBefore && next->m_stateAfter == m_stateAfter;
+
+    if (m_stateBefore && !sameStatesAsPrevious)
     {
         m_stateBefore->apply();
     }
@@ -53,7 +62,11 @@ void RenderPass::draw() const
         gl::glEnable(gl::GL_RASTERIZER_DISCARD);
     }
 
-    if (m_program)
+    if (previous && previous->m_program == m_program && previous->m_programPipeline == m_programPipeline)
+    {
+        // Program is still in use
+    }
+    else if (m_program)
     {
         m_program->use();
     }
@@ -82,8 +95,8 @@ void RenderPass::draw() const
 
         gl::glDisable(gl::GL_RASTERIZER_DISCARD);
     }
-    
-    if (m_stateAfter)
+
+    if (m_stateAfter && !sameStatesAsNext)
     {
         m_stateAfter->apply();
     }
@@ -446,36 +459,54 @@ globjects::Buffer * RenderPass::removeTransformFeedbackBuffer(size_t index)
     return former;
 }
 
-void RenderPass::bindResources() const
+void RenderPass::bindResources(const RenderPass * previous) const
 {
     for (const auto & pair : m_textures)
     {
-        pair.second->bindActive(pair.first);
+        if (!previous || previous->texture(pair.first) != pair.second)
+        {
+            pair.second->bindActive(pair.first);
+        }
     }
 
     for (const auto & pair : m_samplers)
     {
-        pair.second->bind(pair.first);
+        if (!previous || previous->sampler(pair.first) != pair.second)
+        {
+            pair.second->bind(pair.first);
+        }
     }
 
     for (const auto & pair : m_uniformBuffers)
     {
-        pair.second->bindBase(gl::GL_UNIFORM_BUFFER, pair.first);
+        if (!previous || previous->uniformBuffer(pair.first) != pair.second)
+        {
+            pair.second->bindBase(gl::GL_UNIFORM_BUFFER, pair.first);
+        }
     }
 
     for (const auto & pair : m_atomicCounterBuffers)
     {
-        pair.second->bindBase(gl::GL_ATOMIC_COUNTER_BUFFER, pair.first);
+        if (!previous || previous->atomicCounterBuffer(pair.first) != pair.second)
+        {
+            pair.second->bindBase(gl::GL_ATOMIC_COUNTER_BUFFER, pair.first);
+        }
     }
 
     for (const auto & pair : m_shaderStorageBuffers)
     {
-        pair.second->bindBase(gl::GL_SHADER_STORAGE_BUFFER, pair.first);
+        if (!previous || previous->shaderStorageBuffer(pair.first) != pair.second)
+        {
+            pair.second->bindBase(gl::GL_SHADER_STORAGE_BUFFER, pair.first);
+        }
     }
 
     for (const auto & pair : m_transformFeedbackBuffers)
     {
-        pair.second->bindBase(gl::GL_TRANSFORM_FEEDBACK_BUFFER, pair.first);
+        if (!previous || previous->transformFeedbackBuffer(pair.first) != pair.second)
+        {
+            pair.second->bindBase(gl::GL_TRANSFORM_FEEDBACK_BUFFER, pair.first);
+        }
     }
 }
 
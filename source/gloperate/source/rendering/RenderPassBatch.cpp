@@ -0,0 +1,134 @@
+
+#include <gloperate/rendering/RenderPassBatch.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+#include <gloperate/rendering/RenderPass.h>
+
+
+namespace
+{
+
+
+using SortKey = std::tuple<std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t>;
+
+
+std::uintptr_t address(const void * object)
+{
+    return reinterpret_cast<std::uintptr_t>(object);
+}
+
+const void * firstTexture(const gloperate::RenderPass * renderPass)
+{
+    // Texture bound to the lowest of the first 32 texture units
+    for (size_t index = 0; index < 32; ++index)
+    {
+        if (const auto texture = renderPass->texture(index))
+        {
+            return texture;
+        }
+    }
+
+    return nullptr;
+}
+
+SortKey sortKey(const gloperate::RenderPass * renderPass)
+{
+    // Program changes are the most expensive, followed by states and textures
+    return SortKey(
+        address(renderPass->program())
+      , address(renderPass->programPipeline())
+      , address(renderPass->stateBefore())
+      , address(renderPass->stateAfter())
+      , address(firstTexture(renderPass))
+    );
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+RenderPassBatch::RenderPassBatch()
+: m_sorted(true)
+{
+}
+
+RenderPassBatch::~RenderPassBatch()
+{
+}
+
+void RenderPassBatch::draw() const
+{
+    if (!m_sorted)
+    {
+        sort();
+    }
+
+    for (size_t i = 0; i < m_renderPasses.size(); ++i)
+    {
+        const RenderPass * previous = i > 0                         ? m_renderPasses[i - 1] : nullptr;
+        const RenderPass * next     = i + 1 < m_renderPasses.size() ? m_renderPasses[i + 1] : nullptr;
+
+        m_renderPasses[i]->draw(previous, next);
+    }
+}
+
+const std::vector<RenderPass *> & RenderPassBatch::renderPasses() const
+{
+    return m_renderPasses;
+}
+
+void RenderPassBatch::addRenderPass(RenderPass * renderPass)
+{
+    m_renderPasses.push_back(renderPass);
+    m_sorted = false;
+}
+
+void RenderPassBatch::removeRenderPass(RenderPass * renderPass)
+{
+    m_renderPasses.erase(std::remove(m_renderPasses.begin(), m_renderPasses.end(), renderPass), m_renderPasses.end());
+}
+
+void RenderPassBatch::clear()
+{
+    m_renderPasses.clear();
+    m_sorted = true;
+}
+
+void RenderPassBatch::invalidateOrder()
+{
+    m_sorted = false;
+}
+
+void RenderPassBatch::sort() const
+{
+    // Determine keys once
+    std::vector<std::pair<SortKey, RenderPass *>> entries;
+    entries.reserve(m_renderPasses.size());
+
+    for (RenderPass * renderPass : m_renderPasses)
+    {
+        entries.emplace_back(sortKey(renderPass), renderPass);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [] (const std::pair<SortKey, RenderPass *> & a, const std::pair<SortKey, RenderPass *> & b)
+    {
+        return a.first < b.first;
+    });
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        m_renderPasses[i] = entries[i].second;
+    }
+
+    m_sorted = true;
+}
+
+
+} // namespace gloperate
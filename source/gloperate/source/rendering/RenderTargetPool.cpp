@@ -0,0 +1,684 @@
+
+#include <gloperate/rendering/RenderTargetPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <initializer_list>
+
+#include <cppassist/logging/logging.h>
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+
+#include <globjects/Texture.h>
+#include <globjects/Renderbuffer.h>
+
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/pipeline/Output.h>
+#include <gloperate/rendering/ColorRenderTarget.h>
+#include <gloperate/rendering/DepthRenderTarget.h>
+#include <gloperate/rendering/DepthStencilRenderTarget.h>
+#include <gloperate/rendering/StencilRenderTarget.h>
+
+
+using namespace gl;
+
+
+namespace
+{
+
+
+const auto endOfPlan = std::numeric_limits<size_t>::max();
+
+
+template <typename T, template <typename> class SlotType>
+const void * slotObject(const gloperate::AbstractSlot * slot)
+{
+    const auto target = static_cast<const SlotType<T *> *>(slot)->value();
+    if (!target)
+    {
+        return nullptr;
+    }
+
+    switch (target->currentTargetType())
+    {
+    case gloperate::RenderTargetType::Texture:
+        return target->textureAttachment();
+
+    case gloperate::RenderTargetType::Renderbuffer:
+        return target->renderbufferAttachment();
+
+    default:
+        return nullptr;
+    }
+}
+
+// Get texture or renderbuffer referenced by a slot
+template <template <typename> class SlotType>
+const void * renderTargetObject(const gloperate::AbstractSlot * slot)
+{
+    const auto & type = slot->type();
+
+    if (type == typeid(globjects::Texture *))
+    {
+        return static_cast<const SlotType<globjects::Texture *> *>(slot)->value();
+    }
+
+    if (type == typeid(globjects::Renderbuffer *))
+    {
+        return static_cast<const SlotType<globjects::Renderbuffer *> *>(slot)->value();
+    }
+
+    if (type == typeid(gloperate::ColorRenderTarget *))
+    {
+        return slotObject<gloperate::ColorRenderTarget, SlotType>(slot);
+    }
+
+    if (type == typeid(gloperate::DepthRenderTarget *))
+    {
+        return slotObject<gloperate::DepthRenderTarget, SlotType>(slot);
+    }
+
+    if (type == typeid(gloperate::DepthStencilRenderTarget *))
+    {
+        return slotObject<gloperate::DepthStencilRenderTarget, SlotType>(slot);
+    }
+
+    if (type == typeid(gloperate::StencilRenderTarget *))
+    {
+        return slotObject<gloperate::StencilRenderTarget, SlotType>(slot);
+    }
+
+    return nullptr;
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+bool RenderTargetPool::Description::operator==(const Description & other) const
+{
+    return renderbuffer   == other.renderbuffer
+        && internalFormat == other.internalFormat
+        && format         == other.format
+        && type           == other.type
+        && size           == other.size;
+}
+
+bool RenderTargetPool::Lifetime::operator==(const Lifetime & other) const
+{
+    return first == other.first && last == other.last;
+}
+
+
+RenderTargetPool::RenderTargetPool()
+: m_execution(0)
+, m_pooledMemory(0)
+, m_peakMemory(0)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+}
+
+globjects::Texture * RenderTargetPool::obtainTexture(Stage * owner, GLenum internalFormat, GLenum format, GLenum type, const glm::ivec2 & size)
+{
+    return obtain(owner, Description{ false, internalFormat, format, type, size })->texture.get();
+}
+
+globjects::Renderbuffer * RenderTargetPool::obtainRenderbuffer(Stage * owner, GLenum internalFormat, const glm::ivec2 & size)
+{
+    return obtain(owner, Description{ true, internalFormat, GL_NONE, GL_NONE, size })->renderbuffer.get();
+}
+
+void RenderTargetPool::release(const Stage * owner)
+{
+    m_lifetimes.erase(owner);
+    m_users.erase(owner);
+    m_uses.erase(owner);
+    m_exclusive.erase(owner);
+
+    detach(owner);
+}
+
+void RenderTargetPool::clear()
+{
+    m_renderTargets.clear();
+    m_ownerTargets.clear();
+    m_lifetimes.clear();
+    m_users.clear();
+    m_uses.clear();
+    m_exclusive.clear();
+    m_pooledMemory = 0;
+}
+
+void RenderTargetPool::updateLifetimes(const Pipeline * pipeline)
+{
+    assert(pipeline);
+
+    ++m_execution;
+
+    // Destroy render targets that have not been obtained again since the last update
+    m_renderTargets.erase(std::remove_if(m_renderTargets.begin(), m_renderTargets.end(), [this] (const std::unique_ptr<RenderTarget> & renderTarget)
+    {
+        if (!renderTarget->owners.empty())
+        {
+            return false;
+        }
+
+        m_pooledMemory -= renderTarget->memory;
+        return true;
+    }), m_renderTargets.end());
+
+    if (m_ownerTargets.empty())
+    {
+        return;
+    }
+
+    const auto & stages = pipeline->stages();
+
+    // Content of a render target belongs to the last owner before the stage that uses it
+    auto positions = std::unordered_map<const Stage *, size_t>();
+    auto lifetimes = std::unordered_map<const Stage *, Lifetime>();
+    auto users = std::unordered_map<const Stage *, std::vector<const Stage *>>();
+    auto uses = std::unordered_map<const Stage *, std::vector<Stage *>>();
+    auto renderTargets = std::unordered_map<const void *, RenderTarget *>();
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        if (m_ownerTargets.count(stages[i]) > 0)
+        {
+            positions[stages[i]] = i;
+        }
+    }
+
+    for (const auto & renderTarget : m_renderTargets)
+    {
+        renderTargets[object(*renderTarget)] = renderTarget.get();
+    }
+
+    // Extend lifetime of the stage whose content a stage uses
+    const auto use = [&positions, &lifetimes, &users, &uses, &renderTargets] (const void * object, const Stage * user, size_t position)
+    {
+        const auto it = renderTargets.find(object);
+        if (it == renderTargets.end())
+        {
+            return;
+        }
+
+        Stage * owner = nullptr;
+        Stage * lastOwner = nullptr;
+
+        for (auto candidate : it->second->owners)
+        {
+            const auto candidatePosition = positions.find(candidate);
+            if (candidatePosition == positions.end())
+            {
+                continue;
+            }
+
+            if (candidatePosition->second < position && (!owner || candidatePosition->second > positions[owner]))
+            {
+                owner = candidate;
+            }
+
+            if (!lastOwner || candidatePosition->second > positions[lastOwner])
+            {
+                lastOwner = candidate;
+            }
+        }
+
+        // Content that is used before it is written stems from the last execution,
+        // and content that leaves the pipeline is used after it. Both span the whole plan.
+        if (!owner || position == endOfPlan)
+        {
+            owner = owner ? owner : lastOwner;
+            if (owner)
+            {
+                lifetimes[owner] = Lifetime{ 0, endOfPlan };
+            }
+        }
+        else
+        {
+            // The first stage that uses the render target writes it
+            const auto lifetime = lifetimes.find(owner);
+            if (lifetime == lifetimes.end())
+            {
+                lifetimes[owner] = Lifetime{ position, position };
+            }
+            else
+            {
+                lifetime->second.first = std::min(lifetime->second.first, position);
+                lifetime->second.last  = std::max(lifetime->second.last,  position);
+            }
+        }
+
+        if (owner && user)
+        {
+            users[owner].push_back(user);
+            uses[user].push_back(owner);
+        }
+    };
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        for (auto input : stages[i]->inputs())
+        {
+            if (auto object = renderTargetObject<Input>(input))
+            {
+                use(object, stages[i], i);
+            }
+        }
+    }
+
+    // Render targets that leave the pipeline are used after its execution
+    for (auto output : pipeline->outputs())
+    {
+        if (auto object = renderTargetObject<Output>(output))
+        {
+            use(object, nullptr, endOfPlan);
+        }
+    }
+
+    // Render targets that are not used at all live at the position of their stages
+    for (const auto & position : positions)
+    {
+        if (lifetimes.count(position.first) == 0)
+        {
+            lifetimes[position.first] = Lifetime{ position.second, position.second };
+        }
+    }
+
+    if (lifetimes == m_lifetimes)
+    {
+        m_users = std::move(users);
+        m_uses  = std::move(uses);
+
+        // Stages whose content has been overwritten must render it again before it is read.
+        // They keep a separate render target from now on, so stages do not displace each other repeatedly.
+        for (const auto & renderTarget : m_renderTargets)
+        {
+            for (auto owner : renderTarget->owners)
+            {
+                if (owner == renderTarget->writer || owner->needsProcessing())
+                {
+                    continue;
+                }
+
+                // Content is rendered again before it is read, if the first user is processed
+                const auto & ownerUsers = m_users[owner];
+                if (ownerUsers.empty() || ownerUsers.front()->needsProcessing())
+                {
+                    continue;
+                }
+
+                const auto used = std::any_of(ownerUsers.begin() + 1, ownerUsers.end(), [] (const Stage * user)
+                {
+                    return user->needsProcessing();
+                });
+
+                if (used)
+                {
+                    cppassist::debug(2, "gloperate") << owner->qualifiedName() << ": content of transient render target has been overwritten";
+
+                    m_exclusive.insert(owner);
+                    owner->invalidateOutputs();
+                }
+            }
+        }
+
+        return;
+    }
+
+    cppassist::debug(1, "gloperate") << pipeline->qualifiedName() << ": lifetimes of transient render targets have changed";
+
+    m_lifetimes = std::move(lifetimes);
+    m_users     = std::move(users);
+    m_uses      = std::move(uses);
+    m_exclusive.clear();
+
+    // Let all stages obtain their render targets again, so they are shared according to the new lifetimes.
+    // Render targets are kept until the next update, so they can be reused without reallocation.
+    auto owners = std::vector<Stage *>();
+    for (const auto & renderTarget : m_renderTargets)
+    {
+        owners.insert(owners.end(), renderTarget->owners.begin(), renderTarget->owners.end());
+
+        renderTarget->owners.clear();
+        renderTarget->writer = nullptr;
+    }
+
+    m_ownerTargets.clear();
+
+    for (auto owner : owners)
+    {
+        owner->invalidateOutputs();
+    }
+}
+
+void RenderTargetPool::resetLifetimes()
+{
+    ++m_execution;
+
+    m_users.clear();
+    m_uses.clear();
+    m_exclusive.clear();
+
+    if (m_lifetimes.empty())
+    {
+        return;
+    }
+
+    m_lifetimes.clear();
+
+    for (const auto & renderTarget : m_renderTargets)
+    {
+        for (auto owner : renderTarget->owners)
+        {
+            owner->invalidateOutputs();
+        }
+    }
+}
+
+void RenderTargetPool::prepareStage(const Stage * stage)
+{
+    assert(stage);
+
+    const auto uses = m_uses.find(stage);
+    if (uses == m_uses.end())
+    {
+        return;
+    }
+
+    for (auto owner : uses->second)
+    {
+        const auto current = m_ownerTargets.find(owner);
+        if (current == m_ownerTargets.end())
+        {
+            continue;
+        }
+
+        auto renderTarget = current->second;
+
+        // The first user renders the content of the owner
+        if (m_users[owner].front() == stage)
+        {
+            renderTarget->writer    = owner;
+            renderTarget->execution = m_execution;
+            continue;
+        }
+
+        if (owner == renderTarget->writer || renderTarget->owners.size() < 2)
+        {
+            continue;
+        }
+
+        // The stage that renders the content has been skipped, so it is not rendered again in time
+        cppassist::debug(1, "gloperate") << stage->qualifiedName() << ": reads overwritten content of transient render target of " << owner->qualifiedName();
+
+        m_exclusive.insert(owner);
+        owner->invalidateOutputs();
+    }
+}
+
+size_t RenderTargetPool::numRenderTargets() const
+{
+    return m_renderTargets.size();
+}
+
+size_t RenderTargetPool::pooledMemory() const
+{
+    return m_pooledMemory;
+}
+
+size_t RenderTargetPool::peakMemory() const
+{
+    return m_peakMemory;
+}
+
+size_t RenderTargetPool::requestedMemory() const
+{
+    size_t memory = 0;
+
+    for (const auto & renderTarget : m_renderTargets)
+    {
+        memory += renderTarget->memory * renderTarget->owners.size();
+    }
+
+    return memory;
+}
+
+RenderTargetPool::RenderTarget * RenderTargetPool::obtain(Stage * owner, const Description & description)
+{
+    assert(owner);
+
+    RenderTarget * renderTarget = nullptr;
+
+    // Keep current render target, if it still fits
+    const auto current = m_ownerTargets.find(owner);
+    if (current != m_ownerTargets.end())
+    {
+        if (current->second->description == description && canShare(owner, *current->second) && canOverwrite(owner, *current->second))
+        {
+            renderTarget = current->second;
+        }
+        else
+        {
+            detach(owner);
+        }
+    }
+
+    // Share render target with stages that do not overlap and whose content is no longer needed
+    if (!renderTarget)
+    {
+        for (const auto & pooled : m_renderTargets)
+        {
+            if (pooled->description == description && canShare(owner, *pooled) && canOverwrite(owner, *pooled))
+            {
+                renderTarget = pooled.get();
+                break;
+            }
+        }
+
+        if (renderTarget)
+        {
+            renderTarget->owners.push_back(owner);
+        }
+    }
+
+    // Create new render target
+    if (!renderTarget)
+    {
+        auto created = cppassist::make_unique<RenderTarget>();
+        created->description = description;
+        created->owners.push_back(owner);
+        created->writer      = nullptr;
+        created->execution   = m_execution;
+
+        allocate(*created);
+
+        m_pooledMemory += created->memory;
+        m_peakMemory    = std::max(m_peakMemory, m_pooledMemory);
+
+        cppassist::debug(2, "gloperate") << "render target pool: " << m_renderTargets.size() + 1 << " render targets, "
+            << m_pooledMemory / 1024 << " KiB pooled, " << m_peakMemory / 1024 << " KiB peak";
+
+        renderTarget = created.get();
+        m_renderTargets.push_back(std::move(created));
+    }
+
+    m_ownerTargets[owner] = renderTarget;
+
+    renderTarget->writer    = owner;
+    renderTarget->execution = m_execution;
+
+    return renderTarget;
+}
+
+void RenderTargetPool::detach(const Stage * owner)
+{
+    const auto it = m_ownerTargets.find(owner);
+    if (it == m_ownerTargets.end())
+    {
+        return;
+    }
+
+    auto renderTarget = it->second;
+    m_ownerTargets.erase(it);
+
+    auto & owners = renderTarget->owners;
+    owners.erase(std::remove(owners.begin(), owners.end(), owner), owners.end());
+
+    if (renderTarget->writer == owner)
+    {
+        renderTarget->writer = nullptr;
+    }
+
+    // Destroy render target when it is no longer used
+    if (owners.empty())
+    {
+        m_pooledMemory -= renderTarget->memory;
+
+        m_renderTargets.erase(std::remove_if(m_renderTargets.begin(), m_renderTargets.end(), [renderTarget] (const std::unique_ptr<RenderTarget> & pooled)
+        {
+            return pooled.get() == renderTarget;
+        }), m_renderTargets.end());
+    }
+}
+
+bool RenderTargetPool::canShare(const Stage * owner, const RenderTarget & renderTarget) const
+{
+    const auto lifetime = m_lifetimes.find(owner);
+
+    for (auto other : renderTarget.owners)
+    {
+        if (other == owner)
+        {
+            continue;
+        }
+
+        // Stages that have lost needed content do not share
+        if (m_exclusive.count(owner) > 0 || m_exclusive.count(other) > 0)
+        {
+            return false;
+        }
+
+        const auto otherLifetime = m_lifetimes.find(other);
+
+        // Unknown lifetimes overlap with everything
+        if (lifetime == m_lifetimes.end() || otherLifetime == m_lifetimes.end())
+        {
+            return false;
+        }
+
+        if (lifetime->second.first <= otherLifetime->second.last && otherLifetime->second.first <= lifetime->second.last)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RenderTargetPool::canOverwrite(const Stage * owner, const RenderTarget & renderTarget) const
+{
+    const auto writer = renderTarget.writer;
+
+    if (!writer || writer == owner)
+    {
+        return true;
+    }
+
+    const auto lifetime       = m_lifetimes.find(owner);
+    const auto writerLifetime = m_lifetimes.find(writer);
+
+    if (lifetime == m_lifetimes.end() || writerLifetime == m_lifetimes.end())
+    {
+        return false;
+    }
+
+    // Content that is used in the next execution is still needed
+    if (writerLifetime->second.last == endOfPlan)
+    {
+        return false;
+    }
+
+    // Content written in the current execution is needed until the end of the lifetime of its writer
+    if (renderTarget.execution == m_execution)
+    {
+        return writerLifetime->second.last < lifetime->second.first;
+    }
+
+    return true;
+}
+
+size_t RenderTargetPool::computeMemory(const RenderTarget & renderTarget)
+{
+    GLint bits = 0;
+
+    if (renderTarget.description.renderbuffer)
+    {
+        const auto renderbuffer = renderTarget.renderbuffer.get();
+
+        for (auto parameter : { GL_RENDERBUFFER_RED_SIZE, GL_RENDERBUFFER_GREEN_SIZE, GL_RENDERBUFFER_BLUE_SIZE, GL_RENDERBUFFER_ALPHA_SIZE,
+                                GL_RENDERBUFFER_DEPTH_SIZE, GL_RENDERBUFFER_STENCIL_SIZE })
+        {
+            bits += renderbuffer->getParameter(parameter);
+        }
+    }
+    else
+    {
+        const auto texture = renderTarget.texture.get();
+
+        for (auto parameter : { GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE,
+                                GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE, GL_TEXTURE_SHARED_SIZE })
+        {
+            bits += texture->getLevelParameter(0, parameter);
+        }
+    }
+
+    const auto bytesPerPixel = static_cast<size_t>(std::max(bits, 0) + 7) / 8;
+
+    return static_cast<size_t>(std::max(renderTarget.description.size.x, 0))
+         * static_cast<size_t>(std::max(renderTarget.description.size.y, 0))
+         * bytesPerPixel;
+}
+
+
+void RenderTargetPool::allocate(RenderTarget & renderTarget)
+{
+    const auto & description = renderTarget.description;
+
+    if (description.renderbuffer)
+    {
+        renderTarget.renderbuffer = cppassist::make_unique<globjects::Renderbuffer>();
+        renderTarget.renderbuffer->storage(description.internalFormat, description.size.x, description.size.y);
+    }
+    else
+    {
+        renderTarget.texture = globjects::Texture::createDefault(GL_TEXTURE_2D);
+        renderTarget.texture->image2D(0, description.internalFormat, description.size.x, description.size.y, 0, description.format, description.type, nullptr);
+    }
+
+    renderTarget.memory = computeMemory(renderTarget);
+}
+
+const void * RenderTargetPool::object(const RenderTarget & renderTarget) const
+{
+    if (renderTarget.description.renderbuffer)
+    {
+        return renderTarget.renderbuffer.get();
+    }
+
+    return renderTarget.texture.get();
+}
+
+
+} // namespace gloperate
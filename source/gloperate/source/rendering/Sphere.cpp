@@ -1,7 +1,8 @@
 
 #include <gloperate/rendering/Sphere.h>
 
-#include <iostream>
+#include <limits>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -11,61 +12,109 @@
 
 #include <globjects/Buffer.h>
 
+#include <gloperate/rendering/Icosahedron.h>
+
+
+namespace
+{
+
+
+const int s_refinementLevel = 5; ///< Refinement level of the icosahedron
+
+
+} // namespace
+
 
 namespace gloperate
 {
 
 
-Sphere::Sphere(float radius, cppassist::Flags<ShapeOption> options)
+Sphere::Sphere(float radius, cppassist::Flags<ShapeOption> options, const AbstractGLContext * context)
 : Shape(ShapeType::Sphere, options)
 {
-    // Create icosahedron
-    m_icosahedron = cppassist::make_unique<Icosahedron>();
-    m_icosahedron->generateGeometry(5);
+    const bool texCoords = static_cast<bool>(options & ShapeOption::IncludeTexCoords);
+
+    // Obtain shared geometry
+    const GeometryCache::Key key{ context, ShapeType::Sphere, s_refinementLevel, radius, texCoords };
+
+    m_geometry = GeometryCache::obtain(key, [radius, texCoords] ()
+    {
+        auto geometry = cppassist::make_unique<GeometryCache::Geometry>();
+
+        // Create icosahedron
+        Icosahedron icosahedron;
+        icosahedron.generateGeometry(s_refinementLevel);
+
+        // Create vertex buffer
+        auto vertices = icosahedron.vertices();
+
+        for (auto & vertex : vertices)
+        {
+            vertex *= radius;
+        }
+
+        geometry->vertices = cppassist::make_unique<globjects::Buffer>();
+        geometry->vertices->setData(vertices, gl::GL_STATIC_DRAW);
+
+        // Create texture coordinate buffer
+        if (texCoords)
+        {
+            icosahedron.generateTextureCoordinates();
+
+            geometry->texCoords = cppassist::make_unique<globjects::Buffer>();
+            geometry->texCoords->setData(icosahedron.texcoords(), gl::GL_STATIC_DRAW);
+        }
+
+        // Create index buffer, use 16-bit indices if possible
+        const auto & faces = icosahedron.indices();
+
+        geometry->indices = cppassist::make_unique<globjects::Buffer>();
+        geometry->size    = static_cast<gl::GLsizei>(faces.size() * std::tuple_size<Icosahedron::Face>::value);
+
+        if (vertices.size() <= std::numeric_limits<gl::GLushort>::max() + size_t(1))
+        {
+            std::vector<gl::GLushort> indices;
+            indices.reserve(geometry->size);
+
+            for (const auto & face : faces)
+            {
+                indices.insert(indices.end(), face.begin(), face.end());
+            }
+
+            geometry->indices->setData(indices, gl::GL_STATIC_DRAW);
+            geometry->indexType = gl::GL_UNSIGNED_SHORT;
+        }
+        else
+        {
+            geometry->indices->setData(faces, gl::GL_STATIC_DRAW);
+            geometry->indexType = gl::GL_UNSIGNED_INT;
+        }
+
+        return geometry;
+    });
 
     // Create drawable
     m_drawable = cppassist::make_unique<Drawable>();
     m_drawable->setPrimitiveMode(gl::GL_TRIANGLES);
     m_drawable->setDrawMode(gloperate::DrawMode::ElementsIndexBuffer);
-    m_drawable->setSize(m_icosahedron->indices().size() * std::tuple_size<Icosahedron::Face>::value);
-
-    // Create vertex buffer
-    auto vertices = m_icosahedron->vertices();
-
-    for (auto & vertex : vertices)
-    {
-        vertex *= radius;
-    }
-
-    m_vertices = cppassist::make_unique<globjects::Buffer>();
-    m_vertices->setData(vertices, gl::GL_STATIC_DRAW);
+    m_drawable->setSize(m_geometry->size);
 
     m_drawable->bindAttribute(0, 0);
-    m_drawable->setBuffer(0, m_vertices.get());
+    m_drawable->setBuffer(0, m_geometry->vertices.get());
     m_drawable->setAttributeBindingBuffer(0, 0, 0, sizeof(glm::vec3));
     m_drawable->setAttributeBindingFormat(0, 3, gl::GL_FLOAT, gl::GL_FALSE, 0);
     m_drawable->enableAttributeBinding(0);
 
-    // Create texture coordinate buffer
-    if (options & ShapeOption::IncludeTexCoords)
+    if (texCoords)
     {
-        m_icosahedron->generateTextureCoordinates();
-
-        m_texCoords = cppassist::make_unique<globjects::Buffer>();
-        m_texCoords->setData(m_icosahedron->texcoords(), gl::GL_STATIC_DRAW);
-
         m_drawable->bindAttribute(1, 1);
-        m_drawable->setBuffer(1, m_texCoords.get());
+        m_drawable->setBuffer(1, m_geometry->texCoords.get());
         m_drawable->setAttributeBindingBuffer(1, 1, 0, sizeof(glm::vec2));
         m_drawable->setAttributeBindingFormat(1, 2, gl::GL_FLOAT, gl::GL_FALSE, 0);
         m_drawable->enableAttributeBinding(1);
     }
 
-    // Create index buffer
-    m_indices = cppassist::make_unique<globjects::Buffer>();
-    m_indices->setData(m_icosahedron->indices(), gl::GL_STATIC_DRAW);
-
-    m_drawable->setIndexBuffer(m_indices.get(), gl::GL_UNSIGNED_SHORT);
+    m_drawable->setIndexBuffer(m_geometry->indices.get(), m_geometry->indexType);
 }
 
 Sphere::~Sphere()
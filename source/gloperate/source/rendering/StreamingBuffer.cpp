@@ -0,0 +1,220 @@
+
+#include <gloperate/rendering/StreamingBuffer.h>
+
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/bitfield.h>
+#include <glbinding/gl/extension.h>
+#include <glbinding/Version.h>
+#include <glbinding-aux/ContextInfo.h>
+
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
+
+
+namespace
+{
+
+
+bool isBufferStorageSupported()
+{
+    // Immutable buffer storage is core since OpenGL 4.4
+    return glbinding::aux::ContextInfo::version() >= glbinding::Version(4, 4) ||
+           glbinding::aux::ContextInfo::extensions().count(gl::GLextension::GL_ARB_buffer_storage) > 0;
+}
+
+
+} // namespace
+
+
+namespace gloperate
+{
+
+
+StreamingBuffer::StreamingBuffer(size_t capacity)
+: m_capacity(0)
+, m_persistent(false)
+, m_data(nullptr)
+, m_position(0)
+, m_fenced(0)
+, m_dirtyBegin(0)
+, m_dirtyEnd(0)
+{
+    resize(capacity);
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (m_data)
+    {
+        m_buffer->unmap();
+    }
+}
+
+size_t StreamingBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+void StreamingBuffer::resize(size_t capacity)
+{
+    // Release old buffer, OpenGL keeps its storage until pending commands have finished
+    if (m_data)
+    {
+        m_buffer->unmap();
+    }
+
+    m_buffer     = cppassist::make_unique<globjects::Buffer>();
+    m_capacity   = std::max(capacity, size_t(1));
+    m_data       = nullptr;
+    m_position   = 0;
+    m_fenced     = 0;
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = 0;
+    m_segments.clear();
+    m_staging.clear();
+
+    const auto bufferStorage = isBufferStorageSupported();
+
+    if (bufferStorage)
+    {
+        const auto flags = gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT;
+
+        m_buffer->setStorage(m_capacity, nullptr, flags);
+        m_data = static_cast<char *>(m_buffer->mapRange(0, m_capacity, flags));
+    }
+
+    m_persistent = (m_data != nullptr);
+
+    if (!m_persistent)
+    {
+        // Immutable storage cannot be redefined
+        if (bufferStorage)
+        {
+            m_buffer = cppassist::make_unique<globjects::Buffer>();
+        }
+
+        m_buffer->setData(m_capacity, nullptr, gl::GL_STREAM_DRAW);
+        m_staging.resize(m_capacity);
+    }
+}
+
+bool StreamingBuffer::isPersistent() const
+{
+    return m_persistent;
+}
+
+globjects::Buffer * StreamingBuffer::buffer() const
+{
+    return m_buffer.get();
+}
+
+void * StreamingBuffer::allocate(size_t size, size_t alignment, size_t & offset)
+{
+    if (size > m_capacity)
+    {
+        return nullptr;
+    }
+
+    // Align start of the range, wrap around if it does not fit at the end of the buffer
+    auto begin = m_position;
+    const auto current = static_cast<size_t>(begin % m_capacity);
+    const auto aligned = (current + alignment - 1) / alignment * alignment;
+
+    if (aligned + size > m_capacity)
+    {
+        begin += m_capacity - current;
+    }
+    else
+    {
+        begin += aligned - current;
+    }
+
+    const auto end = begin + size;
+
+    // The range overlaps the positions [begin - capacity, end - capacity) written previously
+    if (m_position > m_fenced && end > m_capacity + m_fenced)
+    {
+        // Ranges allocated since the last fence would be overwritten
+        return nullptr;
+    }
+
+    while (!m_segments.empty() && m_segments.front().begin + m_capacity < end)
+    {
+        wait(m_segments.front());
+        m_segments.pop_front();
+    }
+
+    m_position = end;
+    offset     = static_cast<size_t>(begin % m_capacity);
+
+    if (m_persistent)
+    {
+        return m_data + offset;
+    }
+
+    // Remember range of the staging copy that has to be uploaded
+    if (m_dirtyEnd > m_dirtyBegin)
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, offset);
+        m_dirtyEnd   = std::max(m_dirtyEnd, offset + size);
+    }
+    else
+    {
+        m_dirtyBegin = offset;
+        m_dirtyEnd   = offset + size;
+    }
+
+    return m_staging.data() + offset;
+}
+
+void StreamingBuffer::flush()
+{
+    // Coherent mappings are visible to commands issued after the writes
+    if (m_persistent || m_dirtyEnd <= m_dirtyBegin)
+    {
+        return;
+    }
+
+    m_buffer->setSubData(m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, m_staging.data() + m_dirtyBegin);
+
+    m_dirtyBegin = 0;
+    m_dirtyEnd   = 0;
+}
+
+void StreamingBuffer::fence()
+{
+    if (m_position == m_fenced)
+    {
+        return;
+    }
+
+    // Uploads of the staging copy are synchronized by OpenGL
+    if (m_persistent)
+    {
+        m_segments.push_back(Segment{ m_fenced, globjects::Sync::fence(gl::GL_SYNC_GPU_COMMANDS_COMPLETE) });
+    }
+
+    m_fenced = m_position;
+}
+
+void StreamingBuffer::wait(const Segment & segment)
+{
+    if (!segment.sync)
+    {
+        return;
+    }
+
+    auto result = segment.sync->clientWait(gl::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+    while (result == gl::GL_TIMEOUT_EXPIRED)
+    {
+        result = segment.sync->clientWait(gl::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+}
+
+
+} // namespace gloperate
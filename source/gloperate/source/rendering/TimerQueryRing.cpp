@@ -0,0 +1,135 @@
+
+#include <gloperate/rendering/TimerQueryRing.h>
+
+#include <algorithm>
+
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
+
+
+namespace gloperate
+{
+
+
+TimerQueryRing::TimerQueryRing(size_t size)
+: m_slots(std::max(size, size_t(1)))
+, m_first(0)
+, m_pending(0)
+, m_active(false)
+, m_dropped(0)
+{
+    std::vector<gl::GLuint> queries(2 * m_slots.size());
+    gl::glGenQueries(static_cast<gl::GLsizei>(queries.size()), queries.data());
+
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        m_slots[i] = Slot{ queries[2 * i], queries[2 * i + 1], 0, false };
+    }
+}
+
+TimerQueryRing::~TimerQueryRing()
+{
+    for (const auto & slot : m_slots)
+    {
+        gl::glDeleteQueries(1, &slot.startQuery);
+        gl::glDeleteQueries(1, &slot.endQuery);
+    }
+}
+
+size_t TimerQueryRing::size() const
+{
+    return m_slots.size();
+}
+
+size_t TimerQueryRing::pending() const
+{
+    return m_pending;
+}
+
+size_t TimerQueryRing::dropped() const
+{
+    return m_dropped;
+}
+
+bool TimerQueryRing::begin()
+{
+    if (m_active)
+    {
+        return true;
+    }
+
+    if (m_pending == m_slots.size())
+    {
+        ++m_dropped;
+        return false;
+    }
+
+    const auto & slot = m_slots[(m_first + m_pending) % m_slots.size()];
+    gl::glQueryCounter(slot.startQuery, gl::GL_TIMESTAMP);
+
+    m_active = true;
+    return true;
+}
+
+void TimerQueryRing::end(std::uint64_t value)
+{
+    if (!m_active)
+    {
+        return;
+    }
+
+    auto & slot = m_slots[(m_first + m_pending) % m_slots.size()];
+    gl::glQueryCounter(slot.endQuery, gl::GL_TIMESTAMP);
+
+    slot.value     = value;
+    slot.discarded = false;
+
+    ++m_pending;
+    m_active = false;
+}
+
+size_t TimerQueryRing::poll(const Callback & callback)
+{
+    size_t count = 0;
+
+    while (m_pending > 0)
+    {
+        const auto & slot = m_slots[m_first];
+
+        // Queries complete in order, so the start query is available as well
+        gl::GLuint available = 0;
+        gl::glGetQueryObjectuiv(slot.endQuery, gl::GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available == 0)
+        {
+            break;
+        }
+
+        if (!slot.discarded)
+        {
+            gl::GLuint64 start = 0;
+            gl::GLuint64 end   = 0;
+            gl::glGetQueryObjectui64v(slot.startQuery, gl::GL_QUERY_RESULT, &start);
+            gl::glGetQueryObjectui64v(slot.endQuery, gl::GL_QUERY_RESULT, &end);
+
+            callback(slot.value, start, end);
+            ++count;
+        }
+
+        m_first = (m_first + 1) % m_slots.size();
+        --m_pending;
+    }
+
+    return count;
+}
+
+void TimerQueryRing::discard()
+{
+    for (size_t i = 0; i < m_pending; ++i)
+    {
+        m_slots[(m_first + i) % m_slots.size()].discarded = true;
+    }
+}
+
+
+} // namespace gloperate
@@ -129,7 +129,7 @@ public:
     {
         assert(isComplete());
 
-        clearBuffer(fbo, (**m_renderTargetInput)->attachmentGLType(), (**m_renderTargetInput)->clearBufferDrawBuffer(drawBuffer), m_clearValueInput->value());
+        clearBuffer(fbo, (**m_renderTargetInput)->attachmentGLType(), (**m_renderTargetInput)->clearBufferDrawBuffer(drawBuffer), m_clearValueInput->valueRef());
     }
 
     virtual bool isComplete() const override
@@ -20,6 +20,8 @@ ColorGradientSelectionStage::ColorGradientSelectionStage(gloperate::Environment
 , gradient("gradient", this)
 , index("index", this)
 {
+    // Stage does not use OpenGL
+    setContextFree(true);
 }
 
 ColorGradientSelectionStage::~ColorGradientSelectionStage()
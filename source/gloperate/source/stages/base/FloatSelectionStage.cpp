@@ -16,6 +16,9 @@ FloatSelectionStage::FloatSelectionStage(gloperate::Environment * environment, c
 , index("index", this, 0)
 , value("value", this, 0.0f)
 {
+    // Stage does not use OpenGL
+    setContextFree(true);
+
     inputAdded.connect([this](AbstractSlot * slot) {
         auto floatInput = dynamic_cast<Input<float> *>(slot);
 
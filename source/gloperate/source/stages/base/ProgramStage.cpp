@@ -1,13 +1,20 @@
 
 #include <gloperate/stages/base/ProgramStage.h>
 
+#include <algorithm>
+
 #include <cppassist/fs/FilePath.h>
 
+#include <glbinding/gl/enum.h>
+#include <glbinding/gl/boolean.h>
+
 #include <globjects/Shader.h>
 #include <globjects/Program.h>
+#include <globjects/ProgramBinary.h>
 
 #include <gloperate/base/Environment.h>
 #include <gloperate/base/ResourceManager.h>
+#include <gloperate/rendering/ProgramBinaryCache.h>
 
 #include <gloperate/gloperate.h>
 
@@ -47,35 +54,100 @@ void ProgramStage::onContextInit(AbstractGLContext *)
 void ProgramStage::onContextDeinit(AbstractGLContext *)
 {
     // Clean up OpenGL objects
-    m_shaders.clear();
     m_program = nullptr;
+    m_binary  = nullptr;
+    m_shaders.clear();
 }
 
 void ProgramStage::onProcess()
 {
+    std::vector<globjects::Shader *> shaders;
+
+    // Collect all shaders from inputs of type Shader
+    for (auto input : inputs<globjects::Shader *>())
+    {
+        if (input && input->value())
+        {
+            shaders.push_back(input->value());
+        }
+    }
+
+    // Load all shaders from inputs of type FilePath
+    std::vector<std::unique_ptr<globjects::Shader>> loadedShaders;
+
+    for (auto input : inputs<cppassist::FilePath>())
+    {
+        auto shader = std::unique_ptr<globjects::Shader>(environment()->resourceManager()->load<globjects::Shader>((*input)->path()));
+
+        if (!shader)
+        {
+            continue;
+        }
+
+        // Keep previously loaded shader if its source has not changed, so it is not compiled again
+        auto it = std::find_if(m_shaders.begin(), m_shaders.end(), [&shader] (const std::unique_ptr<globjects::Shader> & loadedShader)
+        {
+            return loadedShader && loadedShader->type() == shader->type() && loadedShader->source() == shader->source();
+        });
+
+        if (it != m_shaders.end())
+        {
+            shader = std::move(*it);
+        }
+
+        shaders.push_back(shader.get());
+        loadedShaders.push_back(std::move(shader));
+    }
+
     // Detach all shaders from program
     for (auto shader : m_program->shaders())
     {
         m_program->detach(shader);
     }
 
-    // Attach all shaders from inputs of type Shader
-    for (auto input : inputs<globjects::Shader *>())
+    m_program->setBinary(nullptr);
+    m_binary = nullptr;
+
+    // Release shaders that are no longer used
+    m_shaders = std::move(loadedShaders);
+
+    // Try to restore program from a cached binary
+    auto binaryCache = environment()->programBinaryCache();
+
+    m_binary = binaryCache->load(shaders);
+
+    if (m_binary)
     {
-        if (input)
+        m_program->setBinary(m_binary.get());
+        m_program->link();
+
+        // The driver may reject binaries, e.g., after an update
+        if (!m_program->isLinked())
         {
-            m_program->attach(input->value());
+            m_program->setBinary(nullptr);
+            m_binary = nullptr;
         }
     }
 
-    // Load and attach all shaders from inputs of type FilePath
-    for (auto input : inputs<cppassist::FilePath>())
+    // Compile and link shaders
+    if (!m_binary)
     {
-        if (auto shader = environment()->resourceManager()->load<globjects::Shader>((*input)->path()))
+        for (auto shader : shaders)
         {
-            m_shaders.emplace_back(shader);
             m_program->attach(shader);
         }
+
+        if (!shaders.empty())
+        {
+            if (ProgramBinaryCache::isSupported())
+            {
+                m_program->setParameter(gl::GL_PROGRAM_BINARY_RETRIEVABLE_HINT, gl::GL_TRUE);
+            }
+
+            m_program->link();
+
+            binaryCache->store(shaders, m_program.get());
+        }
     }
 
     // Update output
@@ -8,9 +8,11 @@
 
 #include <globjects/Renderbuffer.h>
 
+#include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/RenderTargetPool.h>
 
 
 using namespace gl;
@@ -28,6 +30,7 @@ RenderbufferRenderTargetStage::RenderbufferRenderTargetStage(gloperate::Environm
 : Stage(environment, "RenderbufferRenderTargetStage", name)
 , internalFormat("internalFormat", this)
 , size("size", this)
+, transient("transient", this, false)
 , renderbuffer("renderbuffer", this)
 , colorRenderTarget("colorRenderTarget", this)
 , depthRenderTarget("depthRenderTarget", this)
@@ -52,6 +55,12 @@ void RenderbufferRenderTargetStage::onContextInit(gloperate::AbstractGLContext *
 
 void RenderbufferRenderTargetStage::onContextDeinit(AbstractGLContext *)
 {
+    // Return transient renderbuffer to the pool
+    if (parentPipeline())
+    {
+        parentPipeline()->renderTargetPool()->release(this);
+    }
+
     // Clean up OpenGL objects
     m_renderbuffer        = nullptr;
     m_colorRenderTarget   = nullptr;
@@ -61,16 +70,38 @@ void RenderbufferRenderTargetStage::onContextDeinit(AbstractGLContext *)
 
 void RenderbufferRenderTargetStage::onProcess()
 {
-    // Check if texture has been created successfully
-    if (!m_renderbuffer.get())
+    // Check if render targets have been created successfully
+    if (!m_colorRenderTarget.get())
     {
         return;
     }
 
-    // Create texture image
     const auto width  = (*size)[2];
     const auto height = (*size)[3];
-    m_renderbuffer->storage(*internalFormat, width, height);
+    Renderbuffer * targetRenderbuffer = nullptr;
+
+    if (*transient && parentPipeline())
+    {
+        // Obtain shared renderbuffer storage, the own renderbuffer is not needed
+        targetRenderbuffer = parentPipeline()->renderTargetPool()->obtainRenderbuffer(this, *internalFormat, glm::ivec2(width, height));
+        m_renderbuffer = nullptr;
+    }
+    else
+    {
+        if (parentPipeline())
+        {
+            parentPipeline()->renderTargetPool()->release(this);
+        }
+
+        if (!m_renderbuffer.get())
+        {
+            m_renderbuffer = cppassist::make_unique<Renderbuffer>();
+        }
+
+        // Create renderbuffer storage
+        targetRenderbuffer = m_renderbuffer.get();
+        targetRenderbuffer->storage(*internalFormat, width, height);
+    }
 
     switch(*internalFormat)
     {
@@ -81,26 +112,26 @@ void RenderbufferRenderTargetStage::onProcess()
         m_colorRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_renderbuffer.get());
+        m_depthRenderTarget->setTarget(targetRenderbuffer);
         break;
     case GL_DEPTH_STENCIL:
     case GL_DEPTH24_STENCIL8:
     case GL_DEPTH32F_STENCIL8:
         m_colorRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_renderbuffer.get());
-        m_stencilRenderTarget->setTarget(m_renderbuffer.get());
+        m_depthRenderTarget->setTarget(targetRenderbuffer);
+        m_stencilRenderTarget->setTarget(targetRenderbuffer);
         break;
     default: // Color attachment
         m_depthRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_colorRenderTarget->setTarget(m_renderbuffer.get());
+        m_colorRenderTarget->setTarget(targetRenderbuffer);
         break;
     }
 
     // Update outputs
-    renderbuffer.setValue(m_renderbuffer.get());
+    renderbuffer.setValue(targetRenderbuffer);
     colorRenderTarget.setValue(m_colorRenderTarget.get());
     depthRenderTarget.setValue(m_depthRenderTarget.get());
     stencilRenderTarget.setValue(m_stencilRenderTarget.get());
@@ -40,7 +40,13 @@ void ShaderStage::onContextDeinit(AbstractGLContext *)
 void ShaderStage::onProcess()
 {
     // Load shader
-    m_shader = std::unique_ptr<globjects::Shader>(environment()->resourceManager()->load<globjects::Shader>((*filePath).path()));
+    auto newShader = std::unique_ptr<globjects::Shader>(environment()->resourceManager()->load<globjects::Shader>((*filePath).path()));
+
+    // Keep the current shader if the source has not changed, so it is not compiled again
+    if (!newShader || !m_shader || newShader->type() != m_shader->type() || newShader->source() != m_shader->source())
+    {
+        m_shader = std::move(newShader);
+    }
 
     // Update outputs
     shader.setValue(m_shader.get());
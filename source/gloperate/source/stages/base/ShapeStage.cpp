@@ -31,6 +31,7 @@ ShapeStage::ShapeStage(gloperate::Environment * environment, const std::string &
 , radius("radius", this, 1.0f)
 , texCoords("texCoords", this, true)
 , drawable("drawable", this)
+, m_context(nullptr)
 {
 }
 
@@ -38,14 +39,16 @@ ShapeStage::~ShapeStage()
 {
 }
 
-void ShapeStage::onContextInit(gloperate::AbstractGLContext *)
+void ShapeStage::onContextInit(gloperate::AbstractGLContext * context)
 {
+    m_context = context;
 }
 
 void ShapeStage::onContextDeinit(AbstractGLContext *)
 {
     // Clean up OpenGL objects
     m_shape = nullptr;
+    m_context = nullptr;
 }
 
 void ShapeStage::onProcess()
@@ -75,7 +78,7 @@ void ShapeStage::onProcess()
             break;
 
         case ShapeType::Sphere:
-            m_shape = cppassist::make_unique<Sphere>(*this->radius, options);
+            m_shape = cppassist::make_unique<Sphere>(*this->radius, options, m_context);
             break;
 
         default:
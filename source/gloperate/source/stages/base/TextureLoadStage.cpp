@@ -16,6 +16,7 @@ CPPEXPOSE_COMPONENT(TextureLoadStage, gloperate::Stage)
 TextureLoadStage::TextureLoadStage(Environment * environment, const std::string & name)
 : Stage(environment, "TextureLoadStage", name)
 , filename("filename", this)
+, asynchronous("asynchronous", this, false)
 , texture ("texture", this)
 {
 }
@@ -32,13 +33,55 @@ void TextureLoadStage::onContextDeinit(AbstractGLContext *)
 {
     // Clean up OpenGL objects
     m_texture = nullptr;
+    m_request = ResourceRequest<globjects::Texture>();
+    setAlwaysProcessed(false);
 }
 
 void TextureLoadStage::onProcess()
 {
+    const auto & path = (*filename).path();
+
     // Load texture
-    auto tex = m_environment->resourceManager()->load<globjects::Texture>((*filename).path());
-    m_texture = tex ? std::unique_ptr<globjects::Texture>(tex) : globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+    if (!*asynchronous)
+    {
+        m_request = ResourceRequest<globjects::Texture>();
+        setAlwaysProcessed(false);
+
+        auto tex = m_environment->resourceManager()->load<globjects::Texture>(path);
+        m_texture = tex ? std::unique_ptr<globjects::Texture>(tex) : globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+
+        // Update outputs
+        texture.setValue(m_texture.get());
+
+        return;
+    }
+
+    // Start loading texture in the background
+    if (!m_request.valid() || path != m_requestedPath)
+    {
+        m_request       = m_environment->resourceManager()->loadAsync<globjects::Texture>(path);
+        m_requestedPath = path;
+
+        if (!m_texture)
+        {
+            m_texture = globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+        }
+
+        texture.setValue(m_texture.get());
+
+        setAlwaysProcessed(m_request.valid());
+    }
+
+    // Check if the texture has been decoded
+    if (!m_request.isReady())
+    {
+        return;
+    }
+
+    // Upload texture
+    auto tex = m_request.get();
+    m_texture = tex ? std::move(tex) : globjects::Texture::createDefault(gl::GL_TEXTURE_2D);
+    setAlwaysProcessed(false);
 
     // Update outputs
     texture.setValue(m_texture.get());
@@ -8,9 +8,11 @@
 
 #include <globjects/Texture.h>
 
+#include <gloperate/pipeline/Pipeline.h>
 #include <gloperate/rendering/ColorRenderTarget.h>
 #include <gloperate/rendering/DepthRenderTarget.h>
 #include <gloperate/rendering/StencilRenderTarget.h>
+#include <gloperate/rendering/RenderTargetPool.h>
 
 
 using namespace gl;
@@ -30,6 +32,7 @@ TextureRenderTargetStage::TextureRenderTargetStage(gloperate::Environment * envi
 , format("format", this)
 , type("type", this)
 , size("size", this)
+, transient("transient", this, false)
 , texture("texture", this)
 , colorRenderTarget("colorRenderTarget", this)
 , depthRenderTarget("depthRenderTarget", this)
@@ -54,6 +57,12 @@ void TextureRenderTargetStage::onContextInit(gloperate::AbstractGLContext *)
 
 void TextureRenderTargetStage::onContextDeinit(AbstractGLContext *)
 {
+    // Return transient texture to the pool
+    if (parentPipeline())
+    {
+        parentPipeline()->renderTargetPool()->release(this);
+    }
+
     // Clean up OpenGL objects
     m_texture             = nullptr;
     m_colorRenderTarget   = nullptr;
@@ -63,16 +72,38 @@ void TextureRenderTargetStage::onContextDeinit(AbstractGLContext *)
 
 void TextureRenderTargetStage::onProcess()
 {
-    // Check if texture has been created successfully
-    if (!m_texture.get())
+    // Check if render targets have been created successfully
+    if (!m_colorRenderTarget.get())
     {
         return;
     }
 
-    // Create texture image
     const auto width  = (*size)[2];
     const auto height = (*size)[3];
-    m_texture->image2D(0, *internalFormat, width, height, 0, *format, *type, nullptr);
+    Texture * targetTexture = nullptr;
+
+    if (*transient && parentPipeline())
+    {
+        // Obtain shared texture image, the own texture is not needed
+        targetTexture = parentPipeline()->renderTargetPool()->obtainTexture(this, *internalFormat, *format, *type, glm::ivec2(width, height));
+        m_texture = nullptr;
+    }
+    else
+    {
+        if (parentPipeline())
+        {
+            parentPipeline()->renderTargetPool()->release(this);
+        }
+
+        if (!m_texture.get())
+        {
+            m_texture = Texture::createDefault(GL_TEXTURE_2D);
+        }
+
+        // Create texture image
+        targetTexture = m_texture.get();
+        targetTexture->image2D(0, *internalFormat, width, height, 0, *format, *type, nullptr);
+    }
 
     switch(*internalFormat)
     {
@@ -83,26 +114,26 @@ void TextureRenderTargetStage::onProcess()
         m_colorRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_texture.get());
+        m_depthRenderTarget->setTarget(targetTexture);
         break;
     case GL_DEPTH_STENCIL:
     case GL_DEPTH24_STENCIL8:
     case GL_DEPTH32F_STENCIL8:
         m_colorRenderTarget->releaseTarget();
 
-        m_depthRenderTarget->setTarget(m_texture.get());
-        m_stencilRenderTarget->setTarget(m_texture.get());
+        m_depthRenderTarget->setTarget(targetTexture);
+        m_stencilRenderTarget->setTarget(targetTexture);
         break;
     default: // Color attachment
         m_depthRenderTarget->releaseTarget();
         m_stencilRenderTarget->releaseTarget();
 
-        m_colorRenderTarget->setTarget(m_texture.get());
+        m_colorRenderTarget->setTarget(targetTexture);
         break;
     }
 
     // Update outputs
-    texture.setValue(m_texture.get());
+    texture.setValue(targetTexture);
     colorRenderTarget.setValue(m_colorRenderTarget.get());
     depthRenderTarget.setValue(m_depthRenderTarget.get());
     stencilRenderTarget.setValue(m_stencilRenderTarget.get());
@@ -20,6 +20,8 @@ TransformStage::TransformStage(gloperate::Environment * environment, const std::
 , scale("scale", this, glm::vec3(1.0f, 1.0f, 1.0f))
 , modelMatrix("modelMatrix", this)
 {
+    // Stage does not use OpenGL
+    setContextFree(true);
 }
 
 TransformStage::~TransformStage()
@@ -17,6 +17,8 @@ ViewportScaleStage::ViewportScaleStage(Environment * environment, const std::str
 , scaleFactor   ("scaleFactor",     this)
 , scaledViewport("scaledViewport", this)
 {
+    // Stage does not use OpenGL
+    setContextFree(true);
 }
 
 ViewportScaleStage::~ViewportScaleStage()
@@ -26,8 +28,8 @@ ViewportScaleStage::~ViewportScaleStage()
 void ViewportScaleStage::onProcess()
 {
 
-    const auto & viewport = this->viewport.value();
-    const auto scaleFactor = this->scaleFactor.value();
+    const auto & viewport = this->viewport.valueRef();
+    const auto scaleFactor = this->scaleFactor.valueRef();
 
     this->scaledViewport.setValue(glm::vec4(
         viewport.x,
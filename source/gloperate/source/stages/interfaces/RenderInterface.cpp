@@ -2,6 +2,9 @@
 #include <gloperate/stages/interfaces/RenderInterface.h>
 
 #include <cmath>
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
 
 #include <glbinding/gl/enum.h>
 
@@ -17,12 +20,54 @@
 #include <gloperate/rendering/StencilRenderTarget.h>
 
 
+namespace
+{
+
+
+// Maximum number of cached framebuffer configurations per interface
+const size_t maxFBOConfigurations = 16;
+
+
+gl::GLenum attachmentPoint(size_t index, const gloperate::AbstractRenderTarget * renderTarget)
+{
+    switch (renderTarget->underlyingAttachmentType())
+    {
+    case gloperate::AttachmentType::Depth:
+        return gl::GL_DEPTH_ATTACHMENT;
+
+    case gloperate::AttachmentType::Stencil:
+        return gl::GL_STENCIL_ATTACHMENT;
+
+    case gloperate::AttachmentType::DepthStencil:
+        return gl::GL_DEPTH_STENCIL_ATTACHMENT;
+
+    default:
+        return gl::GL_COLOR_ATTACHMENT0 + index;
+    }
+}
+
+
+} // namespace
+
+
 namespace gloperate
 {
 
 
+bool RenderInterface::AttachmentKey::operator==(const AttachmentKey & other) const
+{
+    return type       == other.type
+        && generation == other.generation
+        && attachment == other.attachment
+        && drawBuffer == other.drawBuffer;
+}
+
+
 RenderInterface::RenderInterface(Stage * stage)
 : viewport("viewport", stage, glm::vec4(0.0, 0.0, -1.0, -1.0))
+, m_fboUseCounter(0)
+, m_fboCacheHits(0)
+, m_fboCacheMisses(0)
 {
     // Hide inputs in property editor
     viewport.setOption("hidden", true);
@@ -438,53 +483,129 @@ globjects::Framebuffer * RenderInterface::obtainFBO() const
 {
     assert(allRenderTargetsCompatible());
 
-    std::vector<gl::GLenum> drawBuffers;
-    globjects::Framebuffer * currentFBO = nullptr;
-    auto colorAttachmentIndex = size_t(0);
-    for (auto input : m_colorRenderTargetInputs)
-    {
-        auto nextFBO = obtainFBO(colorAttachmentIndex, **input);
+    ++m_fboUseCounter;
 
-        if (!currentFBO)
-        {
-            currentFBO = nextFBO;
-        }
+    // Look up configuration for the current render targets
+    collectAttachments(m_attachments);
 
-        if (nextFBO != currentFBO)
+    FBOConfiguration * configuration = nullptr;
+    for (const auto & cached : m_fboConfigurations)
+    {
+        if (cached->attachments == m_attachments)
         {
-            return nullptr;
+            configuration = cached.get();
+            break;
         }
+    }
 
-        if (**input)
-        {
-            drawBuffers.push_back((**input)->drawBufferAttachment(colorAttachmentIndex));
-        }
-        else
+    if (configuration)
+    {
+        ++m_fboCacheHits;
+    }
+    else
+    {
+        ++m_fboCacheMisses;
+
+        // Replace least recently used configuration
+        if (m_fboConfigurations.size() >= maxFBOConfigurations)
         {
-            drawBuffers.push_back(gl::GL_NONE);
+            const auto leastRecentlyUsed = std::min_element(m_fboConfigurations.begin(), m_fboConfigurations.end(),
+                [] (const std::unique_ptr<FBOConfiguration> & a, const std::unique_ptr<FBOConfiguration> & b)
+            {
+                return a->lastUse < b->lastUse;
+            });
+
+            m_fboConfigurations.erase(leastRecentlyUsed);
         }
 
-        ++colorAttachmentIndex;
+        m_fboConfigurations.push_back(createConfiguration());
+        configuration = m_fboConfigurations.back().get();
     }
 
-    for (auto input : m_depthRenderTargetInputs)
+    configuration->lastUse = m_fboUseCounter;
+
+    // The draw buffers of the default framebuffer may have been changed by other stages
+    if (configuration->result && !configuration->fbo)
     {
-        auto nextFBO = obtainFBO(0, **input);
+        configuration->result->setDrawBuffers(configuration->drawBuffers);
+    }
 
-        if (!currentFBO)
-        {
-            currentFBO = nextFBO;
-        }
+    return configuration->result;
+}
 
-        if (nextFBO != currentFBO)
+size_t RenderInterface::fboCacheHits() const
+{
+    return m_fboCacheHits;
+}
+
+size_t RenderInterface::fboCacheMisses() const
+{
+    return m_fboCacheMisses;
+}
+
+void RenderInterface::collectAttachments(std::vector<AttachmentKey> & attachments) const
+{
+    attachments.clear();
+
+    const auto collect = [&attachments] (const AbstractRenderTarget * renderTarget, size_t index, bool color)
+    {
+        auto attachment = AttachmentKey{ RenderTargetType::Invalid, 0, gl::GL_NONE, gl::GL_NONE };
+
+        // Targets are identified by their generation, as the addresses of destroyed objects can be reused
+        if (renderTarget)
         {
-            return nullptr;
+            attachment.type       = renderTarget->currentTargetType();
+            attachment.generation = renderTarget->generation();
+            attachment.attachment = attachmentPoint(index, renderTarget);
+            attachment.drawBuffer = color ? renderTarget->drawBufferAttachment(index) : gl::GL_NONE;
+
+            if (attachment.type == RenderTargetType::DefaultFBOAttachment)
+            {
+                attachment.attachment = renderTarget->defaultFramebufferAttachment();
+            }
         }
+
+        attachments.push_back(attachment);
+    };
+
+    auto colorAttachmentIndex = size_t(0);
+    for (auto input : m_colorRenderTargetInputs)
+    {
+        collect(**input, colorAttachmentIndex++, true);
+    }
+
+    for (auto input : m_depthRenderTargetInputs)
+    {
+        collect(**input, 0, false);
     }
 
     for (auto input : m_depthStencilRenderTargetInputs)
     {
-        auto nextFBO = obtainFBO(0, **input);
+        collect(**input, 0, false);
+    }
+
+    for (auto input : m_stencilRenderTargetInputs)
+    {
+        collect(**input, 0, false);
+    }
+}
+
+std::unique_ptr<RenderInterface::FBOConfiguration> RenderInterface::createConfiguration() const
+{
+    auto configuration = cppassist::make_unique<FBOConfiguration>();
+    configuration->attachments = m_attachments;
+    configuration->fbo         = cppassist::make_unique<globjects::Framebuffer>();
+    configuration->result      = nullptr;
+    configuration->lastUse     = 0;
+
+    // Attach all render targets to the framebuffer of the configuration
+    const auto fbo = configuration->fbo.get();
+    globjects::Framebuffer * currentFBO = nullptr;
+    auto compatible = true;
+
+    const auto attach = [&] (size_t index, AbstractRenderTarget * renderTarget)
+    {
+        auto nextFBO = obtainFBO(index, renderTarget, fbo, m_defaultFBO.get());
 
         if (!currentFBO)
         {
@@ -493,54 +614,69 @@ globjects::Framebuffer * RenderInterface::obtainFBO() const
 
         if (nextFBO != currentFBO)
         {
-            return nullptr;
+            compatible = false;
         }
-    }
+    };
 
-    for (auto input : m_stencilRenderTargetInputs)
+    auto colorAttachmentIndex = size_t(0);
+    for (auto input : m_colorRenderTargetInputs)
     {
-        auto nextFBO = obtainFBO(0, **input);
+        attach(colorAttachmentIndex, **input);
 
-        if (!currentFBO)
+        if (**input)
         {
-            currentFBO = nextFBO;
+            configuration->drawBuffers.push_back((**input)->drawBufferAttachment(colorAttachmentIndex));
         }
-
-        if (nextFBO != currentFBO)
+        else
         {
-            return nullptr;
+            configuration->drawBuffers.push_back(gl::GL_NONE);
         }
-    }
 
-    currentFBO->setDrawBuffers(drawBuffers);
-
-    return currentFBO;
-}
+        ++colorAttachmentIndex;
+    }
 
-globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget) const
-{
-    return obtainFBO(index, renderTarget, m_fbo.get(), m_defaultFBO.get());
-}
+    for (auto input : m_depthRenderTargetInputs)
+    {
+        attach(0, **input);
+    }
 
-globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO)
-{
-    auto attachmentIndex = gl::GL_COLOR_ATTACHMENT0 + index;
+    for (auto input : m_depthStencilRenderTargetInputs)
+    {
+        attach(0, **input);
+    }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::Depth)
+    for (auto input : m_stencilRenderTargetInputs)
     {
-        attachmentIndex = gl::GL_DEPTH_ATTACHMENT;
+        attach(0, **input);
     }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::Stencil)
+    if (compatible && currentFBO)
     {
-        attachmentIndex = gl::GL_STENCIL_ATTACHMENT;
+        configuration->result = currentFBO;
     }
 
-    if (renderTarget->underlyingAttachmentType() == AttachmentType::DepthStencil)
+    // Only keep the framebuffer if it is actually used
+    if (configuration->result == fbo)
+    {
+        fbo->setDrawBuffers(configuration->drawBuffers);
+    }
+    else
     {
-        attachmentIndex = gl::GL_DEPTH_STENCIL_ATTACHMENT;
+        configuration->fbo = nullptr;
     }
 
+    return configuration;
+}
+
+globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget) const
+{
+    return obtainFBO(index, renderTarget, m_fbo.get(), m_defaultFBO.get());
+}
+
+globjects::Framebuffer * RenderInterface::obtainFBO(size_t index, AbstractRenderTarget * renderTarget, globjects::Framebuffer * fbo, globjects::Framebuffer * defaultFBO)
+{
+    const auto attachmentIndex = attachmentPoint(index, renderTarget);
+
     switch (renderTarget->currentTargetType())
     {
     case RenderTargetType::DefaultFBOAttachment:
@@ -621,6 +757,7 @@ void RenderInterface::onContextInit()
 
 void RenderInterface::onContextDeinit()
 {
+    m_fboConfigurations.clear();
     m_defaultFBO = nullptr;
     m_fbo = nullptr;
 }
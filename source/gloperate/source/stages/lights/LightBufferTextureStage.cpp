@@ -1,23 +1,24 @@
 
 #include <gloperate/stages/lights/LightBufferTextureStage.h>
 
-#include <glm/vec3.hpp>
+#include <algorithm>
+
+#include <cppassist/memory/make_unique.h>
 
 #include <glbinding/gl/enum.h>
+#include <glbinding/gl/functions.h>
 
 #include <globjects/Buffer.h>
 #include <globjects/Texture.h>
 
 #include <gloperate/rendering/Light.h>
+#include <gloperate/rendering/StreamingBuffer.h>
 
 
 namespace
 {
-struct ColorTypeEntry
-{
-    glm::vec3 color;
-    float type;
-};
+const size_t s_initialCapacity = 64 * 1024; ///< Initial size of the streaming buffer (in bytes)
+const size_t s_bufferedUpdates = 3;         ///< Number of light data updates that fit into the streaming buffer
 }
 
 
@@ -32,6 +33,8 @@ LightBufferTextureStage::LightBufferTextureStage(Environment * environment, cons
 , colorTypeData("colorTypeData", this, nullptr)
 , positionData("positionData", this, nullptr)
 , attenuationData("attenuationData", this, nullptr)
+, m_offsetAlignment(1)
+, m_uploaded(false)
 {
 }
 
@@ -50,37 +53,21 @@ void LightBufferTextureStage::onContextDeinit(AbstractGLContext * /*context*/)
     m_positionTexture.reset();
     m_colorTypeTexture.reset();
 
-    m_attenuationBuffer.reset();
-    m_positionBuffer.reset();
-    m_colorTypeBuffer.reset();
+    m_streamingBuffer.reset();
 }
 
 void LightBufferTextureStage::onProcess()
 {
-    if (!colorTypeData.isValid() || !positionData.isValid() || !attenuationData.isValid())
+    if (!m_streamingBuffer)
     {
         setupBufferTextures();
     }
 
-    std::vector<ColorTypeEntry> colorsTypes{};
-    std::vector<glm::vec3> positions{};
-    std::vector<glm::vec3> attenuations{};
-
-    for (auto lightInput : m_lightInputs)
+    if (updateLights() || !m_uploaded)
     {
-        if (!lightInput->isValid())
-            continue;
-
-        auto lightDef = lightInput->value();
-        colorsTypes.push_back(ColorTypeEntry{lightDef.color, float(lightDef.type)});
-        positions.push_back(lightDef.position);
-        attenuations.push_back(lightDef.attenuationCoefficients);
+        uploadLights();
     }
 
-    m_colorTypeBuffer->setData(colorsTypes, gl::GL_DYNAMIC_DRAW);
-    m_positionBuffer->setData(positions, gl::GL_DYNAMIC_DRAW);
-    m_attenuationBuffer->setData(attenuations, gl::GL_DYNAMIC_DRAW);
-
     colorTypeData.setValue(m_colorTypeTexture.get());
     positionData.setValue(m_positionTexture.get());
     attenuationData.setValue(m_attenuationTexture.get());
@@ -88,18 +75,135 @@ void LightBufferTextureStage::onProcess()
 
 void LightBufferTextureStage::setupBufferTextures()
 {
-    m_colorTypeBuffer = cppassist::make_unique<globjects::Buffer>();
     m_colorTypeTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
-
-    m_positionBuffer = cppassist::make_unique<globjects::Buffer>();
     m_positionTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
-
-    m_attenuationBuffer = cppassist::make_unique<globjects::Buffer>();
     m_attenuationTexture = cppassist::make_unique<globjects::Texture>(gl::GL_TEXTURE_BUFFER);
 
-    m_colorTypeTexture->texBuffer(gl::GL_RGBA32F, m_colorTypeBuffer.get());
-    m_positionTexture->texBuffer(gl::GL_RGB32F, m_positionBuffer.get());
-    m_attenuationTexture->texBuffer(gl::GL_RGB32F, m_attenuationBuffer.get());
+    m_streamingBuffer = cppassist::make_unique<StreamingBuffer>(s_initialCapacity);
+
+    m_offsetAlignment = 1;
+    gl::glGetIntegerv(gl::GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &m_offsetAlignment);
+    m_offsetAlignment = std::max(m_offsetAlignment, gl::GLint(1));
+
+    // Light data has to be written to the new buffer
+    m_uploaded = false;
+}
+
+bool LightBufferTextureStage::updateLights()
+{
+    // Check if lights have been added or removed
+    bool repack = (m_lightValid.size() != m_lightInputs.size());
+
+    for (size_t i = 0; !repack && i < m_lightInputs.size(); ++i)
+    {
+        repack = (m_lightInputs[i]->isValid() != m_lightValid[i]);
+    }
+
+    if (repack)
+    {
+        m_lightValid.resize(m_lightInputs.size());
+
+        // Keeps the capacity of the vectors
+        m_colorsTypes.clear();
+        m_positions.clear();
+        m_attenuations.clear();
+
+        for (size_t i = 0; i < m_lightInputs.size(); ++i)
+        {
+            m_lightValid[i] = m_lightInputs[i]->isValid();
+
+            if (!m_lightValid[i])
+                continue;
+
+            const auto light = m_lightInputs[i]->value();
+            m_colorsTypes.push_back(glm::vec4(light.color, float(light.type)));
+            m_positions.push_back(light.position);
+            m_attenuations.push_back(light.attenuationCoefficients);
+        }
+
+        return true;
+    }
+
+    // Update changed lights only
+    bool changed = false;
+    size_t index = 0;
+
+    for (size_t i = 0; i < m_lightInputs.size(); ++i)
+    {
+        if (!m_lightValid[i])
+            continue;
+
+        if (m_lightInputs[i]->hasChanged())
+        {
+            const auto light = m_lightInputs[i]->value();
+            m_colorsTypes[index] = glm::vec4(light.color, float(light.type));
+            m_positions[index] = light.position;
+            m_attenuations[index] = light.attenuationCoefficients;
+
+            changed = true;
+        }
+
+        ++index;
+    }
+
+    return changed;
+}
+
+void LightBufferTextureStage::uploadLights()
+{
+    // Ranges of buffer textures must not be empty, a zeroed entry is a light of type None
+    const auto count = std::max(m_positions.size(), size_t(1));
+
+    const auto colorTypeSize   = count * sizeof(glm::vec4);
+    const auto positionSize    = count * sizeof(glm::vec3);
+    const auto attenuationSize = count * sizeof(glm::vec3);
+
+    const auto alignment = static_cast<size_t>(m_offsetAlignment);
+    const auto requiredSize = colorTypeSize + positionSize + attenuationSize + 3 * alignment;
+
+    // The commands reading the previous light data have been issued since the last upload
+    m_streamingBuffer->fence();
+
+    // Keep enough space for the light data of several frames in flight
+    if (m_streamingBuffer->capacity() < s_bufferedUpdates * requiredSize)
+    {
+        m_streamingBuffer->resize(s_bufferedUpdates * requiredSize);
+    }
+
+    size_t colorTypeOffset   = 0;
+    size_t positionOffset    = 0;
+    size_t attenuationOffset = 0;
+
+    const auto colorsTypes  = static_cast<glm::vec4 *>(m_streamingBuffer->allocate(colorTypeSize, alignment, colorTypeOffset));
+    const auto positions    = static_cast<glm::vec3 *>(m_streamingBuffer->allocate(positionSize, alignment, positionOffset));
+    const auto attenuations = static_cast<glm::vec3 *>(m_streamingBuffer->allocate(attenuationSize, alignment, attenuationOffset));
+
+    if (!colorsTypes || !positions || !attenuations)
+    {
+        return;
+    }
+
+    if (m_positions.empty())
+    {
+        colorsTypes[0]  = glm::vec4(0.0f);
+        positions[0]    = glm::vec3(0.0f);
+        attenuations[0] = glm::vec3(0.0f);
+    }
+    else
+    {
+        std::copy(m_colorsTypes.begin(), m_colorsTypes.end(), colorsTypes);
+        std::copy(m_positions.begin(), m_positions.end(), positions);
+        std::copy(m_attenuations.begin(), m_attenuations.end(), attenuations);
+    }
+
+    m_streamingBuffer->flush();
+
+    const auto buffer = m_streamingBuffer->buffer();
+    m_colorTypeTexture->texBufferRange(gl::GL_RGBA32F, buffer, colorTypeOffset, colorTypeSize);
+    m_positionTexture->texBufferRange(gl::GL_RGB32F, buffer, positionOffset, positionSize);
+    m_attenuationTexture->texBufferRange(gl::GL_RGB32F, buffer, attenuationOffset, attenuationSize);
+
+    m_uploaded = true;
 }
 
 Input<Light> * LightBufferTextureStage::createLightInput()
@@ -19,32 +19,74 @@ extern "C" {
 }
 
 
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(55,28,1)
-#define av_frame_alloc  avcodec_alloc_frame
-#endif
-
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <string>
 
 #include <glbinding/gl/enum.h>
 
 #include <globjects/base/baselogging.h>
 
+#include <gloperate/base/ThreadPool.h>
+
 
 using namespace globjects;
 
 
+static std::string parameter(const cppexpose::VariantMap & parameters, const std::string & name)
+{
+    const auto it = parameters.find(name);
+    return it != parameters.end() ? it->second.toString() : "";
+}
+
+static bool parseThreadCount(const std::string & value, int & threads)
+{
+    // Empty or 'auto': choose automatically
+    if (value.empty() || value == "auto")
+    {
+        threads = 0;
+        return true;
+    }
+
+    char * end = nullptr;
+    errno = 0;
+    const auto number = std::strtol(value.c_str(), &end, 10);
+
+    if (errno != 0 || end == value.c_str() || *end != '\0' || number < 0 || number > INT_MAX)
+    {
+        return false;
+    }
+
+    threads = static_cast<int>(number);
+    return true;
+}
+
+
 FFMPEGVideoEncoder::FFMPEGVideoEncoder()
 : m_context(nullptr)
 , m_videoStream(nullptr)
+, m_codecContext(nullptr)
 , m_frame(nullptr)
+, m_packet(nullptr)
 , m_frameCounter(0)
+, m_threadPool(nullptr)
+, m_inputWidth(0)
+, m_inputHeight(0)
+, m_inputFormat(AV_PIX_FMT_NONE)
 {
+#if LIBAVFORMAT_VERSION_INT < AV_VERSION_INT(58, 9, 100)
     // Register codecs and formats
     avcodec_register_all();
     av_register_all();
+#endif
 }
 
 FFMPEGVideoEncoder::~FFMPEGVideoEncoder()
 {
+    releaseConverters();
+    releaseEncoding();
 }
 
 bool FFMPEGVideoEncoder::initEncoding(const cppexpose::VariantMap & parameters)
@@ -59,205 +101,393 @@ bool FFMPEGVideoEncoder::initEncoding(const cppexpose::VariantMap & parameters)
     auto gopsize = parameters.at("gopsize").toLongLong() != 0 ? parameters.at("gopsize").toLongLong() : fps * 2;
     auto bitrate = parameters.at("bitrate").toLongLong() != 0 ? parameters.at("bitrate").toLongLong() : 400000;
 
+    auto threads = parameter(parameters, "threads");
+    auto pixelFormat = parameter(parameters, "pixelformat");
+
     if (filepath == "")
     {
         critical() << "Filepath must not be empty.";
         return false;
     }
 
-    // Choose video format from file name
-    AVOutputFormat * avFormat = av_guess_format(format.c_str(), NULL, NULL);
-    if (!avFormat) {
+    auto threadCount = 0;
+    if (!parseThreadCount(threads, threadCount))
+    {
+        warning() << "Invalid number of threads (" << threads << "), choosing automatically.";
+        threadCount = 0;
+    }
+
+    // Create context, choosing the video format from the format name or file name
+    avformat_alloc_output_context2(&m_context, nullptr, format.empty() ? nullptr : format.c_str(), filepath.c_str());
+    if (!m_context) {
         critical() << "Could not use given output format (" << format << ").";
+        releaseEncoding();
         return false;
     }
 
     // Find video encoder
-    AVCodec * avCodec = avcodec_find_encoder_by_name(codec.c_str());
+    const AVCodec * avCodec = avcodec_find_encoder_by_name(codec.c_str());
     if (!avCodec) {
         critical() << "Codec (" << codec << ") not found.";
+        releaseEncoding();
         return false;
     }
 
-    // Create context
-    m_context = avformat_alloc_context();
-    if (!m_context) {
-        critical() << "Could not create video context.";
-        return false;
-    }
-    m_context->oformat = avFormat;
-
     // Create video stream
     m_videoStream = avformat_new_stream(m_context, avCodec);
     if (!m_videoStream) {
         critical() << "Could not alloc stream";
+        releaseEncoding();
+        return false;
+    }
+
+    // Create encoder context
+    m_codecContext = avcodec_alloc_context3(avCodec);
+    if (!m_codecContext) {
+        critical() << "Could not create codec context.";
+        releaseEncoding();
         return false;
     }
 
     // Set video stream type and options
-    m_videoStream->codec->codec_type    = AVMEDIA_TYPE_VIDEO;
-    m_videoStream->codec->codec_id      = avCodec->id;
-    m_videoStream->codec->bit_rate      = bitrate;
-    m_videoStream->codec->width         = width;
-    m_videoStream->codec->height        = height;
-    m_videoStream->codec->time_base.num = 1;
-    m_videoStream->codec->time_base.den = fps;
-    m_videoStream->codec->gop_size      = gopsize;
-    m_videoStream->codec->pix_fmt       = AV_PIX_FMT_YUV420P;
+    m_codecContext->codec_type    = AVMEDIA_TYPE_VIDEO;
+    m_codecContext->codec_id      = avCodec->id;
+    m_codecContext->bit_rate      = bitrate;
+    m_codecContext->width         = width;
+    m_codecContext->height        = height;
+    m_codecContext->time_base.num = 1;
+    m_codecContext->time_base.den = fps;
+    m_codecContext->framerate.num = fps;
+    m_codecContext->framerate.den = 1;
+    m_codecContext->gop_size      = gopsize;
+    m_codecContext->pix_fmt       = pixelFormat.empty() ? AV_PIX_FMT_YUV420P : av_get_pix_fmt(pixelFormat.c_str());
+    m_codecContext->thread_count  = threadCount; // 0: choose automatically
+
+    if (m_codecContext->pix_fmt == AV_PIX_FMT_NONE) {
+        critical() << "Pixel format (" << pixelFormat << ") not supported.";
+        releaseEncoding();
+        return false;
+    }
 
     // Some formats want stream headers to be separate
     if (m_context->oformat->flags & AVFMT_GLOBALHEADER) {
-        m_videoStream->codec->flags |= CODEC_FLAG_GLOBAL_HEADER;
+        m_codecContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
     }
 
-    // [DEBUG] Output video stream info
-    av_dump_format(m_context, 0, filepath.c_str(), 1);
+    // Collect codec specific options
+    AVDictionary * options = nullptr;
+    for (auto name : { "preset", "tune", "crf" })
+    {
+        const auto value = parameter(parameters, name);
+        if (!value.empty()) {
+            av_dict_set(&options, name, value.c_str(), 0);
+        }
+    }
 
     // Open codec
-    if (avcodec_open2(m_videoStream->codec, avCodec, nullptr) < 0) {
+    const auto res = avcodec_open2(m_codecContext, avCodec, &options);
+
+    // Report options that are not supported by the codec
+    for (AVDictionaryEntry * entry = nullptr; (entry = av_dict_get(options, "", entry, AV_DICT_IGNORE_SUFFIX)); ) {
+        warning() << "Option " << entry->key << " not supported by codec (" << codec << ")";
+    }
+    av_dict_free(&options);
+
+    if (res < 0) {
         critical() << "Could not open codec (" << codec << ")";
+        releaseEncoding();
         return false;
     }
 
-    // Allocate picture for encoding
+    // Pass codec parameters to the stream
+    m_videoStream->time_base = m_codecContext->time_base;
+    if (avcodec_parameters_from_context(m_videoStream->codecpar, m_codecContext) < 0) {
+        critical() << "Could not set stream parameters";
+        releaseEncoding();
+        return false;
+    }
+
+    // [DEBUG] Output video stream info
+    av_dump_format(m_context, 0, filepath.c_str(), 1);
+
+    // Allocate frame for encoding
     m_frame = av_frame_alloc();
     if (!m_frame) {
         critical() << "Could not allocate frame";
+        releaseEncoding();
         return false;
     }
 
+    m_frame->width  = m_codecContext->width;
+    m_frame->height = m_codecContext->height;
+    m_frame->format = m_codecContext->pix_fmt;
+
     // Allocate frame buffer
-    int size = avpicture_get_size(m_videoStream->codec->pix_fmt, m_videoStream->codec->width, m_videoStream->codec->height);
-    uint8_t * picture_buf = (uint8_t *)av_malloc(size);
-    if (!picture_buf) {
+    if (av_frame_get_buffer(m_frame, 32) < 0) {
         critical() << "Could not allocate picture";
-        av_free(m_frame);
+        releaseEncoding();
         return false;
     }
 
-    // Assign frame buffer to picture
-    avpicture_fill((AVPicture *)m_frame, picture_buf, m_videoStream->codec->pix_fmt, m_videoStream->codec->width, m_videoStream->codec->height);
+    // Allocate output packet
+    m_packet = av_packet_alloc();
+    if (!m_packet) {
+        critical() << "Could not allocate packet";
+        releaseEncoding();
+        return false;
+    }
 
     // Output to file
-    
-    if (!(avFormat->flags & AVFMT_NOFILE)) {
+    if (!(m_context->oformat->flags & AVFMT_NOFILE)) {
         if (avio_open(&m_context->pb, filepath.c_str(), AVIO_FLAG_WRITE) < 0) {
             critical() << "Could not open  " << filepath;
+            releaseEncoding();
             return false;
         }
     }
 
     // Write video header
-    avformat_write_header(m_context, NULL);
+    if (avformat_write_header(m_context, nullptr) < 0) {
+        critical() << "Could not write video header";
+        releaseEncoding();
+        return false;
+    }
+
+    m_frameCounter = 0;
 
     return true;
 }
 
-void FFMPEGVideoEncoder::putFrame(const gloperate::Image & image)
+void FFMPEGVideoEncoder::setThreadPool(gloperate::ThreadPool * threadPool)
 {
-    if (image.format() == gl::GL_RGB)
+    m_threadPool = threadPool;
+}
+
+void FFMPEGVideoEncoder::putFrame(const gloperate::Image & image, bool flip)
+{
+    if (image.type() == gl::GL_UNSIGNED_BYTE)
     {
-        putFrame(image.data(), image.width(), image.height());
+        putFrame(image.data(), image.width(), image.height(), image.format(), flip);
     } else {
-        critical() << "Image format not supported.";
+        critical() << "Image type not supported.";
     }
 }
 
 void FFMPEGVideoEncoder::putFrame(const char * data, int width, int height)
 {
-    // Put input image into picture structure
-    AVPicture inputPicture;
-    avpicture_fill(&inputPicture, (uint8_t*)data, AV_PIX_FMT_RGB24, width, height);
+    putFrame(data, width, height, gl::GL_RGB);
+}
 
-    // Convert input image to output frame
-    SwsContext * converter = sws_getContext(width,                     height,                     AV_PIX_FMT_RGB24,
-                                            m_videoStream->codec->width, m_videoStream->codec->height, AV_PIX_FMT_YUV420P,
-                                            SWS_BICUBIC, NULL, NULL, NULL);
+void FFMPEGVideoEncoder::putFrame(const char * data, int width, int height, gl::GLenum format, bool flip)
+{
+    // Get input pixel format
+    int inputFormat = AV_PIX_FMT_NONE;
+    switch (format)
+    {
+        case gl::GL_RGB:  inputFormat = AV_PIX_FMT_RGB24; break;
+        case gl::GL_RGBA: inputFormat = AV_PIX_FMT_RGBA;  break;
+        case gl::GL_BGRA: inputFormat = AV_PIX_FMT_BGRA;  break;
+        default:
+            critical() << "Image format not supported.";
+            return;
+    }
 
-    sws_scale(converter, inputPicture.data, inputPicture.linesize, 0, height, m_frame->data, m_frame->linesize);
-    sws_freeContext(converter);
+    // Frame buffer may still be referenced by the codec
+    if (av_frame_make_writable(m_frame) < 0) {
+        critical() << "Could not allocate picture";
+        return;
+    }
 
-    // Set frame info
-    m_frame->width  = m_videoStream->codec->width;
-    m_frame->height = m_videoStream->codec->height;
-    m_frame->format = m_videoStream->codec->pix_fmt;
+    // Convert input image to output frame
+    prepareConverters(width, height, inputFormat);
+    convert(data, width, height, inputFormat, flip);
 
     // Set timestamp
     m_frame->pts = m_frameCounter++;
 
-    // Create output packet
-    AVPacket packet;
-    av_init_packet(&packet);
-    packet.data = nullptr;
-    packet.size = 0;
-
-    // Encode video frame
-    int res = 0;
-    if (m_context->oformat->flags & AVFMT_RAWPICTURE) {
-        // Raw image format
-        packet.flags |= AV_PKT_FLAG_KEY;
-        packet.stream_index = m_videoStream->index;
-        packet.data = (uint8_t *)m_frame;
-        packet.size = sizeof(AVPicture);
-
-        // Write frame
-        res = av_write_frame(m_context, &packet);
-    } else {
-        // Encode image frame
-        int got_output;
-        avcodec_encode_video2(m_videoStream->codec, &packet, m_frame, &got_output);
-        if (got_output) {
-            // Rescale time stamps
-            if (packet.pts != AV_NOPTS_VALUE) {
-                packet.pts = av_rescale_q(packet.pts, m_videoStream->codec->time_base, m_videoStream->time_base);
-            }
-            if (packet.dts != AV_NOPTS_VALUE) {
-                packet.dts = av_rescale_q(packet.dts, m_videoStream->codec->time_base, m_videoStream->time_base);
-            }
-            packet.stream_index = m_videoStream->index;
+    // Encode video frame; the codec may keep several frames in flight
+    if (avcodec_send_frame(m_codecContext, m_frame) < 0) {
+        critical() << "Error while encoding video frame";
+        return;
+    }
 
-            // Write frame
-            res = av_write_frame(m_context, &packet);
-        }
+    writePackets();
+}
+
+void FFMPEGVideoEncoder::prepareConverters(int width, int height, int inputFormat)
+{
+    // Reuse converters of the previous frame
+    if (!m_converters.empty() && width == m_inputWidth && height == m_inputHeight && inputFormat == m_inputFormat)
+    {
+        return;
+    }
+
+    releaseConverters();
+
+    m_inputWidth  = width;
+    m_inputHeight = height;
+    m_inputFormat = inputFormat;
+
+    const auto outputWidth  = m_codecContext->width;
+    const auto outputHeight = m_codecContext->height;
+    const auto outputFormat = m_codecContext->pix_fmt;
+
+    // Split frame into slices, if it is not scaled
+    auto numSlices = 1;
+    if (m_threadPool && width == outputWidth && height == outputHeight)
+    {
+        numSlices = std::max(1, std::min(static_cast<int>(m_threadPool->numThreads()) + 1, height / 64));
+    }
+
+    // Slices start at rows that are not affected by chroma subsampling
+    const auto alignment = 1 << av_pix_fmt_desc_get(outputFormat)->log2_chroma_h;
+    const auto sliceRows = ((height + numSlices - 1) / numSlices + alignment - 1) / alignment * alignment;
+
+    for (auto row = 0; row < height; row += sliceRows)
+    {
+        const auto rows = std::min(sliceRows, height - row);
+        m_sliceRows.push_back(rows);
+    }
+
+    if (m_sliceRows.size() == 1)
+    {
+        m_converters.push_back(sws_getContext(width,       height,       static_cast<AVPixelFormat>(inputFormat),
+                                              outputWidth, outputHeight, outputFormat,
+                                              SWS_BICUBIC, NULL, NULL, NULL));
+        return;
+    }
+
+    for (auto rows : m_sliceRows)
+    {
+        m_converters.push_back(sws_getContext(width, rows, static_cast<AVPixelFormat>(inputFormat),
+                                              width, rows, outputFormat,
+                                              SWS_BICUBIC, NULL, NULL, NULL));
+    }
+}
+
+void FFMPEGVideoEncoder::convert(const char * data, int width, int height, int inputFormat, bool flip)
+{
+    // Put input image into picture structure
+    uint8_t * inputData[4];
+    int inputLinesize[4];
+    av_image_fill_arrays(inputData, inputLinesize, reinterpret_cast<const uint8_t *>(data), static_cast<AVPixelFormat>(inputFormat), width, height, 1);
+
+    // Read rows bottom-up for flipped images
+    if (flip)
+    {
+        inputData[0]    += (height - 1) * inputLinesize[0];
+        inputLinesize[0] = -inputLinesize[0];
     }
 
-    // Check for errors
-    if (res != 0) {
-        critical() << "Error while writing video frame";
+    if (m_converters.size() == 1)
+    {
+        sws_scale(m_converters.front(), inputData, inputLinesize, 0, height, m_frame->data, m_frame->linesize);
         return;
     }
 
-    // Destroy packet
-    av_free_packet(&packet);
+    // Vertical subsampling of the output planes
+    const auto descriptor = av_pix_fmt_desc_get(m_codecContext->pix_fmt);
+    const auto numPlanes  = av_pix_fmt_count_planes(m_codecContext->pix_fmt);
+
+    // Compute first row of each slice
+    std::vector<int> firstRows(m_sliceRows.size(), 0);
+    for (size_t i = 1; i < m_sliceRows.size(); ++i)
+    {
+        firstRows[i] = firstRows[i - 1] + m_sliceRows[i - 1];
+    }
+
+    // Convert slices in parallel
+    m_threadPool->parallelFor(m_converters.size(), [&] (size_t begin, size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            const auto row = firstRows[i];
+
+            const uint8_t * input[4] = {
+                inputData[0] + row * inputLinesize[0], nullptr, nullptr, nullptr
+            };
+
+            uint8_t * output[4] = { nullptr, nullptr, nullptr, nullptr };
+            for (auto plane = 0; plane < numPlanes; ++plane)
+            {
+                const auto chroma = plane == 1 || plane == 2;
+                output[plane] = m_frame->data[plane] + (chroma ? row >> descriptor->log2_chroma_h : row) * m_frame->linesize[plane];
+            }
+
+            sws_scale(m_converters[i], input, inputLinesize, 0, m_sliceRows[i], output, m_frame->linesize);
+        }
+    });
+}
+
+void FFMPEGVideoEncoder::releaseConverters()
+{
+    for (auto converter : m_converters)
+    {
+        sws_freeContext(converter);
+    }
+
+    m_converters.clear();
+    m_sliceRows.clear();
+}
+
+void FFMPEGVideoEncoder::writePackets()
+{
+    // Write all packets the codec has finished so far
+    while (avcodec_receive_packet(m_codecContext, m_packet) == 0)
+    {
+        // Rescale time stamps
+        av_packet_rescale_ts(m_packet, m_codecContext->time_base, m_videoStream->time_base);
+        m_packet->stream_index = m_videoStream->index;
+
+        // Write frame (takes ownership of the packet data)
+        if (av_interleaved_write_frame(m_context, m_packet) < 0) {
+            critical() << "Error while writing video frame";
+        }
+    }
 }
 
 void FFMPEGVideoEncoder::finishEncoding()
 {
-    // Write end of video file
-    av_write_trailer(m_context);
+    // Release colour converters
+    releaseConverters();
 
-    // Close video codec
-    if (m_videoStream) {
-        avcodec_close(m_videoStream->codec);
+    if (!m_context) {
+        return;
     }
 
-    // Release frame
-    if (m_frame) {
-        av_free(m_frame->data[0]);
-        av_free(m_frame);
+    // Flush frames that are still in flight
+    if (m_codecContext && m_packet && avcodec_is_open(m_codecContext)) {
+        avcodec_send_frame(m_codecContext, nullptr);
+        writePackets();
     }
 
-    // Release video streams
-    for (unsigned int i = 0; i < m_context->nb_streams; i++) {
-        av_freep(&m_context->streams[i]->codec);
-        av_freep(&m_context->streams[i]);
+    // Write end of video file
+    if (m_context->pb) {
+        av_write_trailer(m_context);
+    }
+
+    releaseEncoding();
+}
+
+void FFMPEGVideoEncoder::releaseEncoding()
+{
+    // Release codec, frame and packet
+    avcodec_free_context(&m_codecContext);
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+
+    if (!m_context) {
+        m_videoStream = nullptr;
+        return;
     }
 
     // Close output file
     if (!(m_context->oformat->flags & AVFMT_NOFILE)) {
-        avio_close(m_context->pb);
+        avio_closep(&m_context->pb);
     }
 
-    // Release context
-    av_free(m_context);
+    // Release context and streams
+    avformat_free_context(m_context);
+    m_context     = nullptr;
+    m_videoStream = nullptr;
 }
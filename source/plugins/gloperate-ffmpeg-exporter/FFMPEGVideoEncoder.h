@@ -3,20 +3,41 @@
 
 
 #include <string>
+#include <vector>
 
 #include <cppexpose/variant/Variant.h>
 
 #include <gloperate/rendering/Image.h>
 
 
-class AVFormatContext;
-class AVStream;
-class AVFrame;
+struct AVFormatContext;
+struct AVStream;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+
+namespace gloperate
+{
+    class ThreadPool;
+}
 
 
 /**
 *  @brief
 *    Class for encoding single frames into a video using FFMPEG
+*
+*    Frames are passed to the codec with the send/receive API, so the codec
+*    can keep several frames in flight for frame threading and lookahead.
+*    Besides the mandatory parameters, the optional parameters 'threads',
+*    'preset', 'tune', 'crf' and 'pixelformat' are passed to the codec.
+*    Options that the codec does not support are reported as warnings.
+*
+*    The colour conversion contexts are created for the first frame and
+*    reused for the whole encoding session. If a thread pool is set and
+*    the frames are not scaled, the conversion is split into horizontal
+*    slices that are converted in parallel.
 */
 class FFMPEGVideoEncoder
 {
@@ -44,14 +65,25 @@ public:
     */
     bool initEncoding(const cppexpose::VariantMap & parameters);
 
+    /**
+    *  @brief
+    *    Set thread pool for the colour conversion
+    *
+    *  @param[in] threadPool
+    *    Thread pool (can be null for conversion on the calling thread)
+    */
+    void setThreadPool(gloperate::ThreadPool * threadPool);
+
     /**
     *  @brief
     *    Put frame into video
     *
     *  @param[in] image
-    *    Frame as gloperate::Image
+    *    Frame as gloperate::Image (GL_RGB, GL_RGBA or GL_BGRA with GL_UNSIGNED_BYTE)
+    *  @param[in] flip
+    *    Flip image vertically (e.g., when read directly from OpenGL)
     */
-    void putFrame(const gloperate::Image & image);
+    void putFrame(const gloperate::Image & image, bool flip = false);
 
     /**
     *  @brief
@@ -68,6 +100,23 @@ public:
     */
     void putFrame(const char * data, int width, int height);
 
+    /**
+    *  @brief
+    *    Put frame into video
+    *
+    *  @param[in] data
+    *    Byte data of single frame
+    *  @param[in] width
+    *    Frame pixel width
+    *  @param[in] height
+    *    Frame pixel height
+    *  @param[in] format
+    *    Pixel format (GL_RGB, GL_RGBA or GL_BGRA)
+    *  @param[in] flip
+    *    Flip image vertically (e.g., when read directly from OpenGL)
+    */
+    void putFrame(const char * data, int width, int height, gl::GLenum format, bool flip = false);
+
     /**
     *  @brief
     *    Finalize encoding and close video file
@@ -76,8 +125,24 @@ public:
 
 
 protected:
-    AVFormatContext * m_context;
-    AVStream        * m_videoStream;
-    AVFrame         * m_frame;
-    int               m_frameCounter;
+    void prepareConverters(int width, int height, int inputFormat);
+    void convert(const char * data, int width, int height, int inputFormat, bool flip);
+    void releaseConverters();
+    void writePackets();
+    void releaseEncoding();
+
+
+protected:
+    AVFormatContext          * m_context;
+    AVStream                 * m_videoStream;
+    AVCodecContext           * m_codecContext;
+    AVFrame                  * m_frame;
+    AVPacket                 * m_packet;
+    int                        m_frameCounter;
+    gloperate::ThreadPool    * m_threadPool;
+    std::vector<SwsContext *>  m_converters;
+    std::vector<int>           m_sliceRows;
+    int                        m_inputWidth;
+    int                        m_inputHeight;
+    int                        m_inputFormat;
 };
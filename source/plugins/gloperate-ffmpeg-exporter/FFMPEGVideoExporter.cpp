@@ -1,6 +1,8 @@
 
 #include "FFMPEGVideoExporter.h"
 
+#include <algorithm>
+
 #include <glm/vec2.hpp>
 
 #include <cppassist/memory/make_unique.h>
@@ -57,6 +59,13 @@ static const char * s_fragmentShader = R"(
 )";
 
 
+static unsigned int parameter(const cppexpose::VariantMap & parameters, const std::string & name, unsigned int defaultValue)
+{
+    const auto it = parameters.find(name);
+    return (it != parameters.end() && it->second.toULongLong() > 0) ? static_cast<unsigned int>(it->second.toULongLong()) : defaultValue;
+}
+
+
 CPPEXPOSE_COMPONENT(FFMPEGVideoExporter, gloperate::AbstractVideoExporter)
 
 
@@ -67,6 +76,7 @@ FFMPEGVideoExporter::FFMPEGVideoExporter()
 , m_progress(0)
 , m_initialized(false)
 , m_contextHandling(AbstractVideoExporter::IgnoreContext)
+, m_stopEncoding(false)
 {
 }
 
@@ -94,46 +104,55 @@ void FFMPEGVideoExporter::createVideo(AbstractVideoExporter::ContextHandling con
     auto length = m_parameters.at("duration").toULongLong() * fps;
     //auto timeDelta = 1.f / static_cast<float>(fps);
 
+    const auto pipelined = m_parameters.count("pipelined") > 0 && m_parameters.at("pipelined").toBool();
+
     initialize(contextHandling);
 
+    if (pipelined)
+    {
+        startEncoderThread();
+    }
+
     for (unsigned int i = 0; i < length; ++i)
     {
         // [TODO]: Revert to explicit virtual time management
         //m_canvas->environment()->update(timeDelta);
         m_canvas->updateTime();
 
-        m_canvas->render(m_fbo.get());
-
-        m_fbo_quad->bind(gl::GL_FRAMEBUFFER);
-
-        gl::glViewport(
-            viewport.x,
-            viewport.y,
-            viewport.z,
-            viewport.w
-        );
-
-        gl::glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
-
-        m_color->bindActive(0);
-
-        m_program->use();
-        m_vao->drawArrays(gl::GL_TRIANGLE_STRIP, 0, 4);
-        m_program->release();
+        if (pipelined)
+        {
+            // Frames are read back unflipped, the encoder flips them during conversion
+            m_canvas->render(m_fbo.get());
 
-        m_color->unbindActive(0);
+            // Hand the oldest frame over to the encoder and reuse its buffer
+            const auto slot = i % m_readbackBuffers.size();
+            finishReadback(slot);
+            startReadback(slot);
+        }
+        else
+        {
+            renderFrame(viewport);
 
-        Framebuffer::unbind(gl::GL_FRAMEBUFFER);
+            m_color_quad->getImage(0, m_image->format(), m_image->type(), m_image->data());
 
-        m_color_quad->getImage(0, m_image->format(), m_image->type(), m_image->data());
-
-        m_videoEncoder->putFrame(*m_image);
+            m_videoEncoder->putFrame(*m_image);
+        }
 
         m_progress = i*100/length;
         progress(i, length);
     }
 
+    if (pipelined)
+    {
+        // Collect the remaining frames in the order they have been rendered
+        for (size_t i = 0; i < m_readbackBuffers.size(); ++i)
+        {
+            finishReadback((length + i) % m_readbackBuffers.size());
+        }
+
+        stopEncoderThread();
+    }
+
     finalize();
 
     progress(1, 1);
@@ -224,6 +243,8 @@ void FFMPEGVideoExporter::initialize(ContextHandling contextHandling)
         m_canvas->openGLContext()->use();
     }
 
+    m_videoEncoder->setThreadPool(m_canvas->environment()->threadPool());
+
     if (!m_videoEncoder->initEncoding(m_parameters))
     {
         critical() << "Error in initializing video encoding.";
@@ -294,6 +315,174 @@ void FFMPEGVideoExporter::createAndSetupShader()
     m_program->setUniform("source", 0);
 }
 
+void FFMPEGVideoExporter::renderFrame(const glm::vec4 & viewport)
+{
+    m_canvas->render(m_fbo.get());
+
+    m_fbo_quad->bind(gl::GL_FRAMEBUFFER);
+
+    gl::glViewport(
+        viewport.x,
+        viewport.y,
+        viewport.z,
+        viewport.w
+    );
+
+    gl::glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
+
+    m_color->bindActive(0);
+
+    m_program->use();
+    m_vao->drawArrays(gl::GL_TRIANGLE_STRIP, 0, 4);
+    m_program->release();
+
+    m_color->unbindActive(0);
+
+    Framebuffer::unbind(gl::GL_FRAMEBUFFER);
+}
+
+void FFMPEGVideoExporter::startEncoderThread()
+{
+    const auto numBuffers = parameter(m_parameters, "readbackBuffers", 3);
+    const auto queueSize  = parameter(m_parameters, "encoderQueueSize", 4);
+    const auto size       = m_image->width() * m_image->height() * Image::channels(gl::GL_BGRA) * m_image->bytes();
+
+    // Create ring of pixel pack buffers
+    m_readbackBuffers.clear();
+    m_readbackFences.clear();
+
+    for (unsigned int i = 0; i < numBuffers; ++i)
+    {
+        auto buffer = cppassist::make_unique<Buffer>();
+        buffer->setData(size, nullptr, gl::GL_STREAM_READ);
+
+        m_readbackBuffers.push_back(std::move(buffer));
+        m_readbackFences.push_back(nullptr);
+    }
+
+    // Create frame images that are passed between readback and encoder
+    m_encoderQueue.clear();
+    m_freeImages.clear();
+
+    for (unsigned int i = 0; i < queueSize; ++i)
+    {
+        m_freeImages.push_back(cppassist::make_unique<Image>(m_image->width(), m_image->height(), gl::GL_BGRA, m_image->type()));
+    }
+
+    m_stopEncoding  = false;
+    m_encoderThread = std::thread(&FFMPEGVideoExporter::encodeFrames, this);
+}
+
+void FFMPEGVideoExporter::stopEncoderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopEncoding = true;
+    }
+
+    m_queueCondition.notify_all();
+
+    // Encoder thread finishes all queued frames before it stops
+    m_encoderThread.join();
+
+    m_readbackFences.clear();
+    m_readbackBuffers.clear();
+    m_freeImages.clear();
+}
+
+void FFMPEGVideoExporter::encodeFrames()
+{
+    while (true)
+    {
+        std::unique_ptr<Image> image;
+
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this] ()
+            {
+                return m_stopEncoding || !m_encoderQueue.empty();
+            });
+
+            if (m_encoderQueue.empty())
+            {
+                return;
+            }
+
+            image = std::move(m_encoderQueue.front());
+            m_encoderQueue.pop_front();
+        }
+
+        m_videoEncoder->putFrame(*image, true);
+
+        // Return image for the next readback
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_freeImages.push_back(std::move(image));
+        }
+
+        m_queueCondition.notify_all();
+    }
+}
+
+void FFMPEGVideoExporter::startReadback(size_t slot)
+{
+    // Read rendered frame directly in the native format, without the flipping quad pass
+    m_readbackBuffers[slot]->bind(gl::GL_PIXEL_PACK_BUFFER);
+    m_color->getImage(0, gl::GL_BGRA, m_image->type(), nullptr);
+    Buffer::unbind(gl::GL_PIXEL_PACK_BUFFER);
+
+    m_readbackFences[slot] = Sync::fence(gl::GL_SYNC_GPU_COMMANDS_COMPLETE);
+}
+
+void FFMPEGVideoExporter::finishReadback(size_t slot)
+{
+    auto & fence = m_readbackFences[slot];
+
+    if (!fence)
+    {
+        return;
+    }
+
+    // Wait until the frame has been copied into the buffer
+    while (fence->clientWait(gl::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == gl::GL_TIMEOUT_EXPIRED)
+    {
+    }
+
+    fence.reset();
+
+    // Wait for a free frame image, if the encoder falls behind
+    std::unique_ptr<Image> image;
+
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_queueCondition.wait(lock, [this] ()
+        {
+            return !m_freeImages.empty();
+        });
+
+        image = std::move(m_freeImages.back());
+        m_freeImages.pop_back();
+    }
+
+    const auto size = image->width() * image->height() * image->channels() * image->bytes();
+
+    const auto data = static_cast<const char *>(m_readbackBuffers[slot]->mapRange(0, size, gl::GL_MAP_READ_BIT));
+    if (data)
+    {
+        std::copy_n(data, size, image->data());
+    }
+    m_readbackBuffers[slot]->unmap();
+
+    // Pass frame to the encoder
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_encoderQueue.push_back(std::move(image));
+    }
+
+    m_queueCondition.notify_all();
+}
+
 void FFMPEGVideoExporter::createAndSetupBuffer()
 {
     auto width = m_parameters.at("width").toULongLong();
@@ -7,6 +7,11 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <cppexpose/plugin/plugin_api.h>
 
@@ -14,6 +19,8 @@
 #include <globjects/Renderbuffer.h>
 #include <globjects/VertexArray.h>
 #include <globjects/Program.h>
+#include <globjects/Buffer.h>
+#include <globjects/Sync.h>
 
 #include <gloperate/tools/AbstractVideoExporter.h>
 
@@ -30,6 +37,15 @@ namespace gloperate {
 /**
 *  @brief
 *    A tool which renders a given Stage into an output video file.
+*
+*    If the parameter 'pipelined' is set, createVideo() reads back frames
+*    asynchronously through a ring of pixel pack buffers ('readbackBuffers',
+*    default 3), so the readback of a frame overlaps the rendering of the
+*    next ones. Frames are read in BGRA directly from the render target and
+*    flipped during colour conversion, so the quad pass is skipped. They are
+*    encoded on a separate thread, which is fed
+*    through a bounded queue ('encoderQueueSize', default 4). Rendering
+*    blocks if the encoder falls behind.
 */
 class FFMPEGVideoExporter : public gloperate::AbstractVideoExporter
 {
@@ -71,6 +87,12 @@ protected:
     void createAndSetupGeometry();
     void createAndSetupShader();
     void createAndSetupBuffer();
+    void renderFrame(const glm::vec4 & viewport);
+    void startEncoderThread();
+    void stopEncoderThread();
+    void encodeFrames();
+    void startReadback(size_t slot);
+    void finishReadback(size_t slot);
 
 
 protected:
@@ -95,4 +117,14 @@ protected:
     AbstractVideoExporter::ContextHandling   m_contextHandling;
 
     glm::vec4                                m_savedViewport;
+
+    std::vector<std::unique_ptr<globjects::Buffer>> m_readbackBuffers;
+    std::vector<std::unique_ptr<globjects::Sync>>   m_readbackFences;
+
+    std::thread                                     m_encoderThread;
+    std::mutex                                      m_queueMutex;
+    std::condition_variable                         m_queueCondition;
+    std::deque<std::unique_ptr<gloperate::Image>>   m_encoderQueue;
+    std::vector<std::unique_ptr<gloperate::Image>>  m_freeImages;
+    bool                                            m_stopEncoding;
 };
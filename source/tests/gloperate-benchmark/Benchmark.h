@@ -0,0 +1,52 @@
+
+#pragma once
+
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+
+/**
+*  @brief
+*    Measure the average duration of a function
+*
+*  @param[in] iterations
+*    Number of calls
+*  @param[in] function
+*    Function to measure
+*
+*  @return
+*    Average duration of one call (in nanoseconds)
+*/
+template <typename Function>
+double measure(size_t iterations, Function && function)
+{
+    // Warm up caches and lazily initialized data
+    function();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+/**
+*  @brief
+*    Print the result of a measurement
+*
+*  @param[in] name
+*    Name of the measurement
+*  @param[in] nanoseconds
+*    Average duration of one call (in nanoseconds)
+*/
+inline void report(const std::string & name, double nanoseconds)
+{
+    std::cout << "[ BENCHMARK] " << name << ": " << nanoseconds << " ns" << std::endl;
+}
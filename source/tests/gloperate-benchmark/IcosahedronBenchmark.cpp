@@ -0,0 +1,44 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gloperate/rendering/Icosahedron.h>
+
+#include <Benchmark.h>
+
+
+class IcosahedronBenchmark : public testing::TestWithParam<unsigned char>
+{
+};
+
+
+TEST_P(IcosahedronBenchmark, Refine)
+{
+    const auto level      = GetParam();
+    const auto iterations = std::max(size_t(3), size_t(1) << (2 * (8 - level)));
+
+    std::vector<glm::vec3>                    vertices;
+    std::vector<gloperate::Icosahedron::Face> indices;
+
+    report("refine [level " + std::to_string(level) + "]", measure(iterations, [&] ()
+    {
+        const auto baseVertices = gloperate::Icosahedron::baseVertices();
+        const auto baseIndices  = gloperate::Icosahedron::baseIndices();
+
+        vertices.assign(baseVertices.begin(), baseVertices.end());
+        indices.assign(baseIndices.begin(), baseIndices.end());
+
+        gloperate::Icosahedron::refine(vertices, indices, level);
+    }));
+
+    // Each level splits every face into four, new points are shared between neighbouring faces
+    const auto scale = size_t(1) << (2 * level);
+
+    EXPECT_EQ(10 * scale + 2, vertices.size());
+    EXPECT_EQ(20 * scale, indices.size());
+}
+
+INSTANTIATE_TEST_CASE_P(Levels, IcosahedronBenchmark, testing::Range<unsigned char>(0, 9));
@@ -0,0 +1,156 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <gloperate/base/BoundedQueue.h>
+
+#include <Benchmark.h>
+
+
+namespace
+{
+
+
+using Clock = std::chrono::steady_clock;
+
+
+// Render thread that holds the canvas mutex while it renders a frame, like Canvas::render()
+class RenderThread
+{
+public:
+    RenderThread(std::mutex & mutex, std::chrono::microseconds frameTime)
+    : m_mutex(mutex)
+    , m_frameTime(frameTime)
+    , m_stop(false)
+    , m_thread([this] () { run(); })
+    {
+    }
+
+    ~RenderThread()
+    {
+        m_stop = true;
+        m_thread.join();
+    }
+
+
+protected:
+    void run()
+    {
+        while (!m_stop)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                const auto end = Clock::now() + m_frameTime;
+                while (Clock::now() < end)
+                {
+                }
+            }
+
+            // Wait for the next frame
+            std::this_thread::sleep_for(m_frameTime / 4);
+        }
+    }
+
+
+protected:
+    std::mutex                & m_mutex;
+    std::chrono::microseconds   m_frameTime;
+    std::atomic<bool>           m_stop;
+    std::thread                 m_thread;
+};
+
+
+struct Update
+{
+    int value;
+};
+
+
+} // namespace
+
+
+TEST(InputQueueBenchmark, UpdateFromUIThread)
+{
+    const auto numUpdates = 2000;
+    const auto interval   = std::chrono::microseconds(100);
+
+    std::mutex                      mutex;
+    RenderThread                    renderThread(mutex, std::chrono::microseconds(4000));
+    gloperate::BoundedQueue<Update> queue(256);
+    auto                            applied = 0;
+
+    // Time the UI thread is blocked by each update (in nanoseconds)
+    const auto blocked = [&] (const std::function<void(int)> & update, double & mean, double & max)
+    {
+        mean = 0.0;
+        max  = 0.0;
+
+        for (auto i = 0; i < numUpdates; ++i)
+        {
+            const auto start = Clock::now();
+            update(1);
+            const auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+            mean += duration / numUpdates;
+            max   = std::max(max, duration);
+
+            std::this_thread::sleep_for(interval);
+        }
+    };
+
+    const auto apply = [&] ()
+    {
+        Update update;
+        while (queue.pop(update))
+        {
+            applied += update.value;
+        }
+    };
+
+    double mean = 0.0;
+    double max  = 0.0;
+
+    // Former update: wait for the canvas mutex and apply the update directly
+    blocked([&] (int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        applied += value;
+    }, mean, max);
+
+    report("locked update, mean", mean);
+    report("locked update, max ", max);
+
+    // Queued update: push the update and apply it only if the render thread is idle
+    blocked([&] (int value)
+    {
+        while (!queue.push(Update{ value }))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            apply();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            apply();
+        }
+    }, mean, max);
+
+    report("queued update, mean", mean);
+    report("queued update, max ", max);
+
+    // All updates must have been applied
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        apply();
+    }
+
+    EXPECT_EQ(2 * numUpdates, applied);
+}
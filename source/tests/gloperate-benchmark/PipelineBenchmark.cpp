@@ -0,0 +1,202 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/Stage.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/pipeline/Output.h>
+
+#include <Benchmark.h>
+
+
+namespace
+{
+
+
+class SyntheticStage : public gloperate::Stage
+{
+public:
+    gloperate::Input<int>  previous;
+    gloperate::Input<int>  shared;
+    gloperate::Output<int> output;
+
+
+public:
+    SyntheticStage(const std::string & name)
+    : Stage(nullptr, "SyntheticStage", name)
+    , previous("previous", this)
+    , shared  ("shared",   this)
+    , output  ("output",   this)
+    {
+    }
+};
+
+
+class SyntheticPipeline : public gloperate::Pipeline
+{
+public:
+    SyntheticPipeline(size_t numStages)
+    : Pipeline(nullptr, "SyntheticPipeline", "pipeline")
+    {
+        // Two independent chains, each stage depends on its predecessor in its chain
+        const auto half = numStages / 2;
+
+        for (size_t i = 0; i < numStages; ++i)
+        {
+            auto stage = new SyntheticStage("stage" + std::to_string(i));
+            addStage(std::unique_ptr<gloperate::Stage>(stage));
+
+            if (i != 0 && i != half)
+            {
+                stage->previous.connect(&m_syntheticStages[i - 1]->output);
+            }
+
+            m_syntheticStages.push_back(stage);
+        }
+
+        updateStageOrder();
+    }
+
+    SyntheticStage * syntheticStage(size_t index) const
+    {
+        return m_syntheticStages[index];
+    }
+
+    using Pipeline::updateStageOrder;
+
+
+protected:
+    std::vector<SyntheticStage *> m_syntheticStages;
+};
+
+
+} // namespace
+
+
+class PipelineBenchmark : public testing::TestWithParam<size_t>
+{
+public:
+    virtual void SetUp() override
+    {
+        // Adding stages is not measured
+        m_pipeline.reset(new SyntheticPipeline(GetParam()));
+    }
+
+    SyntheticStage * stage(size_t index) const
+    {
+        return m_pipeline->syntheticStage(index);
+    }
+
+    // Position of a stage in the execution plan
+    size_t position(size_t index) const
+    {
+        const auto & stages = m_pipeline->stages();
+        return std::distance(stages.begin(), std::find(stages.begin(), stages.end(), stage(index)));
+    }
+
+    // Check that the plan respects the connections within the chains
+    void expectChainOrder() const
+    {
+        const auto numStages = GetParam();
+
+        for (size_t i = 1; i < numStages; ++i)
+        {
+            if (i != numStages / 2)
+            {
+                EXPECT_LT(position(i - 1), position(i));
+            }
+        }
+    }
+
+
+protected:
+    std::unique_ptr<SyntheticPipeline> m_pipeline;
+};
+
+
+TEST_P(PipelineBenchmark, ResortAfterReconnection)
+{
+    const auto numStages  = GetParam();
+    const auto half       = numStages / 2;
+    const auto iterations = size_t(100000) / numStages + 10;
+    const auto name       = std::to_string(numStages) + " stages";
+
+    auto & pipeline = *m_pipeline;
+
+    // Make one chain depend on the end of the other, alternately,
+    // so that each reconnection goes against the current order
+    auto toggle    = false;
+    auto reconnect = [&] ()
+    {
+        toggle = !toggle;
+
+        if (toggle)
+        {
+            stage(half)->shared.disconnect();
+            stage(0)->shared.connect(&stage(numStages - 1)->output);
+        }
+        else
+        {
+            stage(0)->shared.disconnect();
+            stage(half)->shared.connect(&stage(half - 1)->output);
+        }
+    };
+
+    report("full resort        [" + name + "]", measure(iterations, [&] ()
+    {
+        reconnect();
+        pipeline.invalidateStageOrder();
+        pipeline.updateStageOrder();
+    }));
+
+    report("incremental update [" + name + "]", measure(iterations, [&] ()
+    {
+        reconnect();
+        pipeline.updateStageOrder();
+    }));
+
+    // The plan must respect the chains and the connection between them
+    expectChainOrder();
+
+    if (toggle)
+    {
+        EXPECT_LT(position(numStages - 1), position(0));
+    }
+    else
+    {
+        EXPECT_LT(position(half - 1), position(half));
+    }
+}
+
+TEST_P(PipelineBenchmark, UpdateWithoutReorder)
+{
+    const auto numStages  = GetParam();
+    const auto iterations = size_t(100000) / numStages + 10;
+    const auto name       = std::to_string(numStages) + " stages";
+
+    auto & pipeline = *m_pipeline;
+
+    // Move an input of the last stage between two stages that precede it anyway
+    auto last      = stage(numStages - 1);
+    auto toggle    = false;
+    auto reconnect = [&] ()
+    {
+        toggle = !toggle;
+        last->shared.connect(&stage(toggle ? numStages / 2 : numStages - 2)->output);
+    };
+
+    report("unchanged order    [" + name + "]", measure(iterations, [&] ()
+    {
+        reconnect();
+        pipeline.updateStageOrder();
+    }));
+
+    expectChainOrder();
+}
+
+INSTANTIATE_TEST_CASE_P(SyntheticStages, PipelineBenchmark, testing::Values(10u, 100u, 1000u));
@@ -0,0 +1,139 @@
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gloperate/pipeline/Stage.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/pipeline/Output.h>
+
+#include <Benchmark.h>
+
+
+namespace
+{
+
+
+using Data = std::vector<float>;
+
+
+class ChainStage : public gloperate::Stage
+{
+public:
+    gloperate::Input<Data>  input;
+    gloperate::Output<Data> output;
+
+
+public:
+    ChainStage(const std::string & name)
+    : Stage(nullptr, "ChainStage", name)
+    , input ("input",  this)
+    , output("output", this)
+    {
+    }
+};
+
+
+// Former Slot<T>::value(): forwards to the source on each access, the value is copied once at the end of the chain
+template <typename T>
+T chainedValue(const gloperate::Slot<T> & slot)
+{
+    const auto source = static_cast<const gloperate::Slot<T> *>(slot.source());
+
+    return source ? chainedValue(*source) : slot.valueRef();
+}
+
+// Former Slot<T>::ptr(): walks up the connection chain on each access
+template <typename T>
+const T * chainedPtr(const gloperate::Slot<T> & slot)
+{
+    auto current = &slot;
+
+    while (current->source())
+    {
+        current = static_cast<const gloperate::Slot<T> *>(current->source());
+    }
+
+    return &current->valueRef();
+}
+
+
+} // namespace
+
+
+class SlotBenchmark : public testing::TestWithParam<size_t>
+{
+public:
+    virtual void SetUp() override
+    {
+        // Source stage holds the value, each further input is connected to the previous one
+        m_stages.emplace_back(new ChainStage("source"));
+        m_stages.back()->output.setValue(Data(1024, 1.0f));
+
+        gloperate::Slot<Data> * previous = &m_stages.back()->output;
+
+        for (size_t i = 0; i < GetParam(); ++i)
+        {
+            m_stages.emplace_back(new ChainStage("stage" + std::to_string(i)));
+            m_stages.back()->input.connect(previous);
+            previous = &m_stages.back()->input;
+        }
+    }
+
+    virtual void TearDown() override
+    {
+        // Destroy connected stages before their sources
+        while (!m_stages.empty())
+        {
+            m_stages.pop_back();
+        }
+    }
+
+    const gloperate::Input<Data> & lastInput() const
+    {
+        return m_stages.back()->input;
+    }
+
+
+protected:
+    std::vector<std::unique_ptr<ChainStage>> m_stages;
+};
+
+
+TEST_P(SlotBenchmark, ReadConnectedValue)
+{
+    const auto & input      = lastInput();
+    const auto   iterations = size_t(100000);
+    const auto   depth      = std::to_string(GetParam());
+
+    float sum = 0.0f;
+
+    report("chained value() [depth " + depth + "]", measure(iterations, [&] ()
+    {
+        sum += chainedValue(input)[0];
+    }));
+
+    report("chained ptr()   [depth " + depth + "]", measure(iterations, [&] ()
+    {
+        sum += (*chainedPtr(input))[0];
+    }));
+
+    report("value()         [depth " + depth + "]", measure(iterations, [&] ()
+    {
+        sum += input.value()[0];
+    }));
+
+    report("valueRef()      [depth " + depth + "]", measure(iterations, [&] ()
+    {
+        sum += input.valueRef()[0];
+    }));
+
+    // All read paths must see the value of the source
+    EXPECT_EQ(4.0f * (iterations + 1), sum);
+    EXPECT_EQ(chainedPtr(input), &input.valueRef());
+    EXPECT_EQ(&*input, &input.valueRef());
+}
+
+INSTANTIATE_TEST_CASE_P(ConnectionChain, SlotBenchmark, testing::Values(1u, 4u, 16u));
@@ -0,0 +1,249 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <gloperate-text/FontFace.h>
+#include <gloperate-text/Glyph.h>
+#include <gloperate-text/GlyphSequence.h>
+#include <gloperate-text/GlyphVertexCloud.h>
+#include <gloperate-text/Typesetter.h>
+
+#include <Benchmark.h>
+
+
+using gloperate_text::GlyphIndex;
+
+
+namespace
+{
+
+
+struct KerningPair
+{
+    GlyphIndex index;
+    GlyphIndex subsequentIndex;
+    float      kerning;
+};
+
+
+// Deterministic kerning pairs, mostly within the Latin range like in common fonts
+std::vector<KerningPair> kerningPairs(size_t count)
+{
+    std::minstd_rand random(count);
+    std::uniform_int_distribution<GlyphIndex> latin(32, 0x24f);
+    std::uniform_int_distribution<GlyphIndex> other(0x400, 0x4ff);
+    std::uniform_real_distribution<float>     kerning(-0.2f, 0.0f);
+
+    std::vector<KerningPair> pairs(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto index = i % 8 ? latin(random) : other(random);
+        pairs[i] = { index, latin(random), kerning(random) };
+    }
+
+    return pairs;
+}
+
+// Former FontFace::setKerning(): insertion into the sorted table for each pair
+void insertSorted(std::vector<KerningPair> & table, const KerningPair & pair)
+{
+    const auto position = std::lower_bound(table.begin(), table.end(), pair, [] (const KerningPair & a, const KerningPair & b)
+    {
+        return std::tie(a.index, a.subsequentIndex) < std::tie(b.index, b.subsequentIndex);
+    });
+
+    if (position != table.end() && position->index == pair.index && position->subsequentIndex == pair.subsequentIndex)
+    {
+        position->kerning = pair.kerning;
+    }
+    else
+    {
+        table.insert(position, pair);
+    }
+}
+
+// Font with glyphs for the Latin and Cyrillic ranges, kerning can only be set for existing glyphs
+std::unique_ptr<gloperate_text::FontFace> createFont()
+{
+    auto font = std::unique_ptr<gloperate_text::FontFace>(new gloperate_text::FontFace);
+
+    font->setAscent(0.8f);
+    font->setDescent(-0.2f);
+    font->setLinegap(0.1f);
+
+    for (GlyphIndex index = 32; index < 0x500; ++index)
+    {
+        if (index == 0x250)
+        {
+            index = 0x400;
+        }
+
+        gloperate_text::Glyph glyph;
+        glyph.setIndex(index);
+        glyph.setAdvance(0.5f);
+        glyph.setBearing(glm::vec2(0.05f, 0.7f));
+        glyph.setExtent(glm::vec2(0.4f, 0.7f));
+        glyph.setSubTextureOrigin(glm::vec2(0.0f));
+        glyph.setSubTextureExtent(index != ' ' ? glm::vec2(0.01f) : glm::vec2(0.0f));
+
+        font->addGlyph(glyph);
+    }
+
+    return font;
+}
+
+// Kerning pair for each pair of letters
+void addLetterKerning(gloperate_text::FontFace & font)
+{
+    const auto letters = std::u32string(U"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+
+    for (const auto first : letters)
+    {
+        for (const auto second : letters)
+        {
+            font.setKerning(first, second, -0.01f * ((first + second) % 5));
+        }
+    }
+}
+
+// Deterministic labels of random words
+std::vector<std::u32string> labels(size_t count)
+{
+    std::minstd_rand random(1);
+    std::uniform_int_distribution<int> numWords(1, 12);
+    std::uniform_int_distribution<int> wordLength(1, 10);
+    std::uniform_int_distribution<int> letter(0, 25);
+    std::uniform_int_distribution<int> capital(0, 4);
+
+    std::vector<std::u32string> result(count);
+
+    for (auto & label : result)
+    {
+        for (auto word = numWords(random); word > 0; --word)
+        {
+            for (auto length = wordLength(random); length > 0; --length)
+            {
+                label += static_cast<char32_t>((capital(random) ? U'a' : U'A') + letter(random));
+            }
+
+            label += U' ';
+        }
+    }
+
+    return result;
+}
+
+
+} // namespace
+
+
+class KerningBenchmark : public testing::TestWithParam<size_t>
+{
+};
+
+
+TEST_P(KerningBenchmark, LoadKerningPairs)
+{
+    const auto pairs = kerningPairs(GetParam());
+    const auto name  = std::to_string(pairs.size()) + " pairs";
+
+    std::vector<KerningPair> table;
+
+    report("sorted insertion      [" + name + "]", measure(3, [&] ()
+    {
+        table.clear();
+
+        for (const auto & pair : pairs)
+        {
+            insertSorted(table, pair);
+        }
+    }));
+
+    // Create the glyphs of each run in advance, only the kerning is measured
+    std::vector<std::unique_ptr<gloperate_text::FontFace>> fonts;
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        fonts.push_back(createFont());
+    }
+
+    auto run = size_t(0);
+
+    report("append and sort once  [" + name + "]", measure(3, [&] ()
+    {
+        const auto & font = fonts[run++];
+
+        for (const auto & pair : pairs)
+        {
+            font->setKerning(pair.index, pair.subsequentIndex, pair.kerning);
+        }
+
+        // The first lookup sorts the pairs
+        font->kerning(pairs.front().index, pairs.front().subsequentIndex);
+    }));
+
+    const auto & font = fonts.back();
+
+    // Both tables must agree, if a pair was set more than once the last value wins
+    for (const auto & pair : table)
+    {
+        EXPECT_EQ(pair.kerning, font->kerning(pair.index, pair.subsequentIndex));
+    }
+
+    EXPECT_EQ(0.0f, font->kerning(0x24f, 0x400));
+}
+
+INSTANTIATE_TEST_CASE_P(Pairs, KerningBenchmark, testing::Values(1000u, 10000u, 30000u));
+
+
+TEST(TypesetterBenchmark, TypesetLabels)
+{
+    const auto font   = createFont();
+    const auto corpus = labels(10000);
+
+    addLetterKerning(*font);
+
+    std::vector<gloperate_text::GlyphSequence> sequences(corpus.size());
+    size_t numGlyphs = 0;
+
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        sequences[i].setString(corpus[i]);
+        sequences[i].setWordWrap(true);
+        sequences[i].setLineWidth(20.0f, 1.0f, *font);
+
+        numGlyphs += sequences[i].size(*font);
+    }
+
+    gloperate_text::GlyphVertexCloud::Vertices vertices(numGlyphs);
+
+    report("typeset " + std::to_string(corpus.size()) + " labels", measure(10, [&] ()
+    {
+        auto vertex = vertices.begin();
+
+        for (const auto & sequence : sequences)
+        {
+            gloperate_text::Typesetter::typeset(sequence, *font, vertex);
+            vertex += sequence.size(*font);
+        }
+    }));
+
+    report("extent of " + std::to_string(corpus.size()) + " labels", measure(10, [&] ()
+    {
+        for (const auto & sequence : sequences)
+        {
+            gloperate_text::Typesetter::extent(sequence, *font, 1.0f);
+        }
+    }));
+
+    EXPECT_GT(numGlyphs, corpus.size());
+}
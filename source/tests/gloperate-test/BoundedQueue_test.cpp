@@ -0,0 +1,134 @@
+
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+#include <gloperate/base/BoundedQueue.h>
+
+
+class BoundedQueue_test : public testing::Test
+{
+};
+
+
+TEST_F(BoundedQueue_test, CapacityIsRoundedUpToPowerOfTwo)
+{
+    EXPECT_EQ(2u,  gloperate::BoundedQueue<int>(0).capacity());
+    EXPECT_EQ(8u,  gloperate::BoundedQueue<int>(8).capacity());
+    EXPECT_EQ(16u, gloperate::BoundedQueue<int>(9).capacity());
+}
+
+TEST_F(BoundedQueue_test, PopFromEmptyQueue)
+{
+    gloperate::BoundedQueue<int> queue(4);
+
+    auto value = 42;
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_EQ(42, value);
+}
+
+TEST_F(BoundedQueue_test, PushAndPopInOrder)
+{
+    gloperate::BoundedQueue<int> queue(4);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+
+    auto value = 0;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(3, value);
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST_F(BoundedQueue_test, PushToFullQueue)
+{
+    gloperate::BoundedQueue<int> queue(4);
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.push(i));
+    }
+
+    EXPECT_FALSE(queue.push(4));
+
+    // Popping a value makes room for the next one
+    auto value = 0;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.push(4));
+
+    for (auto i = 1; i <= 4; ++i)
+    {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(i, value);
+    }
+
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST_F(BoundedQueue_test, WrapAround)
+{
+    gloperate::BoundedQueue<int> queue(2);
+
+    auto value = 0;
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(queue.push(i));
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(i, value);
+    }
+}
+
+TEST_F(BoundedQueue_test, MultipleProducers)
+{
+    const auto numProducers = 4;
+    const auto numValues    = 10000;
+
+    gloperate::BoundedQueue<int> queue(64);
+    std::vector<std::thread> producers;
+
+    for (auto p = 0; p < numProducers; ++p)
+    {
+        producers.emplace_back([&queue, p] ()
+        {
+            for (auto i = 0; i < numValues; ++i)
+            {
+                while (!queue.push(p * numValues + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each value must arrive exactly once, values of one producer in order
+    std::vector<int> next(numProducers, 0);
+    auto received = 0;
+
+    while (received < numProducers * numValues)
+    {
+        auto value = 0;
+        if (!queue.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto producer = value / numValues;
+        EXPECT_EQ(next[producer], value % numValues);
+        next[producer] = value % numValues + 1;
+        ++received;
+    }
+
+    for (auto & producer : producers)
+    {
+        producer.join();
+    }
+}
@@ -0,0 +1,248 @@
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/enum.h>
+
+#include <gloperate/pipeline/Pipeline.h>
+#include <gloperate/pipeline/Stage.h>
+#include <gloperate/pipeline/Input.h>
+#include <gloperate/rendering/RenderTargetPool.h>
+
+
+namespace
+{
+
+
+class TargetStage : public gloperate::Stage
+{
+public:
+    gloperate::Input<globjects::Texture *> target;
+
+
+public:
+    TargetStage(const std::string & name)
+    : Stage(nullptr, "TargetStage", name)
+    , target("target", this)
+    {
+    }
+};
+
+
+// Pool that does not allocate OpenGL objects, render targets are referenced by their address
+class TestRenderTargetPool : public gloperate::RenderTargetPool
+{
+public:
+    globjects::Texture * obtain(gloperate::Stage * owner)
+    {
+        const auto description = Description{ false, gl::GL_RGBA8, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE, glm::ivec2(64, 64) };
+
+        return reinterpret_cast<globjects::Texture *>(RenderTargetPool::obtain(owner, description));
+    }
+
+    bool shares(const gloperate::Stage * owner, const gloperate::Stage * other) const
+    {
+        return m_ownerTargets.at(owner) == m_ownerTargets.at(other);
+    }
+
+    bool isExclusive(const gloperate::Stage * owner) const
+    {
+        return m_exclusive.count(owner) > 0;
+    }
+
+    Lifetime lifetime(const gloperate::Stage * owner) const
+    {
+        return m_lifetimes.at(owner);
+    }
+
+    std::vector<const gloperate::Stage *> users(const gloperate::Stage * owner) const
+    {
+        return m_users.at(owner);
+    }
+
+
+protected:
+    virtual void allocate(RenderTarget & renderTarget) override
+    {
+        renderTarget.memory = 64 * 64 * 4;
+    }
+
+    virtual const void * object(const RenderTarget & renderTarget) const override
+    {
+        return &renderTarget;
+    }
+};
+
+
+} // namespace
+
+
+class RenderTargetPool_test : public testing::Test
+{
+public:
+    RenderTargetPool_test()
+    : m_pipeline(nullptr, "Pipeline", "pipeline")
+    {
+        // Content of each owner is rendered and read by the two stages following it
+        m_ownerA  = addStage("ownerA");
+        m_renderA = addStage("renderA");
+        m_readA   = addStage("readA");
+        m_ownerB  = addStage("ownerB");
+        m_renderB = addStage("renderB");
+        m_readB   = addStage("readB");
+    }
+
+    TargetStage * addStage(const std::string & name)
+    {
+        auto stage = new TargetStage(name);
+        m_pipeline.addStage(std::unique_ptr<gloperate::Stage>(stage));
+
+        return stage;
+    }
+
+    // Obtain render targets and let the stages use them
+    void obtain()
+    {
+        const auto targetA = m_pool.obtain(m_ownerA);
+        const auto targetB = m_pool.obtain(m_ownerB);
+
+        m_renderA->target.setValue(targetA);
+        m_readA->target.setValue(targetA);
+        m_renderB->target.setValue(targetB);
+        m_readB->target.setValue(targetB);
+    }
+
+    // Execute until the lifetimes are known and unchanged
+    void share()
+    {
+        obtain();
+        m_pool.updateLifetimes(&m_pipeline);
+
+        obtain();
+        m_pool.updateLifetimes(&m_pipeline);
+    }
+
+
+protected:
+    gloperate::Pipeline  m_pipeline;
+    TestRenderTargetPool m_pool;
+    TargetStage        * m_ownerA;
+    TargetStage        * m_renderA;
+    TargetStage        * m_readA;
+    TargetStage        * m_ownerB;
+    TargetStage        * m_renderB;
+    TargetStage        * m_readB;
+};
+
+
+TEST_F(RenderTargetPool_test, UnknownLifetimesDoNotShare)
+{
+    obtain();
+
+    EXPECT_FALSE(m_pool.shares(m_ownerA, m_ownerB));
+    EXPECT_EQ(2u, m_pool.numRenderTargets());
+}
+
+TEST_F(RenderTargetPool_test, UsesAreAttributedToPreviousOwner)
+{
+    share();
+
+    EXPECT_EQ(1u, m_pool.lifetime(m_ownerA).first);
+    EXPECT_EQ(2u, m_pool.lifetime(m_ownerA).last);
+    EXPECT_EQ(4u, m_pool.lifetime(m_ownerB).first);
+    EXPECT_EQ(5u, m_pool.lifetime(m_ownerB).last);
+
+    EXPECT_THAT(m_pool.users(m_ownerA), testing::ElementsAre(m_renderA, m_readA));
+    EXPECT_THAT(m_pool.users(m_ownerB), testing::ElementsAre(m_renderB, m_readB));
+}
+
+TEST_F(RenderTargetPool_test, RenderTargetIsReusedAfterLifetimeHasEnded)
+{
+    share();
+
+    EXPECT_TRUE(m_pool.shares(m_ownerA, m_ownerB));
+    EXPECT_EQ(1u, m_pool.numRenderTargets());
+    EXPECT_EQ(2 * m_pool.pooledMemory(), m_pool.requestedMemory());
+}
+
+TEST_F(RenderTargetPool_test, OverlappingLifetimesDoNotShare)
+{
+    // Content of A is read after B has been rendered
+    auto late = addStage("late");
+
+    obtain();
+    late->target.setValue(m_readA->target.value());
+    m_pool.updateLifetimes(&m_pipeline);
+
+    obtain();
+    late->target.setValue(m_readA->target.value());
+    m_pool.updateLifetimes(&m_pipeline);
+
+    EXPECT_EQ(6u, m_pool.lifetime(m_ownerA).last);
+    EXPECT_FALSE(m_pool.shares(m_ownerA, m_ownerB));
+}
+
+TEST_F(RenderTargetPool_test, SharingIsKeptIfContentIsRenderedEveryExecution)
+{
+    share();
+
+    for (auto stage : { m_renderA, m_readA, m_renderB, m_readB })
+    {
+        stage->setAlwaysProcessed(true);
+    }
+
+    for (auto execution = 0; execution < 3; ++execution)
+    {
+        m_pool.updateLifetimes(&m_pipeline);
+
+        for (auto stage : { m_renderA, m_readA, m_renderB, m_readB })
+        {
+            m_pool.prepareStage(stage);
+        }
+    }
+
+    EXPECT_FALSE(m_pool.isExclusive(m_ownerA));
+    EXPECT_FALSE(m_pool.isExclusive(m_ownerB));
+    EXPECT_TRUE(m_pool.shares(m_ownerA, m_ownerB));
+}
+
+TEST_F(RenderTargetPool_test, OverwrittenContentIsNotReadBeforeExecution)
+{
+    share();
+
+    // Content of A has been overwritten by B and would be read without being rendered
+    m_readA->setAlwaysProcessed(true);
+    m_pool.updateLifetimes(&m_pipeline);
+
+    EXPECT_TRUE(m_pool.isExclusive(m_ownerA));
+    EXPECT_FALSE(m_pool.isExclusive(m_ownerB));
+
+    obtain();
+
+    EXPECT_FALSE(m_pool.shares(m_ownerA, m_ownerB));
+}
+
+TEST_F(RenderTargetPool_test, SkippedRenderingStopsSharing)
+{
+    share();
+
+    // Content of B is still present
+    m_pool.prepareStage(m_readB);
+    EXPECT_FALSE(m_pool.isExclusive(m_ownerB));
+
+    // Content of A is rendered again before it is read
+    m_pool.prepareStage(m_renderA);
+    m_pool.prepareStage(m_readA);
+    EXPECT_FALSE(m_pool.isExclusive(m_ownerA));
+
+    // Content of B has been overwritten by A, and dirty-only processing has skipped rendering it
+    m_pool.prepareStage(m_readB);
+    EXPECT_TRUE(m_pool.isExclusive(m_ownerB));
+
+    obtain();
+
+    EXPECT_FALSE(m_pool.shares(m_ownerA, m_ownerB));
+}